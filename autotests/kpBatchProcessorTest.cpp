@@ -0,0 +1,99 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "kpBatchProcessor.h"
+
+
+class kpBatchProcessorTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void smoke ();
+};
+
+//---------------------------------------------------------------------
+
+// Runs "kolourpaint <args>" in batch mode, in-process.
+static int RunBatch (const QStringList &args)
+{
+    QCommandLineParser parser;
+    kpBatchProcessor::addCommandLineOptions (&parser);
+    if (!parser.parse (QStringList (QStringLiteral ("kolourpaint")) + args)) {
+        return -1;
+    }
+
+    return kpBatchProcessor::run (parser);
+}
+
+//---------------------------------------------------------------------
+
+void kpBatchProcessorTest::smoke ()
+{
+    QTemporaryDir outputDir;
+    QVERIFY (outputDir.isValid ());
+
+    // Every fixture through a pipeline that exercises decoding, an effect,
+    // the lossless transforms and saving.  The pattern is expanded by
+    // batch mode itself.
+    QCOMPARE (::RunBatch (QStringList ()
+                  << QStringLiteral ("--batch") << QStringLiteral ("rotate:90,flip:h,invert")
+                  << QStringLiteral ("--output") << outputDir.path ()
+                  << QStringLiteral (KP_TESTS_DIR "/*.png")),
+              0);
+
+    const QDir inputDir (QStringLiteral (KP_TESTS_DIR));
+    const QStringList inputNames = inputDir.entryList (
+        QStringList (QStringLiteral ("*.png")), QDir::Files);
+    QVERIFY (!inputNames.isEmpty ());
+
+    for (const QString &inputName : inputNames)
+    {
+        const QImage input (inputDir.filePath (inputName));
+        QVERIFY2 (!input.isNull (), qPrintable (inputName));
+
+        // A rotation and a flip make a transpose.
+        const QImage output (QDir (outputDir.path ()).filePath (inputName));
+        QVERIFY2 (!output.isNull (), qPrintable (inputName));
+        QCOMPARE (output.size (), input.size ().transposed ());
+    }
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpBatchProcessorTest)
+
+#include "kpBatchProcessorTest.moc"
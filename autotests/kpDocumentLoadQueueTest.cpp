@@ -0,0 +1,236 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <QImage>
+#include <QList>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUrl>
+
+#include "document/kpDocumentLoader.h"
+#include "document/kpDocumentLoadQueue.h"
+
+
+class kpDocumentLoadQueueTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void maxLoading ();
+    void memoryBudget ();
+    void overBudgetStillLoads ();
+    void releasedBeforeFinished ();
+    void deleted ();
+};
+
+//---------------------------------------------------------------------
+
+// The size of the test images.  kpDocumentLoadQueue estimates that each
+// takes Side * Side * 4 * 2 bytes to load.
+static const int Side = 100;
+
+// Saves <count> images into <dir> and returns loaders for them, owned by
+// <parent>.
+static QList <kpDocumentLoader *> CreateLoaders (const QTemporaryDir &dir, int count,
+        QObject *parent)
+{
+    QImage image (Side, Side, QImage::Format_ARGB32_Premultiplied);
+    image.fill (Qt::red);
+
+    QList <kpDocumentLoader *> loaders;
+    for (int i = 0; i < count; i++)
+    {
+        const QString path = dir.filePath (QString::number (i) + QLatin1String (".png"));
+        if (!image.save (path)) {
+            return {};
+        }
+
+        loaders.append (new kpDocumentLoader (QUrl::fromLocalFile (path), parent));
+    }
+
+    return loaders;
+}
+
+//---------------------------------------------------------------------
+
+// Enqueues <loaders> onto <queue> and waits for them all to finish,
+// checking that no more than <maxLoading> ever load at once.
+static void LoadAll (kpDocumentLoadQueue *queue, const QList <kpDocumentLoader *> &loaders,
+        int maxLoading)
+{
+    int numFinished = 0;
+    int mostLoading = 0;
+    for (kpDocumentLoader *loader : loaders)
+    {
+        QObject::connect (loader, &kpDocumentLoader::finished, queue,
+            [&] {
+                numFinished++;
+                mostLoading = qMax (mostLoading, queue->loadingCount ());
+            });
+
+        queue->enqueue (loader);
+        mostLoading = qMax (mostLoading, queue->loadingCount ());
+    }
+
+    QCOMPARE (queue->loadingCount (), qMin (maxLoading, loaders.count ()));
+    QCOMPARE (queue->queuedCount (), loaders.count () - queue->loadingCount ());
+
+    QTRY_COMPARE (numFinished, loaders.count ());
+
+    QCOMPARE (mostLoading, qMin (maxLoading, loaders.count ()));
+    QCOMPARE (queue->loadingCount (), 0);
+    QCOMPARE (queue->queuedCount (), 0);
+
+    for (kpDocumentLoader *loader : loaders) {
+        QCOMPARE (loader->status (), kpDocumentLoader::Loaded);
+    }
+}
+
+//---------------------------------------------------------------------
+
+void kpDocumentLoadQueueTest::maxLoading ()
+{
+    QTemporaryDir dir;
+    QVERIFY (dir.isValid ());
+
+    QObject owner;
+    const QList <kpDocumentLoader *> loaders = ::CreateLoaders (dir, 7, &owner);
+    QCOMPARE (loaders.count (), 7);
+
+    kpDocumentLoadQueue queue;
+    queue.setMaxLoading (3);
+    ::LoadAll (&queue, loaders, 3);
+}
+
+void kpDocumentLoadQueueTest::memoryBudget ()
+{
+    QTemporaryDir dir;
+    QVERIFY (dir.isValid ());
+
+    QObject owner;
+    const QList <kpDocumentLoader *> loaders = ::CreateLoaders (dir, 7, &owner);
+    QCOMPARE (loaders.count (), 7);
+
+    // Room for 2 images, though 3 cores.
+    kpDocumentLoadQueue queue;
+    queue.setMaxLoading (3);
+    queue.setMemoryBudget (qint64 (Side) * Side * 4 * 2 * 2);
+    ::LoadAll (&queue, loaders, 2);
+}
+
+void kpDocumentLoadQueueTest::overBudgetStillLoads ()
+{
+    QTemporaryDir dir;
+    QVERIFY (dir.isValid ());
+
+    QObject owner;
+    const QList <kpDocumentLoader *> loaders = ::CreateLoaders (dir, 3, &owner);
+    QCOMPARE (loaders.count (), 3);
+
+    // No image fits, so they load one at a time.
+    kpDocumentLoadQueue queue;
+    queue.setMaxLoading (3);
+    queue.setMemoryBudget (1);
+    ::LoadAll (&queue, loaders, 1);
+}
+
+//---------------------------------------------------------------------
+
+void kpDocumentLoadQueueTest::releasedBeforeFinished ()
+{
+    QTemporaryDir dir;
+    QVERIFY (dir.isValid ());
+
+    QObject owner;
+    const QList <kpDocumentLoader *> loaders = ::CreateLoaders (dir, 2, &owner);
+    QCOMPARE (loaders.count (), 2);
+
+    kpDocumentLoadQueue queue;
+    queue.setMaxLoading (1);
+
+    // By the time that the first loader's finished() is handled (e.g. by
+    // showing a modal error dialog), the second must be loading.
+    int loadingWhenFinished = -1, queuedWhenFinished = -1;
+    connect (loaders [0], &kpDocumentLoader::finished, this,
+        [&] {
+            loadingWhenFinished = queue.loadingCount ();
+            queuedWhenFinished = queue.queuedCount ();
+        });
+
+    queue.enqueue (loaders [0]);
+    queue.enqueue (loaders [1]);
+    QCOMPARE (queue.queuedCount (), 1);
+
+    QTRY_COMPARE (loadingWhenFinished, 1);
+    QCOMPARE (queuedWhenFinished, 0);
+
+    QTRY_COMPARE (queue.loadingCount (), 0);
+}
+
+//---------------------------------------------------------------------
+
+void kpDocumentLoadQueueTest::deleted ()
+{
+    QTemporaryDir dir;
+    QVERIFY (dir.isValid ());
+
+    QObject owner;
+    const QList <kpDocumentLoader *> loaders = ::CreateLoaders (dir, 3, &owner);
+    QCOMPARE (loaders.count (), 3);
+
+    kpDocumentLoadQueue queue;
+    queue.setMaxLoading (1);
+
+    bool lastFinished = false;
+    connect (loaders [2], &kpDocumentLoader::finished, this,
+        [&] { lastFinished = true; });
+
+    for (kpDocumentLoader *loader : loaders) {
+        queue.enqueue (loader);
+    }
+    QCOMPARE (queue.loadingCount (), 1);
+    QCOMPARE (queue.queuedCount (), 2);
+
+    // While loading and while queued.  The first keeps its place until its
+    // decoding thread has given up, after which the last one loads.
+    delete loaders [0];
+    delete loaders [1];
+    QCOMPARE (queue.queuedCount (), 1);
+
+    QTRY_VERIFY (lastFinished);
+    QCOMPARE (loaders [2]->status (), kpDocumentLoader::Loaded);
+    QTRY_COMPARE (queue.loadingCount (), 0);
+    QCOMPARE (queue.queuedCount (), 0);
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpDocumentLoadQueueTest)
+
+#include "kpDocumentLoadQueueTest.moc"
@@ -0,0 +1,194 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <QImage>
+#include <QTest>
+
+#include "imagelib/kpImageScaler.h"
+
+
+class kpImageScalerTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void identity_data ();
+    void identity ();
+
+    void downscale2x ();
+    void upscale2xBox ();
+    void upscale2xBilinear ();
+
+    void extremeDownscale_data ();
+    void extremeDownscale ();
+};
+
+//---------------------------------------------------------------------
+
+// Returns an opaque gray image of <width> x <height> with the given
+// levels, row by row.
+static kpImage GrayImage (int width, int height, const QVector <int> &levels)
+{
+    Q_ASSERT (levels.count () == width * height);
+
+    kpImage image (width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const int level = levels [y * width + x];
+            image.setPixel (x, y, qRgb (level, level, level));
+        }
+    }
+    return image;
+}
+
+static void AddFilterRows ()
+{
+    QTest::addColumn <int> ("filter");
+
+    QTest::newRow ("Box") << int (kpImageScaler::Box);
+    QTest::newRow ("Bilinear") << int (kpImageScaler::Bilinear);
+    QTest::newRow ("Bicubic") << int (kpImageScaler::Bicubic);
+    QTest::newRow ("Lanczos3") << int (kpImageScaler::Lanczos3);
+}
+
+//---------------------------------------------------------------------
+
+void kpImageScalerTest::identity_data ()
+{
+    ::AddFilterRows ();
+}
+
+void kpImageScalerTest::identity ()
+{
+    QFETCH (int, filter);
+
+    kpImage image (7, 5, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height (); y++)
+    {
+        for (int x = 0; x < image.width (); x++)
+        {
+            const int alpha = 32 + (x * 31 + y * 17) % 224;
+            image.setPixel (x, y, qPremultiply (qRgba (x * 36, y * 50, 255 - x * y, alpha)));
+        }
+    }
+
+    QCOMPARE (kpImageScaler::scale (image, 7, 5, kpImageScaler::Filter (filter)),
+              image);
+}
+
+//---------------------------------------------------------------------
+
+void kpImageScalerTest::downscale2x ()
+{
+    // Each 2x2 block averages to a whole number.
+    const kpImage image = ::GrayImage (4, 4, QVector <int> ()
+        << 10 << 30   << 0 << 254
+        << 50 << 70   << 250 << 4
+        << 100 << 100 << 7 << 9
+        << 100 << 100 << 11 << 13);
+
+    const kpImage expected = ::GrayImage (2, 2, QVector <int> ()
+        << 40 << 127
+        << 100 << 10);
+
+    QCOMPARE (kpImageScaler::scale (image, 2, 2, kpImageScaler::Box), expected);
+}
+
+//---------------------------------------------------------------------
+
+void kpImageScalerTest::upscale2xBox ()
+{
+    const kpImage image = ::GrayImage (2, 2, QVector <int> ()
+        << 0 << 60
+        << 120 << 255);
+
+    // Box duplicates pixels.
+    const kpImage expected = ::GrayImage (4, 4, QVector <int> ()
+        << 0 << 0 << 60 << 60
+        << 0 << 0 << 60 << 60
+        << 120 << 120 << 255 << 255
+        << 120 << 120 << 255 << 255);
+
+    QCOMPARE (kpImageScaler::scale (image, 4, 4, kpImageScaler::Box), expected);
+}
+
+void kpImageScalerTest::upscale2xBilinear ()
+{
+    const kpImage image = ::GrayImage (2, 1, QVector <int> () << 0 << 200);
+
+    // The destination pixel centres fall 1/4 and 3/4 of the way between
+    // the source pixel centres, and the edges repeat the edge pixels.
+    const kpImage expected = ::GrayImage (4, 1, QVector <int> ()
+        << 0 << 50 << 150 << 200);
+
+    QCOMPARE (kpImageScaler::scale (image, 4, 1, kpImageScaler::Bilinear), expected);
+}
+
+//---------------------------------------------------------------------
+
+void kpImageScalerTest::extremeDownscale_data ()
+{
+    ::AddFilterRows ();
+}
+
+void kpImageScalerTest::extremeDownscale ()
+{
+    QFETCH (int, filter);
+
+    // So many source pixels under each destination pixel that, in one
+    // pass, each weight would be less than one fixed point step.
+    const int width = 32768;
+
+    kpImage uniform (width, 1, QImage::Format_ARGB32_Premultiplied);
+    uniform.fill (qRgb (123, 45, 67));
+
+    const kpImage uniformScaled = kpImageScaler::scale (uniform, 2, 1,
+        kpImageScaler::Filter (filter));
+    QCOMPARE (uniformScaled.size (), QSize (2, 1));
+    QCOMPARE (uniformScaled.pixel (0, 0), qRgb (123, 45, 67));
+    QCOMPARE (uniformScaled.pixel (1, 0), qRgb (123, 45, 67));
+
+    kpImage stripes (width, 1, QImage::Format_ARGB32_Premultiplied);
+    for (int x = 0; x < width; x++) {
+        stripes.setPixel (x, 0, (x % 2) ? qRgb (200, 200, 200) : qRgb (0, 0, 0));
+    }
+
+    const QRgb average = kpImageScaler::scale (stripes, 1, 1,
+        kpImageScaler::Filter (filter)).pixel (0, 0);
+    QVERIFY2 (qAbs (qRed (average) - 100) <= 1, qPrintable (QString::number (qRed (average))));
+    QCOMPARE (qAlpha (average), 255);
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpImageScalerTest)
+
+#include "kpImageScalerTest.moc"
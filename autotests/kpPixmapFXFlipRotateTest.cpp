@@ -0,0 +1,314 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QTest>
+
+#include "imagelib/kpColor.h"
+#include "pixmapfx/kpPixmapFX.h"
+
+
+class kpPixmapFXFlipRotateTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void rotate_data ();
+    void rotate ();
+
+    void rotateFourTimes_data ();
+    void rotateFourTimes ();
+
+    void rotateClockwiseThenAnticlockwise_data ();
+    void rotateClockwiseThenAnticlockwise ();
+
+    void flip_data ();
+    void flip ();
+
+    void flipTwice_data ();
+    void flipTwice ();
+
+    void benchmarkLarge ();
+};
+
+//---------------------------------------------------------------------
+
+// An opaque image in which every pixel is different.
+static QImage TestImage (int width, int height)
+{
+    QImage image (width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; y++)
+    {
+        auto *row = reinterpret_cast <QRgb *> (image.scanLine (y));
+        for (int x = 0; x < width; x++) {
+            row [x] = 0xFF000000 | ((quint32 (y * width + x) * 2654435761U) & 0x00FFFFFF);
+        }
+    }
+    return image;
+}
+
+static inline QRgb Pixel (const QImage &image, int x, int y)
+{
+    return reinterpret_cast <const QRgb *> (image.constScanLine (y)) [x];
+}
+
+// The obvious, pixel at a time, rotation by 90 degrees.
+static QImage NaiveRotate (const QImage &src, bool clockwise)
+{
+    QImage dest (src.height (), src.width (), src.format ());
+    for (int y = 0; y < src.height (); y++)
+    {
+        for (int x = 0; x < src.width (); x++)
+        {
+            const QPoint destPoint = clockwise ?
+                QPoint (src.height () - 1 - y, x) :
+                QPoint (y, src.width () - 1 - x);
+            reinterpret_cast <QRgb *> (dest.scanLine (destPoint.y ())) [destPoint.x ()] =
+                ::Pixel (src, x, y);
+        }
+    }
+    return dest;
+}
+
+// Odd sizes, sizes either side of multiples of the 32 pixel tiles, and
+// sizes big enough to be split across threads.
+static void AddSizes ()
+{
+    QTest::addColumn <int> ("width");
+    QTest::addColumn <int> ("height");
+
+    QTest::newRow ("1x1") << 1 << 1;
+    QTest::newRow ("1x7") << 1 << 7;
+    QTest::newRow ("7x1") << 7 << 1;
+    QTest::newRow ("2x3") << 2 << 3;
+    QTest::newRow ("31x31") << 31 << 31;
+    QTest::newRow ("32x32") << 32 << 32;
+    QTest::newRow ("33x33") << 33 << 33;
+    QTest::newRow ("64x32") << 64 << 32;
+    QTest::newRow ("33x65") << 33 << 65;
+    QTest::newRow ("65x33") << 65 << 33;
+    QTest::newRow ("100x37") << 100 << 37;
+    QTest::newRow ("301x301") << 301 << 301;
+    QTest::newRow ("513x1031") << 513 << 1031;
+    QTest::newRow ("1031x513") << 1031 << 513;
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXFlipRotateTest::rotate_data ()
+{
+    ::AddSizes ();
+}
+
+void kpPixmapFXFlipRotateTest::rotate ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+
+    const QImage original = ::TestImage (width, height);
+
+    for (const bool clockwise : {true, false})
+    {
+        const QImage expected = ::NaiveRotate (original, clockwise);
+
+        // Into a new image, as <original> is shared.
+        QImage image = original;
+        kpPixmapFX::rotateQuarterTurns (&image, clockwise ? 1 : -1);
+        QCOMPARE (image, expected);
+
+        // In place, where possible.
+        image = ::TestImage (width, height);
+        kpPixmapFX::rotateQuarterTurns (&image, clockwise ? 1 : 3);
+        QCOMPARE (image, expected);
+
+        QCOMPARE (kpPixmapFX::rotate (original, clockwise ? 90 : 270, kpColor::Invalid),
+                  expected);
+    }
+
+    QImage image = ::TestImage (width, height);
+    kpPixmapFX::rotateQuarterTurns (&image, 2);
+    QCOMPARE (image, original.mirrored (true, true));
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXFlipRotateTest::rotateFourTimes_data ()
+{
+    ::AddSizes ();
+}
+
+void kpPixmapFXFlipRotateTest::rotateFourTimes ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+
+    const QImage original = ::TestImage (width, height);
+
+    for (const int quarterTurns : {1, -1, 2})
+    {
+        QImage shared = original;
+        QImage detached = ::TestImage (width, height);
+        for (int i = 0; i < 4; i++)
+        {
+            kpPixmapFX::rotateQuarterTurns (&shared, quarterTurns);
+            kpPixmapFX::rotateQuarterTurns (&detached, quarterTurns);
+        }
+
+        QCOMPARE (shared, original);
+        QCOMPARE (detached, original);
+    }
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXFlipRotateTest::rotateClockwiseThenAnticlockwise_data ()
+{
+    ::AddSizes ();
+}
+
+void kpPixmapFXFlipRotateTest::rotateClockwiseThenAnticlockwise ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+
+    const QImage original = ::TestImage (width, height);
+
+    QImage image = ::TestImage (width, height);
+    kpPixmapFX::rotateQuarterTurns (&image, 1);
+    kpPixmapFX::rotateQuarterTurns (&image, -1);
+    QCOMPARE (image, original);
+
+    image = ::TestImage (width, height);
+    kpPixmapFX::rotateQuarterTurns (&image, -1);
+    kpPixmapFX::rotateQuarterTurns (&image, 1);
+    QCOMPARE (image, original);
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXFlipRotateTest::flip_data ()
+{
+    ::AddSizes ();
+}
+
+void kpPixmapFXFlipRotateTest::flip ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+
+    const QImage original = ::TestImage (width, height);
+
+    for (const bool horiz : {true, false})
+    {
+        for (const bool vert : {true, false})
+        {
+            const QImage expected = original.mirrored (horiz, vert);
+
+            QCOMPARE (kpPixmapFX::flip (original, horiz, vert), expected);
+
+            QImage image = ::TestImage (width, height);
+            kpPixmapFX::flip (&image, horiz, vert);
+            QCOMPARE (image, expected);
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXFlipRotateTest::flipTwice_data ()
+{
+    ::AddSizes ();
+}
+
+void kpPixmapFXFlipRotateTest::flipTwice ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+
+    const QImage original = ::TestImage (width, height);
+
+    for (const bool horiz : {true, false})
+    {
+        for (const bool vert : {true, false})
+        {
+            QImage shared = original;
+            kpPixmapFX::flip (&shared, horiz, vert);
+            kpPixmapFX::flip (&shared, horiz, vert);
+            QCOMPARE (shared, original);
+
+            QImage detached = ::TestImage (width, height);
+            kpPixmapFX::flip (&detached, horiz, vert);
+            kpPixmapFX::flip (&detached, horiz, vert);
+            QCOMPARE (detached, original);
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Times the lossless transforms of a 16384x16384 image (1GiB, plus the
+// same again for the non-square rotation).  Only run when
+// KP_TEST_LARGE_IMAGES is set, as not every machine has the memory.
+void kpPixmapFXFlipRotateTest::benchmarkLarge ()
+{
+    if (qEnvironmentVariableIsEmpty ("KP_TEST_LARGE_IMAGES")) {
+        QSKIP ("Set KP_TEST_LARGE_IMAGES to time 16384x16384 images");
+    }
+
+    const int size = 16384;
+
+    QImage square (size, size, QImage::Format_ARGB32_Premultiplied);
+    square.fill (Qt::red);
+
+    auto time = [] (const char *what, const std::function <void ()> &func) {
+        QElapsedTimer timer;
+        timer.start ();
+        func ();
+        qInfo ("%s: %lldms", what, timer.elapsed ());
+    };
+
+    time ("rotate 90 in place", [&] { kpPixmapFX::rotateQuarterTurns (&square, 1); });
+    time ("rotate 180 in place", [&] { kpPixmapFX::rotateQuarterTurns (&square, 2); });
+    time ("flip horizontally in place", [&] { kpPixmapFX::flip (&square, true, false); });
+    time ("flip vertically in place", [&] { kpPixmapFX::flip (&square, false, true); });
+    square = QImage ();
+
+    QImage wide (size, size / 2, QImage::Format_ARGB32_Premultiplied);
+    wide.fill (Qt::red);
+    time ("rotate 90 (16384x8192, copy)", [&] { kpPixmapFX::rotateQuarterTurns (&wide, 1); });
+    QCOMPARE (wide.size (), QSize (size / 2, size));
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpPixmapFXFlipRotateTest)
+
+#include "kpPixmapFXFlipRotateTest.moc"
@@ -0,0 +1,262 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QTest>
+#include <QTransform>
+
+#include "imagelib/kpColor.h"
+#include "pixmapfx/kpPixmapFX.h"
+
+
+// Compares kpPixmapFX::rotate() and skew(), which resample the image
+// themselves, against how they used to render: drawing with a transformed
+// QPainter.
+class kpPixmapFXTransformsTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void matchesQPainter_data ();
+    void matchesQPainter ();
+
+    void prettyIsSmooth ();
+};
+
+//---------------------------------------------------------------------
+
+static QImage LoadFixture (const QString &name, int zoom)
+{
+    QImage image (QStringLiteral (KP_TESTS_DIR "/") + name);
+    if (image.isNull ()) {
+        return image;
+    }
+
+    image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    // (enlarging the fixtures gives the comparison plenty of interior
+    //  pixels, not just edges)
+    if (zoom > 1)
+    {
+        image = image.scaled (image.width () * zoom, image.height () * zoom,
+                              Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    }
+
+    return image;
+}
+
+// The old kpPixmapFX TransformPixmap(): a non-smooth QPainter draw of
+// <src> through <matrix>, after QPixmap::trueMatrix(), over <background>.
+static QImage RenderWithQPainter (const QImage &src, const QTransform &matrix,
+        const kpColor &background)
+{
+    const QRect newRect = matrix.mapRect (src.rect ());
+
+    QImage dest (newRect.size (), QImage::Format_ARGB32_Premultiplied);
+
+    QPainter painter (&dest);
+    painter.setCompositionMode (QPainter::CompositionMode_Source);
+    painter.fillRect (dest.rect (), background.toQColor ());
+    painter.setWorldTransform (QPixmap::trueMatrix (matrix, src.width (), src.height ()));
+    painter.drawImage (QPoint (0, 0), src);
+    painter.end ();
+
+    return dest;
+}
+
+static inline QRgb Pixel (const QImage &image, int x, int y)
+{
+    return reinterpret_cast <const QRgb *> (image.constScanLine (y)) [x];
+}
+
+// Nearest neighbour sampling can legitimately pick the adjacent source
+// pixel when a pixel centre lands (almost) exactly on a source pixel edge,
+// as QPainter and we step in different fixed point precisions.  So every
+// pixel of <actual> must be the pixel at the same place in <expected>, or
+// one of its 8 neighbours, and only a few may not be the former.
+static bool MatchesWithinOnePixel (const QImage &actual, const QImage &expected,
+        QString *whyNot)
+{
+    if (actual.size () != expected.size ())
+    {
+        *whyNot = QStringLiteral ("size %1x%2 != %3x%4")
+            .arg (actual.width ()).arg (actual.height ())
+            .arg (expected.width ()).arg (expected.height ());
+        return false;
+    }
+
+    const int width = actual.width (), height = actual.height ();
+
+    int numShifted = 0;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const QRgb pixel = ::Pixel (actual, x, y);
+            if (pixel == ::Pixel (expected, x, y)) {
+                continue;
+            }
+
+            bool found = false;
+            for (int dy = -1; dy <= 1 && !found; dy++)
+            {
+                for (int dx = -1; dx <= 1 && !found; dx++)
+                {
+                    const int nx = x + dx, ny = y + dy;
+                    found = (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+                             ::Pixel (expected, nx, ny) == pixel);
+                }
+            }
+
+            if (!found)
+            {
+                *whyNot = QStringLiteral ("pixel (%1,%2)=%3 is nowhere near QPainter's %4")
+                    .arg (x).arg (y)
+                    .arg (pixel, 8, 16, QLatin1Char ('0'))
+                    .arg (::Pixel (expected, x, y), 8, 16, QLatin1Char ('0'));
+                return false;
+            }
+
+            numShifted++;
+        }
+    }
+
+    // About one pixel's worth of edge all the way round, plus the odd
+    // interior rounding difference.
+    const int maxShifted = 2 * (width + height) + width * height / 100;
+    if (numShifted > maxShifted)
+    {
+        *whyNot = QStringLiteral ("%1 pixels are shifted (max %2)")
+            .arg (numShifted).arg (maxShifted);
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+void kpPixmapFXTransformsTest::matchesQPainter_data ()
+{
+    QTest::addColumn <QString> ("fixture");
+    QTest::addColumn <int> ("zoom");
+    QTest::addColumn <bool> ("isSkew");
+    QTest::addColumn <double> ("angle1");
+    QTest::addColumn <double> ("angle2");
+
+    const QStringList fixtures {QStringLiteral ("transforms.png"), QStringLiteral ("rotate.png")};
+    for (const QString &fixture : fixtures)
+    {
+        for (const int zoom : {1, 8})
+        {
+            const QByteArray name = fixture.toLatin1 () + " x" + QByteArray::number (zoom);
+
+            for (const double angle : {1.0, 17.0, 30.0, 45.0, 60.0, 135.0, 200.0, -33.0})
+            {
+                QTest::newRow (QByteArray (name + " rotate " + QByteArray::number (angle)).constData ())
+                    << fixture << zoom << false << angle << 0.0;
+            }
+
+            QTest::newRow (QByteArray (name + " skew 20,0").constData ())
+                << fixture << zoom << true << 20.0 << 0.0;
+            QTest::newRow (QByteArray (name + " skew 0,-35").constData ())
+                << fixture << zoom << true << 0.0 << -35.0;
+            QTest::newRow (QByteArray (name + " skew 45,10").constData ())
+                << fixture << zoom << true << 45.0 << 10.0;
+        }
+    }
+}
+
+void kpPixmapFXTransformsTest::matchesQPainter ()
+{
+    QFETCH (QString, fixture);
+    QFETCH (int, zoom);
+    QFETCH (bool, isSkew);
+    QFETCH (double, angle1);
+    QFETCH (double, angle2);
+
+    const QImage src = ::LoadFixture (fixture, zoom);
+    QVERIFY2 (!src.isNull (), qPrintable (fixture));
+
+    const kpColor background = kpColor::Green;
+
+    const QTransform matrix = isSkew ?
+        kpPixmapFX::skewMatrix (src, angle1, angle2) :
+        kpPixmapFX::rotateMatrix (src, angle1);
+    const QImage actual = isSkew ?
+        kpPixmapFX::skew (src, angle1, angle2, background) :
+        kpPixmapFX::rotate (src, angle1, background);
+    const QImage expected = ::RenderWithQPainter (src, matrix, background);
+
+    QString whyNot;
+    QVERIFY2 (::MatchesWithinOnePixel (actual, expected, &whyNot), qPrintable (whyNot));
+}
+
+//---------------------------------------------------------------------
+
+// The bilinear previews blend neighbouring pixels but, for an opaque image
+// on an opaque background, never let transparency bleed in from outside it.
+void kpPixmapFXTransformsTest::prettyIsSmooth ()
+{
+    const QImage fixture = ::LoadFixture (QStringLiteral ("transforms.png"), 8);
+    QVERIFY (!fixture.isNull ());
+
+    // (the fixture has transparent pixels)
+    QImage src (fixture.size (), QImage::Format_ARGB32_Premultiplied);
+    src.fill (Qt::white);
+    QPainter painter (&src);
+    painter.drawImage (QPoint (0, 0), fixture);
+    painter.end ();
+
+    const QImage nearest = kpPixmapFX::rotate (src, 30, kpColor::Black);
+    const QImage pretty = kpPixmapFX::rotate (src, 30, kpColor::Black,
+        -1, -1, true/*pretty*/);
+    QCOMPARE (pretty.size (), nearest.size ());
+
+    // Opaque source and background so every output pixel must be opaque.
+    int numDifferent = 0;
+    for (int y = 0; y < pretty.height (); y++)
+    {
+        for (int x = 0; x < pretty.width (); x++)
+        {
+            QCOMPARE (qAlpha (::Pixel (pretty, x, y)), 255);
+            numDifferent += (::Pixel (pretty, x, y) != ::Pixel (nearest, x, y));
+        }
+    }
+
+    // ...but it must actually have blended something.
+    QVERIFY (numDifferent > 0);
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpPixmapFXTransformsTest)
+
+#include "kpPixmapFXTransformsTest.moc"
@@ -0,0 +1,267 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <climits>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QPolygon>
+#include <QScopedPointer>
+#include <QTest>
+
+#include "imagelib/kpColor.h"
+#include "layers/selections/image/kpFreeFormImageSelection.h"
+#include "layers/selections/image/kpRectangularImageSelection.h"
+#include "layers/selections/kpSelectionFactory.h"
+
+
+class kpSelectionFactoryTest : public QObject
+{
+Q_OBJECT
+
+private slots:
+    void roundTripRectangular ();
+    void roundTripFreeForm ();
+    void roundTripNoContent ();
+
+    void streamThenSetTransparency ();
+
+    void truncated ();
+
+    void hostilePointCount ();
+    void hostileImageSize_data ();
+    void hostileImageSize ();
+};
+
+//---------------------------------------------------------------------
+
+// An image whose every pixel differs, including in alpha.
+static kpImage TestImage (int width, int height)
+{
+    kpImage image (width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const int alpha = 64 + (x * 7 + y * 13) % 192;
+            image.setPixel (x, y, qPremultiply (qRgba (x * 20, y * 30, x + y, alpha)));
+        }
+    }
+    return image;
+}
+
+// The header that kpSelectionFactory::ToRawData() writes, with no points
+// or pixels after it.
+static QByteArray RawHeader (const QRect &rect,
+        quint32 numPoints,
+        qint32 width, qint32 height,
+        qint64 byteCount)
+{
+    QByteArray data;
+    QDataStream stream (&data, QIODevice::WriteOnly);
+    stream.setVersion (QDataStream::Qt_5_0);
+
+    const kpImageSelectionTransparency transparency;
+
+    stream << quint32 (0x4B50534C) << quint32 (1)
+           << qint32 (kpRectangularImageSelection::SerialID)
+           << rect
+           << transparency.isOpaque ()
+           << transparency.transparentColor ()
+           << transparency.colorSimilarity ()
+           << numPoints
+           << width << height
+           << quint8 (0) << quint8 (QSysInfo::ByteOrder) << quint8 (0)
+           << byteCount;
+
+    return data;
+}
+
+//---------------------------------------------------------------------
+
+void kpSelectionFactoryTest::roundTripRectangular ()
+{
+    const QRect rect (3, 4, 5, 7);
+    const kpImageSelectionTransparency transparency (false/*not opaque*/,
+        kpColor::Red, 0.25);
+    const kpRectangularImageSelection sel (rect, ::TestImage (5, 7), transparency);
+
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromRawData (kpSelectionFactory::ToRawData (sel)));
+    QVERIFY (copy);
+
+    QCOMPARE (copy->serialID (), sel.serialID ());
+    QCOMPARE (copy->boundingRect (), rect);
+    QVERIFY (copy->transparency () == transparency);
+    QCOMPARE (copy->baseImage (), sel.baseImage ());
+}
+
+void kpSelectionFactoryTest::roundTripFreeForm ()
+{
+    const QPolygon points (QVector <QPoint> ()
+        << QPoint (10, 20) << QPoint (18, 22) << QPoint (12, 28));
+    const QRect rect = points.boundingRect ();
+    const kpFreeFormImageSelection sel (points,
+        ::TestImage (rect.width (), rect.height ()));
+
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromRawData (kpSelectionFactory::ToRawData (sel)));
+    QVERIFY (copy);
+
+    auto *freeFormCopy = dynamic_cast <kpFreeFormImageSelection *> (copy.data ());
+    QVERIFY (freeFormCopy);
+    QCOMPARE (freeFormCopy->originalPoints (), points);
+    QCOMPARE (copy->baseImage (), sel.baseImage ());
+}
+
+void kpSelectionFactoryTest::roundTripNoContent ()
+{
+    const kpRectangularImageSelection sel (QRect (0, 0, 9, 2));
+
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromRawData (kpSelectionFactory::ToRawData (sel)));
+    QVERIFY (copy);
+
+    QCOMPARE (copy->boundingRect (), sel.boundingRect ());
+    QVERIFY (copy->baseImage ().isNull ());
+}
+
+//---------------------------------------------------------------------
+
+void kpSelectionFactoryTest::streamThenSetTransparency ()
+{
+    kpImage image (4, 3, QImage::Format_ARGB32_Premultiplied);
+    image.fill (qRgb (0, 0, 255));
+    image.setPixel (1, 1, qRgb (255, 0, 0));
+    image.setPixel (3, 2, qRgb (255, 0, 0));
+    const kpRectangularImageSelection sel (QRect (2, 5, 4, 3), image);
+
+    // The pre-raw format, which stores the image as PNG.
+    QByteArray data;
+    {
+        QDataStream stream (&data, QIODevice::WriteOnly);
+        stream << sel;
+    }
+
+    QDataStream stream (data);
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromStream (stream));
+    QVERIFY (copy);
+
+    QCOMPARE (copy->baseImage ().format (), QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE (copy->baseImage (), image);
+
+    // Builds the transparency mask from the streamed image.
+    copy->setTransparency (kpImageSelectionTransparency (false/*not opaque*/,
+        kpColor::Red, 0));
+
+    const kpImage transparentImage = copy->transparentImage ();
+    for (int y = 0; y < image.height (); y++)
+    {
+        for (int x = 0; x < image.width (); x++)
+        {
+            const bool red = (image.pixel (x, y) == qRgb (255, 0, 0));
+            QCOMPARE (qAlpha (transparentImage.pixel (x, y)), red ? 0 : 255);
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+void kpSelectionFactoryTest::truncated ()
+{
+    const QPolygon points (QVector <QPoint> ()
+        << QPoint (0, 0) << QPoint (6, 1) << QPoint (2, 4));
+    const kpFreeFormImageSelection sel (points, ::TestImage (7, 5));
+
+    const QByteArray data = kpSelectionFactory::ToRawData (sel);
+    QVERIFY (data.size () > 7 * 5 * 4);
+
+    for (int size = 0; size < data.size (); size++)
+    {
+        QScopedPointer <kpAbstractImageSelection> copy (
+            kpSelectionFactory::FromRawData (data.left (size)));
+        QVERIFY2 (!copy, qPrintable (QString::number (size)));
+    }
+}
+
+//---------------------------------------------------------------------
+
+void kpSelectionFactoryTest::hostilePointCount ()
+{
+    // Claims ~4 billion points but has none.  Must be rejected without
+    // trying to allocate 32GB first.
+    const QByteArray data = ::RawHeader (QRect (0, 0, 1, 1), 0xFFFFFFFF,
+        1, 1, 4) + QByteArray (4, '\0');
+
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromRawData (data));
+    QVERIFY (!copy);
+}
+
+void kpSelectionFactoryTest::hostileImageSize_data ()
+{
+    QTest::addColumn <int> ("width");
+    QTest::addColumn <int> ("height");
+    QTest::addColumn <qint64> ("byteCount");
+
+    QTest::newRow ("huge") << INT_MAX << INT_MAX << qint64 (0);
+    QTest::newRow ("huge, consistent byteCount")
+        << INT_MAX / 4 << INT_MAX << qint64 (INT_MAX / 4) * 4 * INT_MAX;
+    QTest::newRow ("row overflows int") << INT_MAX / 4 + 1 << 1 << qint64 (0);
+    QTest::newRow ("negative width") << -1 << 4 << qint64 (-16);
+    QTest::newRow ("negative height") << 4 << -1 << qint64 (-16);
+    QTest::newRow ("both negative") << -2 << -2 << qint64 (16);
+    QTest::newRow ("zero width") << 0 << 4 << qint64 (0);
+    QTest::newRow ("byteCount too small") << 2 << 2 << qint64 (15);
+    QTest::newRow ("byteCount too large") << 2 << 2 << qint64 (17);
+    QTest::newRow ("byteCount beyond data") << 2 << 2 << qint64 (16);
+}
+
+void kpSelectionFactoryTest::hostileImageSize ()
+{
+    QFETCH (int, width);
+    QFETCH (int, height);
+    QFETCH (qint64, byteCount);
+
+    // Just enough data for the well-formed cases above to be rejected
+    // only because of the byte count.
+    const QRect rect (0, 0, qMax (1, width), qMax (1, height));
+    const QByteArray data = ::RawHeader (rect, 0, width, height, byteCount) +
+        QByteArray (byteCount == 16 ? 15 : 16, '\0');
+
+    QScopedPointer <kpAbstractImageSelection> copy (
+        kpSelectionFactory::FromRawData (data));
+    QVERIFY (!copy);
+}
+
+//---------------------------------------------------------------------
+
+QTEST_MAIN (kpSelectionFactoryTest)
+
+#include "kpSelectionFactoryTest.moc"
@@ -128,7 +128,9 @@ void kpTransformFlipCommand::flip ()
     }
     else
     {
-        doc->setImage(doc->image().mirrored(m_horiz, m_vert));
+        const QSize oldSize (doc->width (), doc->height ());
+        kpPixmapFX::flip (doc->imagePointer (), m_horiz, m_vert);
+        doc->imageChangedInPlace (oldSize);
     }
 
     QApplication::restoreOverrideCursor ();
@@ -58,10 +58,12 @@
 kpTransformResizeScaleCommand::kpTransformResizeScaleCommand (bool actOnSelection,
         int newWidth, int newHeight,
         Type type,
-        kpCommandEnvironment *environ)
+        kpCommandEnvironment *environ,
+        kpImageScaler::Filter smoothScaleFilter)
     : kpCommand (environ),
       m_actOnSelection (actOnSelection),
       m_type (type),
+      m_smoothScaleFilter (smoothScaleFilter),
       m_backgroundColor (environ->backgroundColor ()),
       m_oldSelectionPtr (nullptr)
 {
@@ -319,8 +321,10 @@ void kpTransformResizeScaleCommand::execute ()
             m_oldImage = oldImage;
         }
 
-        kpImage newImage = kpPixmapFX::scale (oldImage, m_newWidth, m_newHeight,
-                                               m_type == SmoothScale);
+        kpImage newImage = (m_type == SmoothScale) ?
+            kpImageScaler::scale (oldImage, m_newWidth, m_newHeight,
+                                  m_smoothScaleFilter) :
+            kpPixmapFX::scale (oldImage, m_newWidth, m_newHeight);
 
 
         if (!m_oldSelectionPtr && document ()->selection ())
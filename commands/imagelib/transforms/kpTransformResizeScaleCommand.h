@@ -35,6 +35,7 @@
 #include "imagelib/kpColor.h"
 #include "commands/kpCommand.h"
 #include "imagelib/kpImage.h"
+#include "imagelib/kpImageScaler.h"
 
 
 class QSize;
@@ -53,10 +54,12 @@ public:
         Resize, Scale, SmoothScale
     };
 
+    // <smoothScaleFilter> is only used if <type> is SmoothScale.
     kpTransformResizeScaleCommand (bool actOnSelection,
         int newWidth, int newHeight,
         Type type,
-        kpCommandEnvironment *environ);
+        kpCommandEnvironment *environ,
+        kpImageScaler::Filter smoothScaleFilter = kpImageScaler::DefaultFilter);
     ~kpTransformResizeScaleCommand () override;
 
     QString name () const override;
@@ -86,6 +89,7 @@ protected:
     bool m_actOnSelection;
     int m_newWidth, m_newHeight;
     Type m_type;
+    kpImageScaler::Filter m_smoothScaleFilter;
     bool m_isLosslessScale;
     bool m_scaleSelectionWithImage;
     kpColor m_backgroundColor;
@@ -98,14 +98,19 @@ void kpTransformRotateCommand::execute ()
     }
 
 
-    kpImage newImage = kpPixmapFX::rotate (doc->image (m_actOnSelection),
-                                            m_angle,
-                                            m_backgroundColor);
-
     if (!m_actOnSelection) {
-        doc->setImage (newImage);
+        // Rotate the document's own pixels, rather than a copy of them, so
+        // that lossless rotations of huge images are done in place where
+        // possible.
+        const QSize oldSize (doc->width (), doc->height ());
+        kpPixmapFX::rotate (doc->imagePointer (), m_angle, m_backgroundColor);
+        doc->imageChangedInPlace (oldSize);
     }
     else {
+        kpImage newImage = kpPixmapFX::rotate (doc->image (m_actOnSelection),
+                                                m_angle,
+                                                m_backgroundColor);
+
         kpAbstractImageSelection *sel = doc->imageSelection ();
         Q_ASSERT (sel);
 
@@ -188,6 +193,17 @@ void kpTransformRotateCommand::unexecute ()
     QApplication::setOverrideCursor (Qt::WaitCursor);
 
 
+    if (m_losslessRotation && !m_actOnSelection)
+    {
+        const QSize oldSize (doc->width (), doc->height ());
+        kpPixmapFX::rotate (doc->imagePointer (), 360 - m_angle, m_backgroundColor);
+        doc->imageChangedInPlace (oldSize);
+
+        QApplication::restoreOverrideCursor ();
+        return;
+    }
+
+
     kpImage oldImage;
 
     if (!m_losslessRotation)
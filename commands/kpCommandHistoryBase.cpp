@@ -92,6 +92,7 @@ kpCommandHistoryBase::kpCommandHistoryBase (bool doReadConfig,
 
 
     m_documentRestoredPosition = 0;
+    m_documentSavingPosition = INT_MAX;
 
 
     if (doReadConfig) {
@@ -279,6 +280,16 @@ void kpCommandHistoryBase::addCommand (kpCommand *command, bool execute)
     #endif
     }
 
+    if (m_documentSavingPosition != INT_MAX)
+    {
+        if (m_documentSavingPosition > 0) {
+            m_documentSavingPosition = INT_MAX;
+        }
+        else {
+            m_documentSavingPosition--;
+        }
+    }
+
     trimCommandListsUpdateActions ();
 }
 
@@ -293,6 +304,8 @@ void kpCommandHistoryBase::clear ()
     ::ClearPointerList(m_redoCommandList);
 
     m_documentRestoredPosition = 0;
+    // (any save in progress is of a document that is no longer here)
+    m_documentSavingPosition = INT_MAX;
 
     updateActions ();
 }
@@ -329,6 +342,10 @@ void kpCommandHistoryBase::undoInternal ()
         qCDebug(kpLogCommands) << "\t\tdocumentRestoredPosition=" << m_documentRestoredPosition;
     #endif
     }
+
+    if (m_documentSavingPosition != INT_MAX) {
+        m_documentSavingPosition++;
+    }
 }
 
 //---------------------------------------------------------------------
@@ -364,6 +381,10 @@ void kpCommandHistoryBase::redoInternal ()
         qCDebug(kpLogCommands) << "\t\tdocumentRestoredPosition=" << m_documentRestoredPosition;
     #endif
     }
+
+    if (m_documentSavingPosition != INT_MAX) {
+        m_documentSavingPosition--;
+    }
 }
 
 //---------------------------------------------------------------------
@@ -577,6 +598,13 @@ void kpCommandHistoryBase::trimCommandLists ()
             m_documentRestoredPosition = INT_MAX;
         }
     }
+
+    if (m_documentSavingPosition != INT_MAX &&
+        (m_documentSavingPosition > static_cast<int> (m_redoCommandList.size ()) ||
+            -m_documentSavingPosition > static_cast<int> (m_undoCommandList.size ())))
+    {
+        m_documentSavingPosition = INT_MAX;
+    }
 }
 
 
@@ -701,6 +729,16 @@ void kpCommandHistoryBase::setNextUndoCommand (kpCommand *command)
 }
 
 
+// public slot virtual
+void kpCommandHistoryBase::documentSaving ()
+{
+#if DEBUG_KP_COMMAND_HISTORY
+    qCDebug(kpLogCommands) << "kpCommandHistoryBase::documentSaving()";
+#endif
+
+    m_documentSavingPosition = 0;
+}
+
 // public slot virtual
 void kpCommandHistoryBase::documentSaved ()
 {
@@ -708,7 +746,10 @@ void kpCommandHistoryBase::documentSaved ()
     qCDebug(kpLogCommands) << "kpCommandHistoryBase::documentSaved()";
 #endif
 
-    m_documentRestoredPosition = 0;
+    // The save finishes in the background, so there may have been
+    // undos, redos or new commands since documentSaving().
+    m_documentRestoredPosition = m_documentSavingPosition;
+    m_documentSavingPosition = INT_MAX;
 }
 
 
@@ -117,6 +117,9 @@ public:
     void setNextUndoCommand (kpCommand *command);
 
 public slots:
+    // The document has started saving its current state in the background.
+    virtual void documentSaving ();
+    // That save has finished.
     virtual void documentSaved ();
 
 signals:
@@ -140,6 +143,10 @@ protected:
     //
     // ASSUMPTION: will never have INT_MAX commands in any list.
     int m_documentRestoredPosition;
+
+    // The same, but for the state being saved by a save in progress
+    // (INT_MAX if there is none).
+    int m_documentSavingPosition;
 };
 
 
@@ -181,19 +181,36 @@ void kpToolSelectionResizeScaleCommand::resizeScaleAndMove (bool delayed)
         Q_ASSERT (dynamic_cast <kpAbstractImageSelection *> (m_originalSelectionPtr));
         auto *imageSel = dynamic_cast <kpAbstractImageSelection *> (m_originalSelectionPtr);
 
-        newSelPtr = new kpRectangularImageSelection (
-            QRect (imageSel->x (),
-                   imageSel->y (),
-                   m_newWidth,
-                   m_newHeight),
-            kpPixmapFX::scale (imageSel->baseImage (),
-                               m_newWidth, m_newHeight,
-                               !delayed/*if not delayed, smooth*/),
-            imageSel->transparency ());
+        const QRect newRect (imageSel->x (),
+                             imageSel->y (),
+                             m_newWidth,
+                             m_newHeight);
+
+        if (delayed && imageSel->hasContent ())
+        {
+            // While the user is dragging, preview with a nearest neighbour
+            // scale.  This is done lazily, only for the parts of the
+            // selection that get painted, rather than scaling the full
+            // image on every mouse move.
+            auto *newImageSel = new kpRectangularImageSelection (newRect,
+                imageSel->transparency ());
+            newImageSel->setBaseImageScaledFrom (imageSel->baseImage (),
+                imageSel->transparentImage ());
+            newSelPtr = newImageSel;
+        }
+        else
+        {
+            newSelPtr = new kpRectangularImageSelection (newRect,
+                kpPixmapFX::scale (imageSel->baseImage (),
+                                   m_newWidth, m_newHeight,
+                                   !delayed/*if not delayed, smooth*/),
+                imageSel->transparency ());
+        }
 
         if (delayed)
         {
-            // Call self (once) with delayed==false in 200ms
+            // Call self (once) with delayed==false in 200ms, to do the
+            // smooth scale when the user pauses
             m_smoothScaleTimer->start (200/*ms*/);
         }
     }
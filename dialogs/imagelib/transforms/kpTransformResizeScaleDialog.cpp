@@ -63,6 +63,7 @@
 
 #define kpSettingResizeScaleLastKeepAspect "Resize Scale - Last Keep Aspect"
 #define kpSettingResizeScaleScaleType "Resize Scale - ScaleType"
+#define kpSettingResizeScaleSmoothScaleFilter "Resize Scale - Smooth Scale Filter"
 
 //---------------------------------------------------------------------
 
@@ -116,6 +117,11 @@ kpTransformResizeScaleDialog::kpTransformResizeScaleDialog (
     m_lastType = static_cast<kpTransformResizeScaleCommand::Type>
                    (cfg.readEntry(kpSettingResizeScaleScaleType,
                                   static_cast<int>(kpTransformResizeScaleCommand::Resize)));
+    m_smoothScaleFilterCombo->setCurrentIndex (
+        qBound (0,
+                cfg.readEntry (kpSettingResizeScaleSmoothScaleFilter,
+                               static_cast<int>(kpImageScaler::DefaultFilter)),
+                m_smoothScaleFilterCombo->count () - 1));
 
     slotActOnChanged ();
 
@@ -235,7 +241,9 @@ QGroupBox *kpTransformResizeScaleDialog::createOperationGroupBox (QWidget *baseW
 
                   "<li><b>Smooth Scale</b>: This is the same as"
                   " <i>Scale</i> except that it blends neighboring"
-                  " pixels to produce a smoother looking picture.</li>"
+                  " pixels to produce a smoother looking picture."
+                  " The <b>filter</b> decides how: <i>Box</i> is the"
+                  " softest and <i>Lanczos</i> the sharpest.</li>"
               "</ul>"
               "</qt>"));
 
@@ -265,6 +273,21 @@ QGroupBox *kpTransformResizeScaleDialog::createOperationGroupBox (QWidget *baseW
     operationLayout->addWidget (m_scaleButton, 0, 1, Qt::AlignCenter);
     operationLayout->addWidget (m_smoothScaleButton, 0, 2, Qt::AlignCenter);
 
+    // Same order as kpImageScaler::Filter.
+    m_smoothScaleFilterCombo = new QComboBox (operationGroupBox);
+    m_smoothScaleFilterCombo->addItem (i18n ("Box"));
+    m_smoothScaleFilterCombo->addItem (i18n ("Bilinear"));
+    m_smoothScaleFilterCombo->addItem (i18n ("Bicubic"));
+    m_smoothScaleFilterCombo->addItem (i18n ("Lanczos"));
+
+    auto *smoothScaleFilterLabel = new QLabel (i18n ("&Filter:"), operationGroupBox);
+    smoothScaleFilterLabel->setBuddy (m_smoothScaleFilterCombo);
+
+    auto *smoothScaleFilterLayout = new QHBoxLayout ();
+    smoothScaleFilterLayout->addWidget (smoothScaleFilterLabel);
+    smoothScaleFilterLayout->addWidget (m_smoothScaleFilterCombo, 1/*stretch*/);
+    operationLayout->addLayout (smoothScaleFilterLayout, 1, 0, 1, 3);
+
     connect (m_resizeButton, &QToolButton::toggled,
              this, &kpTransformResizeScaleDialog::slotTypeChanged);
     connect (m_scaleButton, &QToolButton::toggled,
@@ -522,6 +545,8 @@ void kpTransformResizeScaleDialog::slotActOnChanged ()
 void kpTransformResizeScaleDialog::slotTypeChanged ()
 {
     m_lastType = type ();
+
+    m_smoothScaleFilterCombo->setEnabled (m_lastType == kpTransformResizeScaleCommand::SmoothScale);
 }
 
 //---------------------------------------------------------------------
@@ -680,6 +705,14 @@ kpTransformResizeScaleCommand::Type kpTransformResizeScaleDialog::type () const
 //---------------------------------------------------------------------
 // public
 
+kpImageScaler::Filter kpTransformResizeScaleDialog::smoothScaleFilter () const
+{
+    return static_cast<kpImageScaler::Filter> (m_smoothScaleFilterCombo->currentIndex ());
+}
+
+//---------------------------------------------------------------------
+// public
+
 bool kpTransformResizeScaleDialog::isNoOp () const
 {
     return (imageWidth () == originalWidth () &&
@@ -833,6 +866,7 @@ void kpTransformResizeScaleDialog::accept ()
 
     cfg.writeEntry(kpSettingResizeScaleLastKeepAspect, m_keepAspectRatioCheckBox->isChecked());
     cfg.writeEntry(kpSettingResizeScaleScaleType, static_cast<int>(m_lastType));
+    cfg.writeEntry(kpSettingResizeScaleSmoothScaleFilter, m_smoothScaleFilterCombo->currentIndex());
     cfg.sync();
 }
 
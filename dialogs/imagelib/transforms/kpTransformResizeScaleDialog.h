@@ -64,6 +64,7 @@ Q_OBJECT
     int imageHeight () const;
     bool actOnSelection () const;
     kpTransformResizeScaleCommand::Type type () const;
+    kpImageScaler::Filter smoothScaleFilter () const;
 
     bool isNoOp () const;
 
@@ -107,6 +108,7 @@ Q_OBJECT
     QToolButton *m_resizeButton,
                 *m_scaleButton,
                 *m_smoothScaleButton;
+    QComboBox *m_smoothScaleFilterCombo;
 
     QSpinBox *m_originalWidthInput, *m_originalHeightInput,
              *m_newWidthInput, *m_newHeightInput;
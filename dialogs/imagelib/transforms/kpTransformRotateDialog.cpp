@@ -239,7 +239,8 @@ QImage kpTransformRotateDialog::transformPixmap (const QImage &image,
 {
     return kpPixmapFX::rotate (image, angle (),
                                m_environ->backgroundColor (m_actOnSelection),
-                               targetWidth, targetHeight);
+                               targetWidth, targetHeight,
+                               true/*pretty preview*/);
 }
 
 
@@ -175,7 +175,8 @@ QImage kpTransformSkewDialog::transformPixmap (const QImage &image,
                              verticalAngleForPixmapFX (),
                              m_environ->backgroundColor (m_actOnSelection),
                              targetWidth,
-                             targetHeight);
+                             targetHeight,
+                             true/*pretty preview*/);
 }
 
 
@@ -100,18 +100,30 @@ QSize kpDocumentSaveOptionsPreviewDialog::preferredMinimumSize () const
 }
 
 
+// public
+QSize kpDocumentSaveOptionsPreviewDialog::previewSize () const
+{
+    return m_filePixmapLabel->size ().expandedTo (s_pixmapLabelMinimumSize);
+}
+
+
 // public slot
 void kpDocumentSaveOptionsPreviewDialog::setFilePixmapAndSize (const QImage &pixmap,
-                                                               qint64 fileSize)
+                                                               qint64 fileSize,
+                                                               const QSize &fullSize,
+                                                               bool isExact)
 {
     delete m_filePixmap;
     m_filePixmap = new QImage (pixmap);
+    m_fullSize = fullSize;
 
     updatePixmapPreview ();
 
     m_fileSize = fileSize;
 
-    const kpCommandSize::SizeType pixmapSize = kpCommandSize::PixmapSize (pixmap);
+    // (the preview has the same depth as the file but maybe not the same size)
+    const kpCommandSize::SizeType pixmapSize = pixmap.isNull () ? 0 :
+        kpCommandSize::PixmapSize (fullSize.width (), fullSize.height (), pixmap.depth ());
     // (int cast is safe as long as the file size is not more than 20 million
     //  -- i.e. INT_MAX / 100 -- times the pixmap size)
     const int percent = pixmapSize ?
@@ -126,8 +138,17 @@ void kpDocumentSaveOptionsPreviewDialog::setFilePixmapAndSize (const QImage &pix
                << (pixmapSize ? (kpCommandSize::SizeType) fileSize * 100 / pixmapSize : 0);
 #endif
 
-    m_fileSizeLabel->setText (i18np ("1 byte (approx. %2%)", "%1 bytes (approx. %2%)",
-                                     m_fileSize, percent));
+    if (isExact)
+    {
+        m_fileSizeLabel->setText (i18np ("1 byte (approx. %2%)", "%1 bytes (approx. %2%)",
+                                         m_fileSize, percent));
+    }
+    else
+    {
+        m_fileSizeLabel->setText (i18np ("About 1 byte (approx. %2%)...",
+                                         "About %1 bytes (approx. %2%)...",
+                                         m_fileSize, percent));
+    }
 }
 
 // public slot
@@ -139,16 +160,18 @@ void kpDocumentSaveOptionsPreviewDialog::updatePixmapPreview ()
                << " filePixmap.size=" << m_filePixmap->size ();
 #endif
 
-    if (m_filePixmap)
+    if (m_filePixmap && !m_filePixmap->isNull ())
     {
-        int maxNewWidth = qMin (m_filePixmap->width (),
+        // Fit the full size image, not the (possibly already scaled down)
+        // preview, so that it is not shown smaller than it need be.
+        int maxNewWidth = qMin (m_fullSize.width (),
                                 m_filePixmapLabel->width ()),
-            maxNewHeight = qMin (m_filePixmap->height (),
+            maxNewHeight = qMin (m_fullSize.height (),
                                  m_filePixmapLabel->height ());
 
         double keepsAspect = kpTransformPreviewDialog::aspectScale (
             maxNewWidth, maxNewHeight,
-            m_filePixmap->width (), m_filePixmap->height ());
+            m_fullSize.width (), m_fullSize.height ());
     #if DEBUG_KP_DOCUMENT_SAVE_OPTIONS_WIDGET
         qCDebug(kpLogDialogs) << "\tmaxNewWidth=" << maxNewWidth
                    << " maxNewHeight=" << maxNewHeight
@@ -156,12 +179,12 @@ void kpDocumentSaveOptionsPreviewDialog::updatePixmapPreview ()
     #endif
 
         const int newWidth = kpTransformPreviewDialog::scaleDimension (
-            m_filePixmap->width (),
+            m_fullSize.width (),
             keepsAspect,
             1,
             maxNewWidth);
         const int newHeight = kpTransformPreviewDialog::scaleDimension (
-            m_filePixmap->height (),
+            m_fullSize.height (),
             keepsAspect,
             1,
             maxNewHeight);
@@ -53,6 +53,9 @@ public:
 
     QSize preferredMinimumSize () const;
 
+    // The largest preview image that can be shown without scaling it.
+    QSize previewSize () const;
+
 protected:
     static const QSize s_pixmapLabelMinimumSize;
 
@@ -62,7 +65,11 @@ signals:
     void finished ();
 
 public slots:
-    void setFilePixmapAndSize (const QImage &filePixmap, qint64 fileSize);
+    // <filePixmap> is the saved image as loaded back from the file, of
+    // <fullSize>, but may have been scaled down to previewSize() already.
+    // <fileSize> may be an estimate, if <isExact> is false.
+    void setFilePixmapAndSize (const QImage &filePixmap, qint64 fileSize,
+                               const QSize &fullSize, bool isExact = true);
     void updatePixmapPreview ();
 
 protected:
@@ -72,6 +79,7 @@ protected:
 
 protected:
     QImage *m_filePixmap;
+    QSize m_fullSize;
     qint64 m_fileSize;
 
     kpResizeSignallingLabel *m_filePixmapLabel;
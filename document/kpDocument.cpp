@@ -54,6 +54,7 @@
 #include <QColor>
 #include <QBrush>
 #include <QFile>
+#include <QFileInfo>
 #include <QImage>
 #include <QList>
 #include <QPainter>
@@ -157,6 +158,10 @@ bool kpDocument::urlExists (const QUrl &url) const
     if (url.isEmpty()) {
         return false;
     }
+    // (no need for a KIO round trip, which is comparatively slow)
+    if (url.isLocalFile ()) {
+        return QFileInfo::exists (url.toLocalFile ());
+    }
     KIO::StatJob *job = KIO::statDetails(url, KIO::StatJob::SourceSide, KIO::StatNoDetails);
     KJobWidgets::setWindow (job, d->environ->dialogParent ());
     return job->exec();
@@ -218,6 +223,10 @@ void kpDocument::setMetaInfo (const kpDocumentMetaInfo &metaInfo)
 
 void kpDocument::setModified (bool yes)
 {
+    if (yes) {
+        d->modificationCount++;
+    }
+
     if (yes == m_modified) {
         return;
     }
@@ -316,6 +325,22 @@ kpImage kpDocument::getImageAt (const QRect &rect) const
 
 //---------------------------------------------------------------------
 
+// public
+kpImage kpDocument::mipmap (int mipmapLevel) const
+{
+    return d->mipmaps.level (*m_image, mipmapLevel);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocument::isOpaqueAt (const QRect &rect) const
+{
+    return d->opacityMap.isOpaque (*m_image, rect);
+}
+
+//---------------------------------------------------------------------
+
 // public
 void kpDocument::setImageAt (const kpImage &image, const QPoint &at)
 {
@@ -365,17 +390,11 @@ kpImage *kpDocument::imagePointer () const
 // public
 void kpDocument::setImage (const kpImage &image)
 {
-    m_oldWidth = width ();
-    m_oldHeight = height ();
+    const QSize oldSize (width (), height ());
 
     *m_image = image;
 
-    if (m_oldWidth == width () && m_oldHeight == height ()) {
-        slotContentsChanged (image.rect ());
-    }
-    else {
-        slotSizeChanged (QSize (width (), height ()));
-    }
+    imageChangedInPlace (oldSize);
 }
 
 //---------------------------------------------------------------------
@@ -399,6 +418,22 @@ void kpDocument::setImage (bool ofSelection, const kpImage &image)
 
 //---------------------------------------------------------------------
 
+// public
+void kpDocument::imageChangedInPlace (const QSize &oldSize)
+{
+    m_oldWidth = oldSize.width ();
+    m_oldHeight = oldSize.height ();
+
+    if (m_oldWidth == width () && m_oldHeight == height ()) {
+        slotContentsChanged (m_image->rect ());
+    }
+    else {
+        slotSizeChanged (QSize (width (), height ()));
+    }
+}
+
+//---------------------------------------------------------------------
+
 void kpDocument::fill (const kpColor &color)
 {
 #if DEBUG_KP_DOCUMENT
@@ -438,6 +473,9 @@ void kpDocument::resize (int w, int h, const kpColor &backgroundColor)
 
 void kpDocument::slotContentsChanged (const QRect &rect)
 {
+    d->mipmaps.invalidate (rect);
+    d->opacityMap.invalidate (rect);
+
     setModified ();
     emit contentsChanged (rect);
 }
@@ -446,6 +484,9 @@ void kpDocument::slotContentsChanged (const QRect &rect)
 
 void kpDocument::slotSizeChanged (const QSize &newSize)
 {
+    d->mipmaps.clear ();
+    d->opacityMap.clear ();
+
     setModified ();
     emit sizeChanged (newSize.width(), newSize.height());
     emit sizeChanged (newSize);
@@ -47,6 +47,7 @@ class QSize;
 
 class kpColor;
 class kpDocumentEnvironment;
+class kpDocumentLoader;
 class kpDocumentSaveOptions;
 class kpDocumentMetaInfo;
 class kpAbstractImageSelection;
@@ -84,10 +85,20 @@ public:
                                      QWidget *parent,
                                      kpDocumentSaveOptions *saveOptions = nullptr,
                                      kpDocumentMetaInfo *metaInfo = nullptr);
+    // Same as above except that <loader> has already been run and has
+    // finished.  Shows the same error dialogs.
+    static QImage getPixmapFromLoader (const kpDocumentLoader &loader,
+                                       bool suppressDoesntExistDialog,
+                                       QWidget *parent,
+                                       kpDocumentSaveOptions *saveOptions = nullptr,
+                                       kpDocumentMetaInfo *metaInfo = nullptr);
     // REFACTOR: fix: open*() should only be called once.
     //                Create a new kpDocument() if you want to open again.
     void openNew (const QUrl &url);
     bool open (const QUrl &url, bool newDocSameNameIfNotExist = false);
+    // Same as above except that the image comes from <loader>, which has
+    // finished.
+    bool open (const kpDocumentLoader &loader, bool newDocSameNameIfNotExist = false);
 
     static void getDataFromImage(const QImage &image,
                                  kpDocumentSaveOptions &saveOptions,
@@ -113,13 +124,29 @@ public:
                                   const kpDocumentMetaInfo &metaInfo,
                                   bool lossyPrompt,
                                   QWidget *parent);
+
+    // save() and saveAs() return as soon as they have started saving a
+    // snapshot of imageWithSelection(), which is encoded in the background
+    // while the document goes on being edited.  They return false if the
+    // user cancelled or nothing could be started.
+    //
+    // When the save finishes, documentSaved() is emitted or, on failure,
+    // an error dialog is shown.  isModified() only becomes false if the
+    // document has not been modified since the snapshot.
+    //
+    // Any save still in progress is waited for first.
     bool save (bool lossyPrompt = false);
     bool saveAs (const QUrl &url,
                  const kpDocumentSaveOptions &saveOptions,
                  bool lossyPrompt = true);
 
+    bool isSaving () const;
+    // Blocks, without processing user input, until any save in progress
+    // has finished.  Returns whether the last save succeeded.
+    bool waitForSave ();
 
-    // Returns whether save() or saveAs() have ever been called and returned true
+
+    // Returns whether a save() or saveAs() has ever succeeded
     bool savedAtLeastOnceBefore () const;
 
     QUrl url () const;
@@ -188,6 +215,24 @@ public:
     // selection).
     kpImage getImageAt (const QRect &rect) const;
 
+    // Returns the document's image (not including the selection),
+    // downscaled by 2^<mipmapLevel> in each direction with a box filter.
+    // Use kpImagePyramid::levelRect() to map document rectangles onto it.
+    //
+    // Downscaled images are cached and only the parts that have changed
+    // since the last call are recomputed, so drawing a large document
+    // zoomed out costs about as much as the view, not the document.
+    //
+    // The returned image is implicitly shared with the cache, so don't
+    // hold onto it: the next call would have to detach (copy) it.
+    kpImage mipmap (int mipmapLevel) const;
+
+    // Returns whether every pixel of the document's image (not including
+    // the selection) inside <rect> is fully opaque.  This is tracked per
+    // tile and only rescanned after changes, so it is cheap to call on
+    // every repaint.
+    bool isOpaqueAt (const QRect &rect) const;
+
     void setImageAt (const kpImage &image, const QPoint &at);
 
     // "image(false)" returns a copy of the document's image, ignoring any
@@ -206,6 +251,14 @@ public:
     //             an image selection.
     void setImage (bool ofSelection, const kpImage &image);
 
+    // Call after replacing all of "*imagePointer()" in place (e.g. with
+    // kpPixmapFX::rotateQuarterTurns()), which may have resized it from
+    // <oldSize>.  Emits the same signals as setImage().
+    //
+    // Changing the image in place, instead of calling setImage() with a
+    // changed copy, means that huge images are not held twice.
+    void imageChangedInPlace (const QSize &oldSize);
+
 
     //
     // Selections
@@ -315,7 +368,11 @@ public slots:
 
 signals:
     void documentOpened ();
+    // Emitted when save() or saveAs() takes the snapshot that it will save.
+    void documentSaving ();
     void documentSaved ();
+    // Emitted when isSaving() changes.
+    void savingChanged (bool isSaving);
 
     // Emitted whenever the isModified() flag changes from false to true.
     // This is the _only_ signal that may be emitted in addition to the others.
@@ -333,6 +390,16 @@ signals:
     // whether we've switched to the text tool).
     void selectionIsTextChanged (bool isText);
 
+private:
+    // Implements open() once the image has been loaded into <newPixmap>
+    // (null if it could not be).
+    bool openImage (const QUrl &url, const QImage &newPixmap,
+                    const kpDocumentSaveOptions &newSaveOptions,
+                    const kpDocumentMetaInfo &newMetaInfo,
+                    bool newDocSameNameIfNotExist);
+
+    void saveFinished ();
+
 private:
     int m_constructorWidth, m_constructorHeight;
     kpImage *m_image;
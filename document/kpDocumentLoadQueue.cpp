@@ -0,0 +1,240 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_DOCUMENT_LOAD_QUEUE 0
+
+
+#include "kpDocumentLoadQueue.h"
+
+#include <QHash>
+#include <QImageReader>
+#include <QList>
+#include <QPointer>
+#include <QThread>
+#include <QUrl>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocumentLoader.h"
+
+//---------------------------------------------------------------------
+
+struct kpDocumentLoadQueueItem
+{
+    QPointer <kpDocumentLoader> loader;
+    // See EstimateBytes().
+    qint64 bytes;
+};
+
+struct kpDocumentLoadQueuePrivate
+{
+    int maxLoading;
+    qint64 memoryBudget;
+
+    QList <kpDocumentLoadQueueItem> queued;
+
+    // The estimated memory use of each running loader, by ticket.  Not by
+    // loader, since a deleted loader may still be running.
+    QHash <quint64, qint64> loadingBytes;
+    qint64 totalLoadingBytes;
+    quint64 nextTicket;
+};
+
+//---------------------------------------------------------------------
+
+// Returns roughly how much memory decoding <url> takes, from the image
+// header, or 0 if that cannot be read cheaply.
+static qint64 EstimateBytes (const QUrl &url)
+{
+    if (!url.isLocalFile ()) {
+        return 0;
+    }
+
+    QImageReader reader (url.toLocalFile ());
+    const QSize size = reader.size ();
+    if (!size.isValid ()) {
+        return 0;
+    }
+
+    // The decoded image, plus the ARGB32_Premultiplied copy that
+    // kpDocumentLoader converts it to.
+    return qint64 (size.width ()) * size.height () * 4 * 2;
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentLoadQueue::kpDocumentLoadQueue (QObject *parent)
+    : QObject (parent),
+      d (new kpDocumentLoadQueuePrivate ())
+{
+    d->maxLoading = qMax (1, QThread::idealThreadCount ());
+    d->memoryBudget = qint64 (1) << 30;
+    d->totalLoadingBytes = 0;
+    d->nextTicket = 0;
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentLoadQueue::~kpDocumentLoadQueue ()
+{
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentLoadQueue::maxLoading () const
+{
+    return d->maxLoading;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoadQueue::setMaxLoading (int count)
+{
+    d->maxLoading = qMax (1, count);
+    startQueued ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+qint64 kpDocumentLoadQueue::memoryBudget () const
+{
+    return d->memoryBudget;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoadQueue::setMemoryBudget (qint64 bytes)
+{
+    d->memoryBudget = bytes;
+    startQueued ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoadQueue::enqueue (kpDocumentLoader *loader)
+{
+#if DEBUG_KP_DOCUMENT_LOAD_QUEUE
+    qCDebug(kpLogDocument) << "kpDocumentLoadQueue::enqueue(" << loader->url () << ")"
+                           << "queued=" << d->queued.count ()
+                           << "loading=" << d->loadingBytes.count ();
+#endif
+
+    kpDocumentLoadQueueItem item;
+    item.loader = loader;
+    item.bytes = ::EstimateBytes (loader->url ());
+
+    d->queued.append (item);
+    startQueued ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentLoadQueue::loadingCount () const
+{
+    return d->loadingBytes.count ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentLoadQueue::queuedCount () const
+{
+    int count = 0;
+    for (const kpDocumentLoadQueueItem &item : d->queued)
+    {
+        if (item.loader) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoadQueue::startQueued ()
+{
+    while (!d->queued.isEmpty () && d->loadingBytes.count () < d->maxLoading)
+    {
+        const kpDocumentLoadQueueItem item = d->queued.first ();
+        if (!item.loader)
+        {
+            // (deleted while queued)
+            d->queued.removeFirst ();
+            continue;
+        }
+
+        if (!d->loadingBytes.isEmpty () &&
+            d->totalLoadingBytes + item.bytes > d->memoryBudget)
+        {
+        #if DEBUG_KP_DOCUMENT_LOAD_QUEUE
+            qCDebug(kpLogDocument) << "kpDocumentLoadQueue: waiting for memory for"
+                                   << item.loader->url () << "bytes=" << item.bytes;
+        #endif
+            break;
+        }
+
+        d->queued.removeFirst ();
+
+        const quint64 ticket = d->nextTicket++;
+        d->loadingBytes.insert (ticket, item.bytes);
+        d->totalLoadingBytes += item.bytes;
+
+        // (may be called after we have gone)
+        const QPointer <kpDocumentLoadQueue> queue (this);
+        item.loader->setStoppedFunction ([queue, ticket] {
+            if (queue) {
+                queue->loaderDone (ticket);
+            }
+        });
+
+        item.loader->start ();
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoadQueue::loaderDone (quint64 ticket)
+{
+    Q_ASSERT (d->loadingBytes.contains (ticket));
+
+    d->totalLoadingBytes -= d->loadingBytes.take (ticket);
+    startQueued ();
+}
+
+//---------------------------------------------------------------------
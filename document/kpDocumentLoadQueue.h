@@ -0,0 +1,91 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_DOCUMENT_LOAD_QUEUE_H
+#define KP_DOCUMENT_LOAD_QUEUE_H
+
+
+#include <QObject>
+
+
+class kpDocumentLoader;
+
+struct kpDocumentLoadQueuePrivate;
+
+
+//
+// Starts kpDocumentLoader's, such as those for the files given on the
+// command line, a few at a time.
+//
+// At most maxLoading() loaders run at once, so that decoding uses every
+// core without starving the GUI thread.  The images that they are
+// decoding, estimated from the file headers, must also fit in
+// memoryBudget() - except that one loader always runs, however big its
+// image.
+//
+// A loader's place is given up just before it emits finished(), so that
+// the next one is already loading while e.g. an error dialog is shown for
+// it.  A loader that is deleted before it finishes keeps its place until
+// its decoding thread has given up.
+//
+class kpDocumentLoadQueue : public QObject
+{
+Q_OBJECT
+
+public:
+    explicit kpDocumentLoadQueue (QObject *parent = nullptr);
+    ~kpDocumentLoadQueue () override;
+
+    // Defaults to QThread::idealThreadCount().
+    int maxLoading () const;
+    void setMaxLoading (int count);
+
+    // In bytes.  Defaults to 1 GiB.
+    qint64 memoryBudget () const;
+    void setMemoryBudget (qint64 bytes);
+
+    // Calls <loader>'s start() once there is room.  <loader> is not owned
+    // and may be deleted at any time (which cancels it).
+    //
+    // This reads the header of <loader>'s file, to estimate its memory use.
+    void enqueue (kpDocumentLoader *loader);
+
+    // The number of loaders that have been started but have not stopped
+    // yet, and the number that are waiting to be started.
+    int loadingCount () const;
+    int queuedCount () const;
+
+private:
+    void startQueued ();
+    void loaderDone (quint64 ticket);
+
+    kpDocumentLoadQueuePrivate * const d;
+};
+
+
+#endif  // KP_DOCUMENT_LOAD_QUEUE_H
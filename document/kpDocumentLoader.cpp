@@ -0,0 +1,571 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_DOCUMENT_LOADER 0
+
+
+#include "kpDocumentLoader.h"
+
+#include <climits>
+#include <functional>
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QFile>
+#include <QImageReader>
+#include <QMimeDatabase>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QUrl>
+
+#include <KIO/StoredTransferJob>
+#include <KJobWidgets>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+#include "document/kpDocumentSaveOptions.h"
+#include "imagelib/kpDocumentMetaInfo.h"
+
+//---------------------------------------------------------------------
+
+// The longest side of the image passed to previewReady().
+static const int PreviewSize = 512;
+
+// progress() once a remote file has been fetched.  Decoding covers the
+// rest.  Local files are not fetched so decoding covers all of it.
+static const int FetchedPercent = 50;
+
+//---------------------------------------------------------------------
+
+// State shared between a kpDocumentLoader and its decoding thread, which
+// may still be running after the loader has been destroyed.
+struct kpDocumentLoaderShared
+{
+    ~kpDocumentLoaderShared ()
+    {
+        // The loader was destroyed before it finished, and its decoding
+        // thread (if any) has now returned too.
+        if (stopped && QCoreApplication::instance ())
+        {
+            QMetaObject::invokeMethod (QCoreApplication::instance (), stopped,
+                Qt::QueuedConnection);
+        }
+    }
+
+    QAtomicInt cancelled;
+
+    // See kpDocumentLoader::setStoppedFunction().  Cleared once called.
+    std::function <void ()> stopped;
+
+    // Guards <loader>, which is cleared when the loader is destroyed.
+    QMutex mutex;
+    kpDocumentLoader *loader = nullptr;
+
+    // Calls <func> on the loader's thread, unless the loader has gone by
+    // then.
+    void post (const std::function <void (kpDocumentLoader *)> &func)
+    {
+        QMutexLocker locker (&mutex);
+        if (!loader) {
+            return;
+        }
+
+        // (If the loader is destroyed before this is delivered, Qt drops
+        //  it.)
+        kpDocumentLoader *target = loader;
+        QMetaObject::invokeMethod (target, [target, func] { func (target); },
+            Qt::QueuedConnection);
+    }
+};
+
+//---------------------------------------------------------------------
+
+// The QIODevice that the full resolution image is decoded from.
+//
+// It fails reads once loading has been cancelled, which makes
+// QImageReader give up, and reports how far through the file the decoder
+// has got, as a percentage starting from <startPercent>.
+class kpDocumentLoaderDevice : public QBuffer
+{
+public:
+    kpDocumentLoaderDevice (QByteArray *data, kpDocumentLoaderShared *shared,
+            int startPercent)
+        : QBuffer (data),
+          m_shared (shared),
+          m_startPercent (startPercent),
+          m_lastPercent (-1)
+    {
+    }
+
+protected:
+    qint64 readData (char *data, qint64 maxSize) override
+    {
+        if (m_shared->cancelled.loadAcquire ()) {
+            return -1;
+        }
+
+        const qint64 ret = QBuffer::readData (data, maxSize);
+
+        if (ret > 0 && size () > 0)
+        {
+            const int percent = m_startPercent +
+                int ((100 - m_startPercent) * (pos () + ret) / size ());
+            if (percent != m_lastPercent)
+            {
+                m_lastPercent = percent;
+                m_shared->post ([percent] (kpDocumentLoader *loader) {
+                    emit loader->progress (percent);
+                });
+            }
+        }
+
+        return ret;
+    }
+
+private:
+    kpDocumentLoaderShared * const m_shared;
+    const int m_startPercent;
+    int m_lastPercent;
+};
+
+//---------------------------------------------------------------------
+
+class kpDocumentLoaderTask : public QRunnable
+{
+public:
+    explicit kpDocumentLoaderTask (const std::function <void ()> &func)
+        : m_func (func)
+    {
+    }
+
+    void run () override
+    {
+        m_func ();
+    }
+
+private:
+    const std::function <void ()> m_func;
+};
+
+//---------------------------------------------------------------------
+
+// Decodes the file <fileName> with contents <data>, on a worker thread.
+//
+// <data> is only read from so it may wrap memory that it does not own
+// (see DecodeLocalFile()).
+static kpDocumentLoader::Status Decode (QByteArray data, const QString &fileName,
+        int startPercent,
+        kpDocumentLoaderShared *shared,
+        kpImage *image,
+        kpDocumentSaveOptions *saveOptions,
+        kpDocumentMetaInfo *metaInfo)
+{
+    // (the QIODevice overload only reads as much of the header as the magic
+    //  rules need, rather than scanning all of <data>)
+    {
+        QBuffer header (&data);
+        header.open (QIODevice::ReadOnly);
+
+        QMimeDatabase db;
+        saveOptions->setMimeType (db.mimeTypeForFileNameAndData (fileName, &header).name ());
+    }
+
+    // Only bother with a preview if the format can decode one much faster
+    // than the whole image (e.g. JPEG decodes at 1/2, 1/4 or 1/8 size).
+    {
+        QBuffer buffer (&data);
+        buffer.open (QIODevice::ReadOnly);
+        QImageReader reader (&buffer);
+        reader.setAutoTransform (true);
+        reader.setDecideFormatFromContent (true);
+
+        const QSize size = reader.size ();
+        if (size.isValid () &&
+            qMax (size.width (), size.height ()) > PreviewSize * 2 &&
+            reader.supportsOption (QImageIOHandler::ScaledSize))
+        {
+            reader.setScaledSize (size.scaled (PreviewSize, PreviewSize, Qt::KeepAspectRatio));
+
+            const QImage preview = reader.read ();
+            if (!preview.isNull ())
+            {
+                shared->post ([preview] (kpDocumentLoader *loader) {
+                    emit loader->previewReady (preview);
+                });
+            }
+        }
+    }
+
+    kpDocumentLoaderDevice device (&data, shared, startPercent);
+    device.open (QIODevice::ReadOnly);
+    QImageReader reader (&device);
+    reader.setAutoTransform (true);
+    reader.setDecideFormatFromContent (true);
+
+    QImage decoded = reader.read ();
+
+    if (shared->cancelled.loadAcquire ()) {
+        return kpDocumentLoader::Cancelled;
+    }
+
+    if (decoded.isNull ()) {
+        return kpDocumentLoader::CouldNotDecode;
+    }
+
+#if DEBUG_KP_DOCUMENT_LOADER
+    qCDebug(kpLogDocument) << "kpDocumentLoader: decoded" << fileName
+                           << "depth=" << decoded.depth ()
+                           << "hasAlphaChannel=" << decoded.hasAlphaChannel ();
+#endif
+
+    kpDocument::getDataFromImage (decoded, *saveOptions, *metaInfo);
+
+    // make sure we always have Format_ARGB32_Premultiplied as this is the fastest to draw on
+    // and Qt can not draw onto Format_Indexed8 (Qt-4.7)
+    if (decoded.format () != QImage::Format_ARGB32_Premultiplied) {
+        decoded = decoded.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    }
+
+    *image = decoded;
+    return kpDocumentLoader::Loaded;
+}
+
+//---------------------------------------------------------------------
+
+// Decodes the local file <path>, on a worker thread.
+//
+// The file is memory mapped, instead of being copied into a QByteArray,
+// so that peak memory usage is just the decoded image.
+static kpDocumentLoader::Status DecodeLocalFile (const QString &path,
+        const QString &fileName,
+        kpDocumentLoaderShared *shared,
+        kpImage *image,
+        kpDocumentSaveOptions *saveOptions,
+        kpDocumentMetaInfo *metaInfo)
+{
+    QFile file (path);
+    if (!file.open (QIODevice::ReadOnly))
+    {
+    #if DEBUG_KP_DOCUMENT_LOADER
+        qCDebug(kpLogDocument) << "kpDocumentLoader: could not open" << path
+                               << "error=" << file.errorString ();
+    #endif
+        return kpDocumentLoader::CouldNotRead;
+    }
+
+    // (unmapped when <file> is destroyed, after Decode() has finished with it)
+    const qint64 size = file.size ();
+    uchar *const mapped = (size > 0 && size <= INT_MAX) ? file.map (0, size) : nullptr;
+    if (mapped)
+    {
+        return ::Decode (QByteArray::fromRawData (reinterpret_cast <const char *> (mapped), int (size)),
+            fileName, 0/*start percent*/,
+            shared, image, saveOptions, metaInfo);
+    }
+
+    // Not a regular file (e.g. a FIFO) or the filesystem does not support
+    // mapping.
+#if DEBUG_KP_DOCUMENT_LOADER
+    qCDebug(kpLogDocument) << "kpDocumentLoader: could not map" << path << "- reading instead";
+#endif
+    const QByteArray data = file.readAll ();
+    if (file.error () != QFileDevice::NoError) {
+        return kpDocumentLoader::CouldNotRead;
+    }
+
+    return ::Decode (data, fileName, 0/*start percent*/,
+        shared, image, saveOptions, metaInfo);
+}
+
+//---------------------------------------------------------------------
+
+struct kpDocumentLoaderPrivate
+{
+    QUrl url;
+    QWidget *window = nullptr;
+
+    kpDocumentLoader::Status status = kpDocumentLoader::Loading;
+
+    QSharedPointer <kpDocumentLoaderShared> shared;
+    KIO::StoredTransferJob *job = nullptr;
+
+    kpImage image;
+    kpDocumentSaveOptions saveOptions;
+    kpDocumentMetaInfo metaInfo;
+};
+
+//---------------------------------------------------------------------
+
+kpDocumentLoader::kpDocumentLoader (const QUrl &url, QObject *parent)
+    : QObject (parent),
+      d (new kpDocumentLoaderPrivate ())
+{
+    d->url = url;
+
+    d->shared = QSharedPointer <kpDocumentLoaderShared>::create ();
+    d->shared->loader = this;
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentLoader::~kpDocumentLoader ()
+{
+    d->shared->cancelled.storeRelease (1);
+
+    if (d->job) {
+        d->job->kill (KJob::Quietly);
+    }
+
+    {
+        QMutexLocker locker (&d->shared->mutex);
+        d->shared->loader = nullptr;
+    }
+
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QUrl kpDocumentLoader::url () const
+{
+    return d->url;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoader::setWindow (QWidget *window)
+{
+    d->window = window;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoader::setStoppedFunction (const std::function <void ()> &func)
+{
+    d->shared->stopped = func;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentLoader::start ()
+{
+#if DEBUG_KP_DOCUMENT_LOADER
+    qCDebug(kpLogDocument) << "kpDocumentLoader::start() url=" << d->url;
+#endif
+
+    Q_ASSERT (d->status == Loading && !d->job);
+
+    if (d->url.isEmpty ())
+    {
+        QMetaObject::invokeMethod (this, [this] { finish (CouldNotRead); },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    // Local files are mapped directly by the decoding thread.  Going
+    // through KIO would copy the whole file into memory first.
+    if (d->url.isLocalFile ())
+    {
+        const QString path = d->url.toLocalFile ();
+        const QString fileName = d->url.fileName ();
+        startDecoding ([path, fileName] (kpDocumentLoaderShared *shared, kpImage *image,
+                kpDocumentSaveOptions *saveOptions, kpDocumentMetaInfo *metaInfo)
+            {
+                return ::DecodeLocalFile (path, fileName, shared, image, saveOptions, metaInfo);
+            });
+        return;
+    }
+
+    d->job = KIO::storedGet (d->url, KIO::NoReload, KIO::HideProgressInfo);
+    KJobWidgets::setWindow (d->job, d->window);
+
+    connect (d->job, &KJob::percent, this,
+        [this] (KJob *, unsigned long percent) {
+            emit progress (int (percent) * FetchedPercent / 100);
+        });
+    connect (d->job, &KJob::result, this, &kpDocumentLoader::fetched);
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentLoader::Status kpDocumentLoader::status () const
+{
+    return d->status;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpImage kpDocumentLoader::image () const
+{
+    return d->image;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentSaveOptions kpDocumentLoader::saveOptions () const
+{
+    return d->saveOptions;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentMetaInfo kpDocumentLoader::metaInfo () const
+{
+    return d->metaInfo;
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpDocumentLoader::cancel ()
+{
+    if (d->status != Loading) {
+        return;
+    }
+
+#if DEBUG_KP_DOCUMENT_LOADER
+    qCDebug(kpLogDocument) << "kpDocumentLoader::cancel() url=" << d->url;
+#endif
+
+    d->shared->cancelled.storeRelease (1);
+
+    // (calls fetched() which finishes)
+    if (d->job) {
+        d->job->kill (KJob::EmitResult);
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoader::fetched ()
+{
+    KIO::StoredTransferJob *job = d->job;
+    d->job = nullptr;
+
+    if (d->shared->cancelled.loadAcquire ())
+    {
+        finish (Cancelled);
+        return;
+    }
+
+    if (job->error ())
+    {
+    #if DEBUG_KP_DOCUMENT_LOADER
+        qCDebug(kpLogDocument) << "kpDocumentLoader::fetched() error=" << job->errorString ();
+    #endif
+        finish (CouldNotRead);
+        return;
+    }
+
+    emit progress (FetchedPercent);
+
+    const QByteArray data = job->data ();
+    const QString fileName = d->url.fileName ();
+    startDecoding ([data, fileName] (kpDocumentLoaderShared *shared, kpImage *image,
+            kpDocumentSaveOptions *saveOptions, kpDocumentMetaInfo *metaInfo)
+        {
+            return ::Decode (data, fileName, FetchedPercent,
+                shared, image, saveOptions, metaInfo);
+        });
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoader::startDecoding (const DecodeFunction &decode)
+{
+    const QSharedPointer <kpDocumentLoaderShared> shared = d->shared;
+
+    QThreadPool::globalInstance ()->start (new kpDocumentLoaderTask (
+        [decode, shared] ()
+        {
+            kpImage image;
+            kpDocumentSaveOptions saveOptions;
+            kpDocumentMetaInfo metaInfo;
+            const Status status = decode (shared.data (),
+                &image, &saveOptions, &metaInfo);
+
+            shared->post ([=] (kpDocumentLoader *loader) {
+                loader->decoded (status, image, saveOptions, metaInfo);
+            });
+        }));
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoader::decoded (kpDocumentLoader::Status status, const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo)
+{
+    d->image = image;
+    d->saveOptions = saveOptions;
+    d->metaInfo = metaInfo;
+
+    if (status == Loaded) {
+        emit progress (100);
+    }
+
+    finish (status);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentLoader::finish (kpDocumentLoader::Status status)
+{
+#if DEBUG_KP_DOCUMENT_LOADER
+    qCDebug(kpLogDocument) << "kpDocumentLoader::finish(" << status << ") url=" << d->url;
+#endif
+
+    d->status = status;
+
+    std::function <void ()> stopped;
+    stopped.swap (d->shared->stopped);
+    if (stopped) {
+        stopped ();
+    }
+
+    emit finished ();
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,137 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef KP_DOCUMENT_LOADER_H
+#define KP_DOCUMENT_LOADER_H
+
+
+#include <functional>
+
+#include <QObject>
+
+#include "imagelib/kpImage.h"
+
+
+class QUrl;
+class QWidget;
+
+class kpDocumentMetaInfo;
+class kpDocumentSaveOptions;
+
+struct kpDocumentLoaderPrivate;
+struct kpDocumentLoaderShared;
+
+
+//
+// Reads and decodes an image file without blocking the event loop.
+//
+// Local files are memory mapped and decoded on a
+// QThreadPool::globalInstance() thread.  Remote files are first fetched
+// asynchronously with KIO.  If the image format can decode a
+// downscaled version cheaply (e.g. JPEG), previewReady() is emitted with
+// one before the full resolution decode starts.
+//
+// Use kpDocument::getPixmapFromFile() unless you need the signals.
+//
+class kpDocumentLoader : public QObject
+{
+Q_OBJECT
+
+public:
+    enum Status
+    {
+        Loading,
+        Loaded,
+        // The file could not be fetched e.g. it does not exist.
+        CouldNotRead,
+        // The file could be fetched but not decoded.
+        CouldNotDecode,
+        Cancelled
+    };
+
+    explicit kpDocumentLoader (const QUrl &url, QObject *parent = nullptr);
+    // Cancels loading, if it has not finished.
+    ~kpDocumentLoader () override;
+
+    QUrl url () const;
+
+    // The window that any KIO dialogs (e.g. for passwords) should be
+    // parented to.  Set before start().
+    void setWindow (QWidget *window);
+
+    // Calls <func> once loading has really stopped: just before finished()
+    // is emitted or, if the loader is destroyed first, once its decoding
+    // thread (if any) has given up.  In the latter case, <func> is called
+    // later, from the main thread's event loop.  Set before start().
+    void setStoppedFunction (const std::function <void ()> &func);
+
+    // Starts loading.  finished() is always emitted, after start() returns.
+    void start ();
+
+    Status status () const;
+
+    // Valid once finished() has been emitted with status() == Loaded.
+    // The image is Format_ARGB32_Premultiplied.
+    kpImage image () const;
+    kpDocumentSaveOptions saveOptions () const;
+    kpDocumentMetaInfo metaInfo () const;
+
+public slots:
+    // Stops loading as soon as possible.  finished() will still be emitted,
+    // with status() == Cancelled.
+    void cancel ();
+
+signals:
+    // <percent> is 0-100.
+    void progress (int percent);
+
+    // <preview> is a downscaled version of the image, for showing while the
+    // rest is decoded.  Not emitted for formats that cannot produce it
+    // faster than the full image.
+    void previewReady (const QImage &preview);
+
+    void finished ();
+
+private:
+    typedef std::function <kpDocumentLoader::Status (kpDocumentLoaderShared *shared,
+        kpImage *image,
+        kpDocumentSaveOptions *saveOptions,
+        kpDocumentMetaInfo *metaInfo)> DecodeFunction;
+
+    void fetched ();
+    // Runs <decode> on a worker thread and then calls decoded().
+    void startDecoding (const DecodeFunction &decode);
+    void decoded (kpDocumentLoader::Status status, const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo);
+    void finish (kpDocumentLoader::Status status);
+
+    kpDocumentLoaderPrivate * const d;
+};
+
+
+#endif  // KP_DOCUMENT_LOADER_H
@@ -30,17 +30,43 @@
 #define kpDocumentPrivate_H
 
 
+#include "imagelib/kpImageOpacityMap.h"
+#include "imagelib/kpImagePyramid.h"
+
+
 class kpDocumentEnvironment;
+class kpDocumentSaver;
 
 
 struct kpDocumentPrivate
 {
     kpDocumentPrivate ()
-      : environ(nullptr)
+      : environ(nullptr),
+        saver(nullptr),
+        modificationCount(0),
+        saveModificationCount(0),
+        lastSaveSucceeded(true)
     {
     }
 
     kpDocumentEnvironment *environ;
+
+    // The save in progress, if any.
+    kpDocumentSaver *saver;
+
+    // Bumped by every setModified(true), so that a save that finishes
+    // after the document has been edited again can tell that it didn't
+    // save those edits.
+    //
+    // sync: kpDocument::setModified(), saveAs(), saveFinished()
+    int modificationCount;
+    int saveModificationCount;
+
+    bool lastSaveSucceeded;
+
+    // sync: kpDocument::slotContentsChanged(), slotSizeChanged(), open()
+    kpImagePyramid mipmaps;
+    kpImageOpacityMap opacityMap;
 };
 
 
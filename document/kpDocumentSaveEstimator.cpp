@@ -0,0 +1,431 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#define DEBUG_KP_DOCUMENT_SAVE_ESTIMATOR 0
+
+
+#include "kpDocumentSaveEstimator.h"
+
+#include <functional>
+
+#include <QBuffer>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QSize>
+#include <QThreadPool>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+#include "document/kpDocumentSaveOptions.h"
+#include "imagelib/kpDocumentMetaInfo.h"
+#include "pixmapfx/kpPixmapFX.h"
+
+//---------------------------------------------------------------------
+
+// Images with more pixels than this get a quick estimate from a sample
+// before being encoded whole.
+static const qint64 SampleThreshold = 1024 * 1024;
+
+// The sample is SampleTilesPerSide x SampleTilesPerSide tiles, each
+// SampleTileSize x SampleTileSize, spread evenly across the image.
+static const int SampleTilesPerSide = 6;
+static const int SampleTileSize = 64;
+
+//---------------------------------------------------------------------
+
+// State shared between a kpDocumentSaveEstimator and its estimating
+// thread, which may still be running after the estimator has been
+// destroyed.
+struct kpDocumentSaveEstimatorShared
+{
+    // Bumped by every estimate() and cancel().  An estimating thread gives
+    // up as soon as this no longer matches the value it was started with.
+    QAtomicInt generation;
+
+    // Guards <estimator>, which is cleared when the estimator is
+    // destroyed.
+    QMutex mutex;
+    kpDocumentSaveEstimator *estimator = nullptr;
+
+    bool isStale (int forGeneration) const
+    {
+        return (generation.loadAcquire () != forGeneration);
+    }
+
+    // Emits estimated() on the estimator's thread, unless the estimate
+    // for <forGeneration> has gone stale by then.
+    void post (int forGeneration,
+               const QImage &preview, qint64 fileSize, bool isExact)
+    {
+        QMutexLocker locker (&mutex);
+        if (!estimator) {
+            return;
+        }
+
+        // (<this> lives as long as the estimator, and Qt drops the call
+        //  if the estimator is destroyed before it is delivered)
+        kpDocumentSaveEstimator *target = estimator;
+        QMetaObject::invokeMethod (target,
+            [this, target, forGeneration, preview, fileSize, isExact]
+            {
+                if (!isStale (forGeneration)) {
+                    emit target->estimated (preview, fileSize, isExact);
+                }
+            },
+            Qt::QueuedConnection);
+    }
+};
+
+//---------------------------------------------------------------------
+
+// The QIODevice that images are saved to.
+//
+// It fails writes once the estimate has gone stale, which makes the
+// encoder give up.
+class kpDocumentSaveEstimatorDevice : public QBuffer
+{
+public:
+    kpDocumentSaveEstimatorDevice (QByteArray *data,
+            const kpDocumentSaveEstimatorShared *shared, int generation)
+        : QBuffer (data),
+          m_shared (shared),
+          m_generation (generation)
+    {
+    }
+
+protected:
+    qint64 writeData (const char *data, qint64 len) override
+    {
+        if (m_shared->isStale (m_generation)) {
+            return -1;
+        }
+
+        return QBuffer::writeData (data, len);
+    }
+
+private:
+    const kpDocumentSaveEstimatorShared * const m_shared;
+    const int m_generation;
+};
+
+//---------------------------------------------------------------------
+
+class kpDocumentSaveEstimatorTask : public QRunnable
+{
+public:
+    explicit kpDocumentSaveEstimatorTask (const std::function <void ()> &func)
+        : m_func (func)
+    {
+    }
+
+    void run () override
+    {
+        m_func ();
+    }
+
+private:
+    const std::function <void ()> m_func;
+};
+
+//---------------------------------------------------------------------
+
+// Saves <image> into <data>.  Returns the file size or -1 if it could not
+// be saved (or the estimate went stale).
+static qint64 Encode (const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo,
+        const kpDocumentSaveEstimatorShared *shared, int generation,
+        QByteArray *data)
+{
+    data->clear ();
+
+    kpDocumentSaveEstimatorDevice device (data, shared, generation);
+    device.open (QIODevice::WriteOnly);
+    const bool savedOK = kpDocument::savePixmapToDevice (image, &device,
+        saveOptions, metaInfo,
+        false/*no lossy prompt*/,
+        nullptr/*no dialogs off the GUI thread*/);
+    device.close ();
+
+    return savedOK ? data->size () : -1;
+}
+
+//---------------------------------------------------------------------
+
+// Returns the size that an image of <size> is shown at in a preview of
+// <previewSize>.  Images are only ever shrunk.
+static QSize PreviewImageSize (const QSize &size, const QSize &previewSize)
+{
+    if (size.width () <= previewSize.width () &&
+        size.height () <= previewSize.height ())
+    {
+        return size;
+    }
+
+    return size.scaled (previewSize, Qt::KeepAspectRatio).expandedTo (QSize (1, 1));
+}
+
+//---------------------------------------------------------------------
+
+// Loads the file <data>, of an image of <fullSize>, for the preview.
+//
+// Formats that can (e.g. JPEG) decode directly at the preview size,
+// which is much quicker than decoding the whole image.
+static QImage DecodePreview (const QByteArray &data,
+        const QSize &fullSize, const QSize &previewSize)
+{
+    const QSize size = ::PreviewImageSize (fullSize, previewSize);
+
+    QBuffer buffer;
+    buffer.setData (data);
+    buffer.open (QIODevice::ReadOnly);
+
+    QImageReader reader (&buffer);
+    if (size != fullSize && reader.supportsOption (QImageIOHandler::ScaledSize)) {
+        reader.setScaledSize (size);
+    }
+
+    QImage image = reader.read ();
+    if (!image.isNull () && image.size () != size) {
+        image = kpPixmapFX::scale (image, size.width (), size.height ());
+    }
+
+    return image;
+}
+
+//---------------------------------------------------------------------
+
+// Returns a mosaic of tiles taken from across <image>, which compresses
+// about as well as the whole image.
+static kpImage SampleTiles (const kpImage &image)
+{
+    const int tileWidth = qBound (1, image.width () / SampleTilesPerSide, SampleTileSize);
+    const int tileHeight = qBound (1, image.height () / SampleTilesPerSide, SampleTileSize);
+
+    kpImage mosaic (tileWidth * SampleTilesPerSide, tileHeight * SampleTilesPerSide,
+        image.format ());
+    if (mosaic.isNull ()) {
+        return mosaic;
+    }
+
+    QPainter painter (&mosaic);
+    painter.setCompositionMode (QPainter::CompositionMode_Source);
+
+    for (int ty = 0; ty < SampleTilesPerSide; ty++)
+    {
+        const int srcY = (image.height () - tileHeight) * ty / (SampleTilesPerSide - 1);
+        for (int tx = 0; tx < SampleTilesPerSide; tx++)
+        {
+            const int srcX = (image.width () - tileWidth) * tx / (SampleTilesPerSide - 1);
+            painter.drawImage (QPoint (tx * tileWidth, ty * tileHeight),
+                image, QRect (srcX, srcY, tileWidth, tileHeight));
+        }
+    }
+
+    painter.end ();
+    return mosaic;
+}
+
+//---------------------------------------------------------------------
+
+// Extrapolates the file size of <image> from that of SampleTiles().
+// Returns -1 if it could not be saved (or the estimate went stale).
+static qint64 EstimateFromSample (const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo,
+        const kpDocumentSaveEstimatorShared *shared, int generation)
+{
+    const kpImage mosaic = ::SampleTiles (image);
+    if (mosaic.isNull ()) {
+        return -1;
+    }
+
+    QByteArray data;
+
+    // The fixed cost of the headers, palette and meta info, which does not
+    // grow with the number of pixels.
+    const qint64 overhead = ::Encode (image.copy (0, 0, 1, 1),
+        saveOptions, metaInfo, shared, generation, &data);
+    if (overhead < 0) {
+        return -1;
+    }
+
+    const qint64 mosaicSize = ::Encode (mosaic,
+        saveOptions, metaInfo, shared, generation, &data);
+    if (mosaicSize < 0) {
+        return -1;
+    }
+
+    const double pixelsPerMosaic =
+        double (image.width ()) * image.height () /
+        (double (mosaic.width ()) * mosaic.height ());
+    return overhead +
+        qMax (qint64 (0), qint64 ((mosaicSize - overhead) * pixelsPerMosaic));
+}
+
+//---------------------------------------------------------------------
+
+// Runs on a worker thread.
+static void Estimate (const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo,
+        const QSize &previewSize,
+        kpDocumentSaveEstimatorShared *shared, int generation)
+{
+    QByteArray data;
+
+    if (qint64 (image.width ()) * image.height () > SampleThreshold)
+    {
+        // The preview is of the image shrunk to the preview size, then
+        // saved and loaded.  This is inexact for lossy formats but shows
+        // the gist of it.
+        const QSize smallSize = ::PreviewImageSize (image.size (), previewSize);
+        const kpImage small = kpPixmapFX::scale (image,
+            smallSize.width (), smallSize.height ());
+
+        const qint64 fileSize = ::EstimateFromSample (image, saveOptions, metaInfo,
+            shared, generation);
+        if (shared->isStale (generation)) {
+            return;
+        }
+
+        const qint64 smallFileSize = ::Encode (small, saveOptions, metaInfo,
+            shared, generation, &data);
+        if (shared->isStale (generation)) {
+            return;
+        }
+
+        if (fileSize < 0 || smallFileSize < 0)
+        {
+            // (saving the whole image will fail too)
+            shared->post (generation, QImage (), 0, true/*exact*/);
+            return;
+        }
+
+    #if DEBUG_KP_DOCUMENT_SAVE_ESTIMATOR
+        qCDebug(kpLogDocument) << "kpDocumentSaveEstimator: estimated" << fileSize;
+    #endif
+        shared->post (generation,
+            ::DecodePreview (data, smallSize, previewSize), fileSize, false/*estimate*/);
+    }
+
+    const qint64 fileSize = ::Encode (image, saveOptions, metaInfo,
+        shared, generation, &data);
+    if (shared->isStale (generation)) {
+        return;
+    }
+
+#if DEBUG_KP_DOCUMENT_SAVE_ESTIMATOR
+    qCDebug(kpLogDocument) << "kpDocumentSaveEstimator: exact" << fileSize;
+#endif
+
+    if (fileSize < 0)
+    {
+        shared->post (generation, QImage (), 0, true/*exact*/);
+        return;
+    }
+
+    shared->post (generation,
+        ::DecodePreview (data, image.size (), previewSize), fileSize, true/*exact*/);
+}
+
+//---------------------------------------------------------------------
+
+struct kpDocumentSaveEstimatorPrivate
+{
+    QSharedPointer <kpDocumentSaveEstimatorShared> shared;
+};
+
+//---------------------------------------------------------------------
+
+kpDocumentSaveEstimator::kpDocumentSaveEstimator (QObject *parent)
+    : QObject (parent),
+      d (new kpDocumentSaveEstimatorPrivate ())
+{
+    d->shared = QSharedPointer <kpDocumentSaveEstimatorShared>::create ();
+    d->shared->estimator = this;
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentSaveEstimator::~kpDocumentSaveEstimator ()
+{
+    cancel ();
+
+    {
+        QMutexLocker locker (&d->shared->mutex);
+        d->shared->estimator = nullptr;
+    }
+
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaveEstimator::estimate (const kpImage &image,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo,
+        const QSize &previewSize)
+{
+    const int generation = d->shared->generation.fetchAndAddOrdered (1) + 1;
+
+#if DEBUG_KP_DOCUMENT_SAVE_ESTIMATOR
+    qCDebug(kpLogDocument) << "kpDocumentSaveEstimator::estimate() generation=" << generation
+                           << "image=" << image.size () << "previewSize=" << previewSize;
+#endif
+
+    const QSharedPointer <kpDocumentSaveEstimatorShared> shared = d->shared;
+    QThreadPool::globalInstance ()->start (new kpDocumentSaveEstimatorTask (
+        [image, saveOptions, metaInfo, previewSize, shared, generation] ()
+        {
+            // (the estimate may have been superseded before it even started)
+            if (!shared->isStale (generation))
+            {
+                ::Estimate (image, saveOptions, metaInfo, previewSize,
+                    shared.data (), generation);
+            }
+        }));
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpDocumentSaveEstimator::cancel ()
+{
+    d->shared->generation.fetchAndAddOrdered (1);
+}
+
+//---------------------------------------------------------------------
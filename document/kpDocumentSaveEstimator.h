@@ -0,0 +1,89 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_DOCUMENT_SAVE_ESTIMATOR_H
+#define KP_DOCUMENT_SAVE_ESTIMATOR_H
+
+
+#include <QObject>
+
+#include "imagelib/kpImage.h"
+
+
+class QSize;
+
+class kpDocumentMetaInfo;
+class kpDocumentSaveOptions;
+
+struct kpDocumentSaveEstimatorPrivate;
+
+
+//
+// Works out how big an image would be if saved with some save options,
+// and what it would look like, on a QThreadPool::globalInstance() thread.
+//
+// For large images, a quick estimate is first extrapolated from encoding
+// a sample of tiles spread across the image.  The whole image is then
+// encoded for the exact size.  Starting a new estimate abandons the
+// current one, even in the middle of encoding.
+//
+class kpDocumentSaveEstimator : public QObject
+{
+Q_OBJECT
+
+public:
+    explicit kpDocumentSaveEstimator (QObject *parent = nullptr);
+    ~kpDocumentSaveEstimator () override;
+
+    // Starts estimating the file size of <image> saved with <saveOptions>
+    // and <metaInfo>, along with a preview of it that fits inside
+    // <previewSize>.
+    void estimate (const kpImage &image,
+                   const kpDocumentSaveOptions &saveOptions,
+                   const kpDocumentMetaInfo &metaInfo,
+                   const QSize &previewSize);
+
+public slots:
+    // Abandons the current estimate, if any.
+    void cancel ();
+
+signals:
+    // Emitted once, or for large images, twice: first with an
+    // extrapolated <fileSize> and <isExact> false.
+    //
+    // <preview> is the image, after saving and loading, scaled down to
+    // fit the preview size.  It is null if the image could not be saved,
+    // in which case <fileSize> is 0.
+    void estimated (const QImage &preview, qint64 fileSize, bool isExact);
+
+private:
+    kpDocumentSaveEstimatorPrivate * const d;
+};
+
+
+#endif  // KP_DOCUMENT_SAVE_ESTIMATOR_H
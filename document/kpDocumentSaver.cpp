@@ -0,0 +1,383 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#define DEBUG_KP_DOCUMENT_SAVER 0
+
+
+#include "kpDocumentSaver.h"
+
+#include <functional>
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSharedPointer>
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <QUrl>
+
+#include <KIO/FileCopyJob>
+#include <KJobWidgets>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+#include "document/kpDocumentSaveOptions.h"
+#include "imagelib/kpDocumentMetaInfo.h"
+
+//---------------------------------------------------------------------
+
+// State shared between a kpDocumentSaver and its encoding thread, which
+// may still be running after the saver has been destroyed.
+struct kpDocumentSaverShared
+{
+    // Guards <saver>, which is cleared when the saver is destroyed.
+    QMutex mutex;
+    kpDocumentSaver *saver = nullptr;
+
+    // Calls <func> on the saver's thread.  Returns false if the saver has
+    // already gone.
+    bool post (const std::function <void (kpDocumentSaver *)> &func)
+    {
+        QMutexLocker locker (&mutex);
+        if (!saver) {
+            return false;
+        }
+
+        kpDocumentSaver *target = saver;
+        QMetaObject::invokeMethod (target, [target, func] { func (target); },
+            Qt::QueuedConnection);
+        return true;
+    }
+};
+
+//---------------------------------------------------------------------
+
+class kpDocumentSaverTask : public QRunnable
+{
+public:
+    explicit kpDocumentSaverTask (const std::function <void ()> &func)
+        : m_func (func)
+    {
+    }
+
+    void run () override
+    {
+        m_func ();
+    }
+
+private:
+    const std::function <void ()> m_func;
+};
+
+//---------------------------------------------------------------------
+
+// Encodes <image> on a worker thread.
+//
+// A local <url> is written to directly.  For a remote <url>, the image is
+// written to a local temporary file, whose name is returned in
+// <tempFileName>, for the caller to upload and then delete.
+static kpDocumentSaver::Status Encode (const kpImage &image,
+        const QUrl &url,
+        const kpDocumentSaveOptions &saveOptions,
+        const kpDocumentMetaInfo &metaInfo,
+        QString *errorString,
+        QString *tempFileName)
+{
+    // Local file?
+    if (url.isLocalFile ())
+    {
+        // sync: All failure exit paths _must_ call QSaveFile::cancelWriting() or
+        //       else, the QSaveFile destructor will overwrite the file
+        //       despite the failure.
+        QSaveFile atomicFileWriter (url.toLocalFile ());
+        if (!atomicFileWriter.open (QIODevice::WriteOnly))
+        {
+            atomicFileWriter.cancelWriting ();
+            return kpDocumentSaver::CouldNotCreateTemporaryFile;
+        }
+
+        if (!kpDocument::savePixmapToDevice (image, &atomicFileWriter,
+                                             saveOptions, metaInfo,
+                                             false/*no lossy prompt*/,
+                                             nullptr/*no dialogs off the GUI thread*/))
+        {
+            atomicFileWriter.cancelWriting ();
+            return kpDocumentSaver::CouldNotEncode;
+        }
+
+        // Atomically overwrite the local file with the temporary file
+        // we saved to.
+        if (!atomicFileWriter.commit ())
+        {
+            *errorString = atomicFileWriter.errorString ();
+            atomicFileWriter.cancelWriting ();
+            return kpDocumentSaver::CouldNotWrite;
+        }
+
+        return kpDocumentSaver::Saved;
+    }
+
+    // Remote file.
+    //
+    // (the temporary file must outlive this function, for the upload)
+    QTemporaryFile tempFile;
+    tempFile.setAutoRemove (false);
+    if (!tempFile.open ()) {
+        return kpDocumentSaver::CouldNotCreateTemporaryFile;
+    }
+
+    if (!kpDocument::savePixmapToDevice (image, &tempFile,
+                                         saveOptions, metaInfo,
+                                         false/*no lossy prompt*/,
+                                         nullptr/*no dialogs off the GUI thread*/))
+    {
+        tempFile.remove ();
+        return kpDocumentSaver::CouldNotEncode;
+    }
+
+    // Collect name of temporary file now, as QTemporaryFile::fileName()
+    // stops working after close() is called.
+    *tempFileName = tempFile.fileName ();
+    Q_ASSERT (!tempFileName->isEmpty ());
+
+    tempFile.close ();
+    if (tempFile.error () != QFile::NoError)
+    {
+        *errorString = tempFile.errorString ();
+        QFile::remove (*tempFileName);
+        tempFileName->clear ();
+        return kpDocumentSaver::CouldNotWrite;
+    }
+
+    return kpDocumentSaver::Saved;
+}
+
+//---------------------------------------------------------------------
+
+struct kpDocumentSaverPrivate
+{
+    kpImage image;
+    QUrl url;
+    kpDocumentSaveOptions saveOptions;
+    kpDocumentMetaInfo metaInfo;
+
+    QWidget *window = nullptr;
+
+    kpDocumentSaver::Status status = kpDocumentSaver::Saving;
+    QString errorString;
+
+    QSharedPointer <kpDocumentSaverShared> shared;
+
+    // The upload of <tempFileName>, for a remote url.
+    KIO::FileCopyJob *job = nullptr;
+    QString tempFileName;
+};
+
+//---------------------------------------------------------------------
+
+kpDocumentSaver::kpDocumentSaver (const kpImage &image,
+                                  const QUrl &url,
+                                  const kpDocumentSaveOptions &saveOptions,
+                                  const kpDocumentMetaInfo &metaInfo,
+                                  QObject *parent)
+    : QObject (parent),
+      d (new kpDocumentSaverPrivate ())
+{
+    d->image = image;
+    d->url = url;
+    d->saveOptions = saveOptions;
+    d->metaInfo = metaInfo;
+
+    d->shared = QSharedPointer <kpDocumentSaverShared>::create ();
+    d->shared->saver = this;
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentSaver::~kpDocumentSaver ()
+{
+    if (d->job) {
+        d->job->kill (KJob::Quietly);
+    }
+
+    if (!d->tempFileName.isEmpty ()) {
+        QFile::remove (d->tempFileName);
+    }
+
+    {
+        QMutexLocker locker (&d->shared->mutex);
+        d->shared->saver = nullptr;
+    }
+
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QUrl kpDocumentSaver::url () const
+{
+    return d->url;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentSaveOptions kpDocumentSaver::saveOptions () const
+{
+    return d->saveOptions;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaver::setWindow (QWidget *window)
+{
+    d->window = window;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaver::start ()
+{
+#if DEBUG_KP_DOCUMENT_SAVER
+    qCDebug(kpLogDocument) << "kpDocumentSaver::start() url=" << d->url;
+#endif
+
+    Q_ASSERT (d->status == Saving);
+
+    const kpImage image = d->image;
+    const QUrl url = d->url;
+    const kpDocumentSaveOptions saveOptions = d->saveOptions;
+    const kpDocumentMetaInfo metaInfo = d->metaInfo;
+    const QSharedPointer <kpDocumentSaverShared> shared = d->shared;
+
+    // The worker has its own reference to the image now.
+    d->image = kpImage ();
+
+    QThreadPool::globalInstance ()->start (new kpDocumentSaverTask (
+        [image, url, saveOptions, metaInfo, shared] ()
+        {
+            QString errorString, tempFileName;
+            const Status status = ::Encode (image, url, saveOptions, metaInfo,
+                &errorString, &tempFileName);
+
+            const bool posted = shared->post ([=] (kpDocumentSaver *saver) {
+                saver->encoded (status, errorString, tempFileName);
+            });
+            if (!posted && !tempFileName.isEmpty ()) {
+                QFile::remove (tempFileName);
+            }
+        }));
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentSaver::Status kpDocumentSaver::status () const
+{
+    return d->status;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QString kpDocumentSaver::errorString () const
+{
+    return d->errorString;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentSaver::encoded (kpDocumentSaver::Status status,
+        const QString &errorString, const QString &tempFileName)
+{
+    d->tempFileName = tempFileName;
+
+    if (status != Saved || d->tempFileName.isEmpty ())
+    {
+        finish (status, errorString);
+        return;
+    }
+
+    // Copy local temporary file to overwrite remote.
+    // It's the kioslave's job to make this atomic (write to .part, then rename .part file)
+    d->job = KIO::file_copy (QUrl::fromLocalFile (d->tempFileName),
+                             d->url,
+                             -1,
+                             KIO::Overwrite);
+    KJobWidgets::setWindow (d->job, d->window);
+    connect (d->job, &KJob::result, this, &kpDocumentSaver::uploaded);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentSaver::uploaded ()
+{
+    KIO::FileCopyJob *job = d->job;
+    d->job = nullptr;
+
+    QFile::remove (d->tempFileName);
+    d->tempFileName.clear ();
+
+    if (job->error ())
+    {
+    #if DEBUG_KP_DOCUMENT_SAVER
+        qCDebug(kpLogDocument) << "kpDocumentSaver::uploaded() error=" << job->errorString ();
+    #endif
+        finish (CouldNotUpload);
+        return;
+    }
+
+    finish (Saved);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentSaver::finish (kpDocumentSaver::Status status, const QString &errorString)
+{
+#if DEBUG_KP_DOCUMENT_SAVER
+    qCDebug(kpLogDocument) << "kpDocumentSaver::finish(" << status << ") url=" << d->url
+                           << "errorString=" << errorString;
+#endif
+
+    d->status = status;
+    d->errorString = errorString;
+    emit finished ();
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,115 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_DOCUMENT_SAVER_H
+#define KP_DOCUMENT_SAVER_H
+
+
+#include <QObject>
+
+#include "imagelib/kpImage.h"
+
+
+class QString;
+class QUrl;
+class QWidget;
+
+class kpDocumentMetaInfo;
+class kpDocumentSaveOptions;
+
+struct kpDocumentSaverPrivate;
+
+
+//
+// Encodes and writes an image file without blocking the event loop.
+//
+// The image is encoded on a QThreadPool::globalInstance() thread.  Local
+// files are written atomically with QSaveFile.  Remote files are encoded
+// into a local temporary file, which is then uploaded asynchronously with
+// KIO.
+//
+// The image is implicitly shared, so it costs nothing to pass the
+// document's image and the document can go on being edited while this
+// works on the snapshot.
+//
+// Use kpDocument::save() or saveAs() unless you need the signals.
+//
+class kpDocumentSaver : public QObject
+{
+Q_OBJECT
+
+public:
+    enum Status
+    {
+        Saving,
+        Saved,
+        CouldNotCreateTemporaryFile,
+        // The image could not be encoded in the requested format.
+        CouldNotEncode,
+        // The encoded file could not be written out.  See errorString().
+        CouldNotWrite,
+        CouldNotUpload
+    };
+
+    kpDocumentSaver (const kpImage &image,
+                     const QUrl &url,
+                     const kpDocumentSaveOptions &saveOptions,
+                     const kpDocumentMetaInfo &metaInfo,
+                     QObject *parent = nullptr);
+    // Abandons any upload that has not finished.  A local file that is
+    // already being encoded is still written.
+    ~kpDocumentSaver () override;
+
+    QUrl url () const;
+    kpDocumentSaveOptions saveOptions () const;
+
+    // The window that any KIO dialogs should be parented to.  Set before
+    // start().
+    void setWindow (QWidget *window);
+
+    // Starts saving.  finished() is always emitted, after start() returns.
+    void start ();
+
+    Status status () const;
+    // Valid once finished() has been emitted with status() == CouldNotWrite.
+    QString errorString () const;
+
+signals:
+    void finished ();
+
+private:
+    void encoded (kpDocumentSaver::Status status, const QString &errorString,
+        const QString &tempFileName);
+    void uploaded ();
+    void finish (kpDocumentSaver::Status status, const QString &errorString = QString ());
+
+    kpDocumentSaverPrivate * const d;
+};
+
+
+#endif  // KP_DOCUMENT_SAVER_H
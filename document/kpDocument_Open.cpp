@@ -35,6 +35,7 @@
 #include "widgets/toolbars/kpColorToolBar.h"
 #include "kpDefs.h"
 #include "environments/document/kpDocumentEnvironment.h"
+#include "document/kpDocumentLoader.h"
 #include "document/kpDocumentSaveOptions.h"
 #include "imagelib/kpDocumentMetaInfo.h"
 #include "imagelib/effects/kpEffectReduceColors.h"
@@ -45,15 +46,16 @@
 
 
 #include <QColor>
+#include <QEventLoop>
 #include <QImage>
+#include <QLabel>
 #include <QMimeDatabase>
-#include <QImageReader>
-#include <QBuffer>
+#include <QPixmap>
+#include <QProgressDialog>
+#include <QTimer>
 
-#include <KJobWidgets>
 #include "kpLogCategories.h"
 #include <KLocalizedString>
-#include <KIO/StoredTransferJob>
 #include <KMessageBox>
 
 //---------------------------------------------------------------------
@@ -99,71 +101,135 @@ QImage kpDocument::getPixmapFromFile(const QUrl &url, bool suppressDoesntExistDi
         return {};
     }
 
-    KIO::StoredTransferJob *job = KIO::storedGet (url);
-    KJobWidgets::setWindow(job, parent);
-
-    if (!job->exec())
+    kpDocumentLoader loader (url);
+    loader.setWindow (parent);
+
+    // Loading big images can take a while, so it happens in the background
+    // while the event loop keeps running.  If it does not finish quickly
+    // (or as soon as there is a preview to show), a progress dialog comes
+    // up that lets the user cancel.
+    QProgressDialog progressDialog (parent);
+    progressDialog.setWindowTitle (i18nc ("@title:window", "Opening"));
+    progressDialog.setLabelText (i18n ("Opening \"%1\"...",
+                                       kpUrlFormatter::PrettyFilename (url)));
+    // Not just WindowModal: the event loop below runs with user input
+    // enabled, and other main windows must not be able to e.g. open, save,
+    // close or quit while <parent> (which owns the dialog) is waiting on us.
+    progressDialog.setWindowModality (Qt::ApplicationModal);
+    progressDialog.setAutoClose (false);
+    progressDialog.setAutoReset (false);
+    progressDialog.setRange (0, 100);
+    progressDialog.setValue (0);
+
+    QEventLoop eventLoop;
+
+    QTimer showProgressTimer;
+    showProgressTimer.setSingleShot (true);
+    QObject::connect (&showProgressTimer, &QTimer::timeout,
+                      &eventLoop, &QEventLoop::quit);
+
+    QObject::connect (&loader, &kpDocumentLoader::progress,
+                      &progressDialog, &QProgressDialog::setValue);
+    QObject::connect (&loader, &kpDocumentLoader::previewReady,
+        &progressDialog, [&progressDialog, &eventLoop] (const QImage &preview) {
+            auto *previewLabel = new QLabel ();
+            previewLabel->setAlignment (Qt::AlignCenter);
+            previewLabel->setPixmap (QPixmap::fromImage (
+                preview.scaled (256, 256, Qt::KeepAspectRatio, Qt::SmoothTransformation)));
+            progressDialog.setLabel (previewLabel);
+
+            eventLoop.quit ();
+        });
+    QObject::connect (&progressDialog, &QProgressDialog::canceled,
+                      &loader, &kpDocumentLoader::cancel);
+    QObject::connect (&loader, &kpDocumentLoader::finished,
+                      &eventLoop, &QEventLoop::quit);
+
+    loader.start ();
+
+    // Until the (application modal) progress dialog is up, ignore user
+    // input, which could otherwise e.g. close the window we are loading for.
+    showProgressTimer.start (500/*ms*/);
+    eventLoop.exec (QEventLoop::ExcludeUserInputEvents);
+    showProgressTimer.stop ();
+
+    if (loader.status () == kpDocumentLoader::Loading)
     {
-        if (!suppressDoesntExistDialog)
-        {
-            // TODO: Use "Cannot" instead of "Could not" in all dialogs in KolourPaint.
-            //       Or at least choose one consistently.
-            //
-            // TODO: Have captions for all dialogs in KolourPaint.
-            KMessageBox::sorry (parent,
-                                i18n ("Could not open \"%1\".",
-                                      kpUrlFormatter::PrettyFilename (url)));
-        }
+        progressDialog.show ();
 
-        return {};
+        // (a late preview also quits the event loop)
+        while (loader.status () == kpDocumentLoader::Loading) {
+            eventLoop.exec ();
+        }
     }
-    QByteArray data = job->data();
 
-    QMimeDatabase db;
-    QMimeType mimeType = db.mimeTypeForFileNameAndData(url.fileName(), data);
+    progressDialog.hide ();
 
-    if (saveOptions) {
-        saveOptions->setMimeType(mimeType.name());
-    }
+    return kpDocument::getPixmapFromLoader (loader, suppressDoesntExistDialog, parent,
+        saveOptions, metaInfo);
+}
 
-#if DEBUG_KP_DOCUMENT
-    qCDebug(kpLogDocument) << "\tmimetype=" << mimeType.name();
-    qCDebug(kpLogDocument) << "\tsrc=" << url.path ();
-#endif
+//---------------------------------------------------------------------
+
+// public static
+QImage kpDocument::getPixmapFromLoader (const kpDocumentLoader &loader,
+                                       bool suppressDoesntExistDialog,
+                                       QWidget *parent,
+                                       kpDocumentSaveOptions *saveOptions,
+                                       kpDocumentMetaInfo *metaInfo)
+{
+    const QUrl url = loader.url ();
 
-    QBuffer buffer(&data);
-    buffer.open(QIODevice::ReadOnly);
-    QImageReader reader(&buffer);
-    reader.setAutoTransform(true);
-    reader.setDecideFormatFromContent(true);
+    if (saveOptions) {
+        *saveOptions = kpDocumentSaveOptions ();
+    }
 
-    QImage image = reader.read();
+    if (metaInfo) {
+        *metaInfo = kpDocumentMetaInfo ();
+    }
 
-    if (image.isNull ())
+    switch (loader.status ())
     {
+    case kpDocumentLoader::Loaded:
+        break;
+
+    case kpDocumentLoader::CouldNotDecode:
         KMessageBox::sorry (parent,
                             i18n ("Could not open \"%1\" - unsupported image format.\n"
                                   "The file may be corrupt.",
                                   kpUrlFormatter::PrettyFilename (url)));
         return {};
+
+    case kpDocumentLoader::CouldNotRead:
+        if (!suppressDoesntExistDialog)
+        {
+            // TODO: Use "Cannot" instead of "Could not" in all dialogs in KolourPaint.
+            //       Or at least choose one consistently.
+            //
+            // TODO: Have captions for all dialogs in KolourPaint.
+            KMessageBox::sorry (parent,
+                                i18n ("Could not open \"%1\".",
+                                      kpUrlFormatter::PrettyFilename (url)));
+        }
+        return {};
+
+    default:
+        return {};
     }
 
 #if DEBUG_KP_DOCUMENT
-    qCDebug(kpLogDocument) << "\tpixmap: depth=" << image.depth ()
-                << " hasAlphaChannel=" << image.hasAlphaChannel ();
+    qCDebug(kpLogDocument) << "\tmimetype=" << loader.saveOptions ().mimeType ();
 #endif
 
-    if ( saveOptions && metaInfo ) {
-        getDataFromImage(image, *saveOptions, *metaInfo);
+    if (saveOptions) {
+        *saveOptions = loader.saveOptions ();
     }
 
-    // make sure we always have Format_ARGB32_Premultiplied as this is the fastest to draw on
-    // and Qt can not draw onto Format_Indexed8 (Qt-4.7)
-    if ( image.format() != QImage::Format_ARGB32_Premultiplied ) {
-      image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (metaInfo) {
+        *metaInfo = loader.metaInfo ();
     }
 
-    return image;
+    return loader.image ();
 }
 
 //---------------------------------------------------------------------
@@ -175,6 +241,8 @@ void kpDocument::openNew (const QUrl &url)
 #endif
 
     m_image->fill(QColor(Qt::white).rgb());
+    d->mipmaps.clear ();
+    d->opacityMap.clear ();
 
     setURL (url, false/*not from url*/);
 
@@ -214,10 +282,44 @@ bool kpDocument::open (const QUrl &url, bool newDocSameNameIfNotExist)
         &newSaveOptions,
         &newMetaInfo);
 
+    return openImage (url, newPixmap, newSaveOptions, newMetaInfo,
+        newDocSameNameIfNotExist);
+}
+
+//---------------------------------------------------------------------
+
+bool kpDocument::open (const kpDocumentLoader &loader, bool newDocSameNameIfNotExist)
+{
+#if DEBUG_KP_DOCUMENT
+    qCDebug(kpLogDocument) << "kpDocument::open (loader url=" << loader.url () << ")";
+#endif
+
+    kpDocumentSaveOptions newSaveOptions;
+    kpDocumentMetaInfo newMetaInfo;
+    QImage newPixmap = kpDocument::getPixmapFromLoader (loader,
+        newDocSameNameIfNotExist/*suppress "doesn't exist" dialog*/,
+        d->environ->dialogParent (),
+        &newSaveOptions,
+        &newMetaInfo);
+
+    return openImage (loader.url (), newPixmap, newSaveOptions, newMetaInfo,
+        newDocSameNameIfNotExist);
+}
+
+//---------------------------------------------------------------------
+
+// private
+bool kpDocument::openImage (const QUrl &url, const QImage &newPixmap,
+                            const kpDocumentSaveOptions &newSaveOptions,
+                            const kpDocumentMetaInfo &newMetaInfo,
+                            bool newDocSameNameIfNotExist)
+{
     if (!newPixmap.isNull ())
     {
         delete m_image;
         m_image = new kpImage (newPixmap);
+        d->mipmaps.clear ();
+        d->opacityMap.clear ();
 
         setURL (url, true/*is from url*/);
         *m_saveOptions = newSaveOptions;
@@ -35,6 +35,7 @@
 #include <QColor>
 #include <QBitmap>
 #include <QBrush>
+#include <QEventLoop>
 #include <QFile>
 #include <QImage>
 #include <QList>
@@ -57,12 +58,14 @@
 #include "kpDefs.h"
 #include "environments/document/kpDocumentEnvironment.h"
 #include "document/kpDocumentSaveOptions.h"
+#include "document/kpDocumentSaver.h"
 #include "imagelib/kpDocumentMetaInfo.h"
 #include "imagelib/effects/kpEffectReduceColors.h"
 #include "pixmapfx/kpPixmapFX.h"
 #include "tools/kpTool.h"
 #include "widgets/toolbars/kpToolToolBar.h"
 #include "lgpl/generic/kpUrlFormatter.h"
+#include "generic/kpSetOverrideCursorSaver.h"
 #include "views/manager/kpViewManager.h"
 
 
@@ -75,6 +78,9 @@ bool kpDocument::save (bool lossyPrompt)
                << " savedAtLeastOnceBefore=" << savedAtLeastOnceBefore ();
 #endif
 
+    // (a save in progress may change the url and save options)
+    waitForSave ();
+
     // TODO: check feels weak
     if (m_url.isEmpty () || m_saveOptions->mimeType ().isEmpty ())
     {
@@ -452,23 +458,128 @@ bool kpDocument::saveAs (const QUrl &url,
                << saveOptions.mimeType () << ")" << endl;
 #endif
 
-    if (kpDocument::savePixmapToFile (imageWithSelection (),
-                                      url,
-                                      saveOptions, *metaInfo (),
-                                      lossyPrompt,
-                                      d->environ->dialogParent ()))
+    // Saves finish in the order they were started.
+    waitForSave ();
+
+    // The snapshot: editing the document from now on detaches it from
+    // this, rather than changing what is saved.
+    const kpImage image = imageWithSelection ();
+
+    QWidget *parent = d->environ->dialogParent ();
+    if (lossyPrompt && !lossyPromptContinue (image, saveOptions, parent))
     {
-        setURL (url, true/*is from url*/);
-        *m_saveOptions = saveOptions;
-        m_modified = false;
+    #if DEBUG_KP_DOCUMENT
+        qCDebug(kpLogDocument) << "\treturning false because of lossyPrompt";
+    #endif
+        return false;
+    }
+
+    d->saveModificationCount = d->modificationCount;
+
+    d->saver = new kpDocumentSaver (image, url, saveOptions, *metaInfo (), this);
+    d->saver->setWindow (parent);
+    connect (d->saver, &kpDocumentSaver::finished,
+             this, &kpDocument::saveFinished);
+
+    emit savingChanged (true);
+    emit documentSaving ();
+
+    d->saver->start ();
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocument::isSaving () const
+{
+    return (d->saver != nullptr);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocument::waitForSave ()
+{
+    if (d->saver)
+    {
+    #if DEBUG_KP_DOCUMENT
+        qCDebug(kpLogDocument) << "kpDocument::waitForSave()";
+    #endif
+        kpSetOverrideCursorSaver cursorSaver (Qt::WaitCursor);
 
-        m_savedAtLeastOnceBefore = true;
+        QEventLoop eventLoop;
+        connect (d->saver, &kpDocumentSaver::finished,
+                 &eventLoop, &QEventLoop::quit);
 
-        emit documentSaved ();
-        return true;
+        // (saveFinished() clears <d->saver> before the loop is quit)
+        while (d->saver) {
+            eventLoop.exec (QEventLoop::ExcludeUserInputEvents);
+        }
     }
 
-    return false;
+    return d->lastSaveSucceeded;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocument::saveFinished ()
+{
+    kpDocumentSaver *saver = d->saver;
+    d->saver = nullptr;
+    saver->deleteLater ();
+
+    emit savingChanged (false);
+
+    const QUrl url = saver->url ();
+    QWidget *parent = d->environ->dialogParent ();
+
+#if DEBUG_KP_DOCUMENT
+    qCDebug(kpLogDocument) << "kpDocument::saveFinished() url=" << url
+               << " status=" << saver->status ();
+#endif
+
+    d->lastSaveSucceeded = (saver->status () == kpDocumentSaver::Saved);
+
+    switch (saver->status ())
+    {
+    case kpDocumentSaver::Saved:
+        break;
+
+    case kpDocumentSaver::CouldNotCreateTemporaryFile:
+        ::CouldNotCreateTemporaryFileDialog (parent);
+        return;
+
+    case kpDocumentSaver::CouldNotEncode:
+        ::CouldNotSaveDialog (url, i18n("Error saving image"), parent);
+        return;
+
+    case kpDocumentSaver::CouldNotWrite:
+        ::CouldNotSaveDialog (url, saver->errorString (), parent);
+        return;
+
+    case kpDocumentSaver::CouldNotUpload:
+        KMessageBox::error (parent,
+                            i18n ("Could not save image - failed to upload."));
+        return;
+
+    case kpDocumentSaver::Saving:
+        Q_ASSERT (!"kpDocumentSaver finished while saving");
+        return;
+    }
+
+    setURL (url, true/*is from url*/);
+    *m_saveOptions = saver->saveOptions ();
+
+    // Edits made after the snapshot was taken have not been saved.
+    if (d->modificationCount == d->saveModificationCount) {
+        m_modified = false;
+    }
+
+    m_savedAtLeastOnceBefore = true;
+
+    emit documentSaved ();
 }
 
 //---------------------------------------------------------------------
@@ -0,0 +1,111 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "generic/kpParallel.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVector>
+
+
+// A band of kpParallel::forEachBand() work.
+class kpParallelBand : public QRunnable
+{
+public:
+    kpParallelBand (const std::function <void (int, int)> &func,
+            int begin, int end, QSemaphore *done)
+        : m_func (func), m_begin (begin), m_end (end), m_done (done)
+    {
+        // We may run it ourselves (see forEachBand()) so the pool must
+        // not delete it behind our back.
+        setAutoDelete (false);
+    }
+
+    void run () override
+    {
+        m_func (m_begin, m_end);
+        m_done->release ();
+    }
+
+private:
+    const std::function <void (int, int)> &m_func;
+    const int m_begin, m_end;
+    QSemaphore * const m_done;
+};
+
+//---------------------------------------------------------------------
+
+// public static
+void kpParallel::forEachBand (int count, int minBandSize,
+        const std::function <void (int begin, int end)> &func)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    QThreadPool *pool = QThreadPool::globalInstance ();
+
+    const int maxBands = qMax (1, pool->maxThreadCount ());
+    const int bandCount = qBound (1, count / qMax (1, minBandSize), maxBands);
+    if (bandCount == 1)
+    {
+        func (0, count);
+        return;
+    }
+
+    auto bandStart = [count, bandCount] (int band) {
+        return int (qint64 (count) * band / bandCount);
+    };
+
+    QSemaphore done;
+    QVector <kpParallelBand *> bands;
+    for (int band = 1; band < bandCount; band++)
+    {
+        auto *runnable = new kpParallelBand (func,
+            bandStart (band), bandStart (band + 1), &done);
+        bands.append (runnable);
+        pool->start (runnable);
+    }
+
+    func (0, bandStart (1));
+
+    // Rather than sit idle, run any bands the pool has not got to yet.
+    // This also stops us from deadlocking if we were called from a pool
+    // thread and every other pool thread is busy.
+    for (auto *runnable : bands)
+    {
+        if (pool->tryTake (runnable)) {
+            runnable->run ();
+        }
+    }
+
+    done.acquire (bands.size ());
+    qDeleteAll (bands);
+}
+
+//---------------------------------------------------------------------
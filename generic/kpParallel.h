@@ -0,0 +1,60 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef KP_PARALLEL_H
+#define KP_PARALLEL_H
+
+
+#include <functional>
+
+
+//
+// Splits per-row (or per-tile) image work across QThreadPool::globalInstance().
+//
+// We deliberately avoid QtConcurrent, which would pull in another Qt
+// module just for this.
+//
+class kpParallel
+{
+public:
+    // Calls <func> (begin, end) for consecutive, non-overlapping bands
+    // covering [0, <count>), each band at least <minBandSize> long (except
+    // when <count> itself is smaller).  One band runs on the calling thread
+    // and the rest on the global thread pool.  Returns once every band has
+    // finished.
+    //
+    // <func> must be safe to call concurrently on different bands e.g. it
+    // may only write to the rows of its own band.
+    //
+    // If <count> is too small to be worth splitting, <func> is called once,
+    // directly.
+    static void forEachBand (int count, int minBandSize,
+        const std::function <void (int begin, int end)> &func);
+};
+
+
+#endif  // KP_PARALLEL_H
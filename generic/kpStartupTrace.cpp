@@ -0,0 +1,162 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include "generic/kpStartupTrace.h"
+
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QWidget>
+
+//---------------------------------------------------------------------
+
+static bool Enabled = false;
+static bool QuitWhenInteractive = false;
+
+// Not started until start() (and invalid afterwards, when startup is over).
+static QElapsedTimer Timer;
+static qint64 LastMarkMSecs = 0;
+
+//---------------------------------------------------------------------
+
+static void PrintJson (const QJsonObject &object)
+{
+    const QByteArray line = QJsonDocument (object).toJson (QJsonDocument::Compact);
+    std::fprintf (stderr, "%s\n", line.constData ());
+}
+
+//---------------------------------------------------------------------
+
+// Ends startup on the first paint of the window it is installed on.
+class kpStartupTracePaintWatcher : public QObject
+{
+public:
+    explicit kpStartupTracePaintWatcher (QWidget *window)
+        : QObject (window)
+    {
+        window->installEventFilter (this);
+    }
+
+protected:
+    bool eventFilter (QObject *watched, QEvent *event) override
+    {
+        if (event->type () == QEvent::Paint)
+        {
+            kpStartupTrace::mark ("firstPaint");
+
+            // Only once the events queued behind the paint (e.g. the other
+            // startup windows painting) have been handled, is the user
+            // able to interact.
+            QTimer::singleShot (0, [] {
+                kpStartupTrace::mark ("interactive");
+
+                QJsonObject summary;
+                summary [QLatin1String ("summary")] = true;
+                summary [QLatin1String ("interactiveMs")] = double (Timer.elapsed ());
+                ::PrintJson (summary);
+
+                Timer.invalidate ();
+
+                if (QuitWhenInteractive) {
+                    QCoreApplication::quit ();
+                }
+            });
+
+            watched->removeEventFilter (this);
+            deleteLater ();
+        }
+
+        return false;
+    }
+};
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTrace::start ()
+{
+    const QByteArray value = qgetenv ("KOLOURPAINT_STARTUP_TRACE");
+    Enabled = !value.isEmpty () && value != "0";
+    QuitWhenInteractive = (value == "quit");
+
+    if (Enabled)
+    {
+        Timer.start ();
+        LastMarkMSecs = 0;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpStartupTrace::isEnabled ()
+{
+    return Enabled && Timer.isValid ();
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTrace::mark (const char *phase)
+{
+    if (!kpStartupTrace::isEnabled ()) {
+        return;
+    }
+
+    const qint64 nowMSecs = Timer.elapsed ();
+
+    QJsonObject object;
+    object [QLatin1String ("phase")] = QLatin1String (phase);
+    object [QLatin1String ("ms")] = double (nowMSecs - LastMarkMSecs);
+    object [QLatin1String ("totalMs")] = double (nowMSecs);
+    ::PrintJson (object);
+
+    LastMarkMSecs = nowMSecs;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTrace::finishWhenPainted (QWidget *window)
+{
+    if (!kpStartupTrace::isEnabled () || !window) {
+        return;
+    }
+
+    kpStartupTrace::mark ("show");
+
+    new kpStartupTracePaintWatcher (window);
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,67 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_STARTUP_TRACE_H
+#define KP_STARTUP_TRACE_H
+
+
+class QWidget;
+
+
+//
+// Records how long each phase of startup takes, up to when the first
+// window has painted and KolourPaint is interactive.
+//
+// Tracing is enabled by setting the environment variable
+// KOLOURPAINT_STARTUP_TRACE, which makes the phases be printed on stderr
+// as lines of JSON, ending with a summary that has the total.  If it is
+// set to "quit", KolourPaint also quits as soon as it is interactive,
+// so that a benchmark can start it repeatedly and check the total.
+//
+// When tracing is not enabled, mark() does nothing.
+//
+class kpStartupTrace
+{
+public:
+    // Call first thing in main().
+    static void start ();
+
+    static bool isEnabled ();
+
+    // Records that <phase> has just finished.  <phase> must be a string
+    // literal.
+    static void mark (const char *phase);
+
+    // Call once the startup windows have been shown.  Startup is
+    // considered to be over once <window> has painted and the event loop
+    // has gone idle.
+    static void finishWhenPainted (QWidget *window);
+};
+
+
+#endif  // KP_STARTUP_TRACE_H
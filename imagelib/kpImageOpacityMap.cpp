@@ -0,0 +1,179 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_IMAGE_OPACITY_MAP 0
+
+
+#include "kpImageOpacityMap.h"
+
+#include <QSize>
+#include <QVector>
+
+#include "kpLogCategories.h"
+
+//---------------------------------------------------------------------
+
+// In image pixels.
+static const int TileSize = 64;
+
+enum kpTileOpacity
+{
+    TileUnknown = 0,
+    TileOpaque,
+    TileNotOpaque
+};
+
+struct kpImageOpacityMapPrivate
+{
+    QSize imageSize;
+    int tilesAcross = 0, tilesDown = 0;
+
+    // kpTileOpacity, in row major order.
+    QVector <quint8> tiles;
+};
+
+//---------------------------------------------------------------------
+
+kpImageOpacityMap::kpImageOpacityMap ()
+    : d (new kpImageOpacityMapPrivate ())
+{
+}
+
+//---------------------------------------------------------------------
+
+kpImageOpacityMap::~kpImageOpacityMap ()
+{
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpImageOpacityMap::clear ()
+{
+    d->imageSize = QSize ();
+    d->tilesAcross = d->tilesDown = 0;
+    d->tiles.clear ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpImageOpacityMap::invalidate (const QRect &rect)
+{
+    const QRect r = rect & QRect (QPoint (0, 0), d->imageSize);
+    if (r.isEmpty ()) {
+        return;
+    }
+
+    for (int ty = r.top () / TileSize; ty <= r.bottom () / TileSize; ty++)
+    {
+        for (int tx = r.left () / TileSize; tx <= r.right () / TileSize; tx++) {
+            d->tiles [ty * d->tilesAcross + tx] = TileUnknown;
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+static bool ScanIsOpaque (const QImage &image, const QRect &rect)
+{
+    switch (image.format ())
+    {
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_ARGB32:
+        for (int y = rect.top (); y <= rect.bottom (); y++)
+        {
+            const auto *line =
+                reinterpret_cast <const QRgb *> (image.constScanLine (y));
+            for (int x = rect.left (); x <= rect.right (); x++)
+            {
+                if (qAlpha (line [x]) != 0xFF) {
+                    return false;
+                }
+            }
+        }
+        return true;
+
+    default:
+        // (e.g. Format_RGB32)
+        if (!image.hasAlphaChannel ()) {
+            return true;
+        }
+
+        // Unusual format with an alpha channel.  Not worth scanning.
+        return false;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpImageOpacityMap::isOpaque (const kpImage &image, const QRect &rect)
+{
+    if (image.size () != d->imageSize)
+    {
+        d->imageSize = image.size ();
+        d->tilesAcross = (image.width () + TileSize - 1) / TileSize;
+        d->tilesDown = (image.height () + TileSize - 1) / TileSize;
+        d->tiles.fill (TileUnknown, d->tilesAcross * d->tilesDown);
+    }
+
+    const QRect r = rect & image.rect ();
+    if (r.isEmpty ()) {
+        return true;
+    }
+
+    for (int ty = r.top () / TileSize; ty <= r.bottom () / TileSize; ty++)
+    {
+        for (int tx = r.left () / TileSize; tx <= r.right () / TileSize; tx++)
+        {
+            quint8 &tile = d->tiles [ty * d->tilesAcross + tx];
+            if (tile == TileUnknown)
+            {
+                const QRect tileRect = QRect (tx * TileSize, ty * TileSize,
+                                              TileSize, TileSize) & image.rect ();
+                tile = ScanIsOpaque (image, tileRect) ? TileOpaque : TileNotOpaque;
+
+            #if DEBUG_KP_IMAGE_OPACITY_MAP
+                qCDebug(kpLogImagelib) << "kpImageOpacityMap::isOpaque() scanned"
+                          << tileRect << "opaque=" << (tile == TileOpaque);
+            #endif
+            }
+
+            if (tile != TileOpaque) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,86 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#ifndef KP_IMAGE_OPACITY_MAP_H
+#define KP_IMAGE_OPACITY_MAP_H
+
+
+#include <QRect>
+
+#include "kpImage.h"
+
+
+struct kpImageOpacityMapPrivate;
+
+//
+// Remembers which tiles of a kpImage are fully opaque, so that renderers
+// can skip drawing a checkerboard underneath and blit instead of alpha
+// blending.
+//
+// Images are usually stored with an alpha channel even if every pixel is
+// opaque, so QImage::hasAlphaChannel() doesn't tell us anything.
+//
+// Tiles are scanned lazily, on the first isOpaque() query that covers
+// them, and rescanned only after invalidate() marks them as changed.
+//
+// The image is not owned and must be passed to each isOpaque() call.  If
+// its size changes, everything is rescanned.
+//
+// Not thread-safe.
+//
+class kpImageOpacityMap
+{
+public:
+    kpImageOpacityMap ();
+    ~kpImageOpacityMap ();
+
+    kpImageOpacityMap (const kpImageOpacityMap &) = delete;
+    kpImageOpacityMap &operator= (const kpImageOpacityMap &) = delete;
+
+
+    // Forgets everything.
+    void clear ();
+
+    // Marks <rect> (in image coordinates) as changed.
+    void invalidate (const QRect &rect);
+
+    // Returns whether every pixel of <image> inside <rect> is fully
+    // opaque.  Parts of <rect> outside of <image> are ignored.
+    //
+    // This is conservative: a tile that is only partly inside <rect> must
+    // be fully opaque for <rect> to be reported as opaque.
+    bool isOpaque (const kpImage &image, const QRect &rect);
+
+
+private:
+    kpImageOpacityMapPrivate * const d;
+};
+
+
+#endif  // KP_IMAGE_OPACITY_MAP_H
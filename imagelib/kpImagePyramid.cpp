@@ -0,0 +1,251 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_IMAGE_PYRAMID 0
+
+
+#include "kpImagePyramid.h"
+
+#include <QRegion>
+#include <QVector>
+
+#include "kpLogCategories.h"
+
+//---------------------------------------------------------------------
+
+// Levels are rebuilt in tiles of this size (in the level's own
+// coordinates), so that many small changes don't turn into many tiny,
+// inefficient rebuilds.
+static const int TileSize = 128;
+
+struct kpImagePyramidLevel
+{
+    QImage image;
+    QRegion dirtyRegion;
+};
+
+struct kpImagePyramidPrivate
+{
+    QSize sourceSize;
+
+    // levels [0] is level 1 (level 0 is the source).
+    QVector <kpImagePyramidLevel> levels;
+};
+
+//---------------------------------------------------------------------
+
+// public static
+const int kpImagePyramid::MaxLevel = 8;
+
+//---------------------------------------------------------------------
+
+kpImagePyramid::kpImagePyramid ()
+    : d (new kpImagePyramidPrivate ())
+{
+}
+
+//---------------------------------------------------------------------
+
+kpImagePyramid::~kpImagePyramid ()
+{
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+int kpImagePyramid::levelForScale (double scale)
+{
+    int level = 0;
+    while (level < MaxLevel && scale * double (1 << (level + 1)) <= 1.0) {
+        level++;
+    }
+
+    return level;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QRect kpImagePyramid::levelRect (const QRect &rect, int level)
+{
+    if (level <= 0 || rect.isEmpty ()) {
+        return rect;
+    }
+
+    // (>> rounds towards negative infinity, like the box filter)
+    return  {QPoint (rect.left () >> level, rect.top () >> level),
+             QPoint (rect.right () >> level, rect.bottom () >> level)};
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpImagePyramid::clear ()
+{
+#if DEBUG_KP_IMAGE_PYRAMID
+    qCDebug(kpLogImagelib) << "kpImagePyramid::clear()";
+#endif
+
+    d->sourceSize = QSize ();
+    d->levels.clear ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpImagePyramid::invalidate (const QRect &rect)
+{
+    for (int i = 0; i < d->levels.size (); i++)
+    {
+        kpImagePyramidLevel &level = d->levels [i];
+
+        const QRect dirtyRect = levelRect (rect, i + 1) & level.image.rect ();
+        if (!dirtyRect.isEmpty ()) {
+            level.dirtyRegion += dirtyRect;
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Returns the average of 4 premultiplied pixels, rounded to nearest.
+// The red/blue and alpha/green pairs are summed 2 at a time in 16-bit
+// lanes, which can't overflow (4 * 255 + 2 < 2^16).
+static inline QRgb Average4 (QRgb a, QRgb b, QRgb c, QRgb e)
+{
+    const quint32 rb = ((a & 0x00ff00ffu) + (b & 0x00ff00ffu) +
+                        (c & 0x00ff00ffu) + (e & 0x00ff00ffu) +
+                        0x00020002u) >> 2;
+    const quint32 ag = (((a >> 8) & 0x00ff00ffu) + ((b >> 8) & 0x00ff00ffu) +
+                        ((c >> 8) & 0x00ff00ffu) + ((e >> 8) & 0x00ff00ffu) +
+                        0x00020002u) >> 2;
+
+    return (rb & 0x00ff00ffu) | ((ag & 0x00ff00ffu) << 8);
+}
+
+//---------------------------------------------------------------------
+
+// Box filters <src> into <dstRect> of <dst>, which is half the size of
+// <src> (rounded up).
+static void Downsample (const QImage &src, QImage *dst, const QRect &dstRect)
+{
+    Q_ASSERT (src.format () == QImage::Format_ARGB32_Premultiplied);
+    Q_ASSERT (dst->format () == QImage::Format_ARGB32_Premultiplied);
+
+    const int srcRight = src.width () - 1;
+    const int srcBottom = src.height () - 1;
+
+    for (int y = dstRect.top (); y <= dstRect.bottom (); y++)
+    {
+        const auto *srcLine0 =
+            reinterpret_cast <const QRgb *> (src.constScanLine (2 * y));
+        const auto *srcLine1 =
+            reinterpret_cast <const QRgb *> (src.constScanLine (qMin (2 * y + 1, srcBottom)));
+        auto *dstLine = reinterpret_cast <QRgb *> (dst->scanLine (y));
+
+        for (int x = dstRect.left (); x <= dstRect.right (); x++)
+        {
+            const int x0 = 2 * x;
+            const int x1 = qMin (2 * x + 1, srcRight);
+
+            dstLine [x] = Average4 (srcLine0 [x0], srcLine0 [x1],
+                                    srcLine1 [x0], srcLine1 [x1]);
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpImage kpImagePyramid::level (const kpImage &source, int level)
+{
+    if (level <= 0 || source.isNull ()) {
+        return source;
+    }
+
+    level = qMin (level, MaxLevel);
+
+    if (source.size () != d->sourceSize)
+    {
+        clear ();
+        d->sourceSize = source.size ();
+    }
+
+    // (documents are always premultiplied so this is normally free)
+    QImage prev = source.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    if (d->levels.size () < level) {
+        d->levels.resize (level);
+    }
+
+    for (int i = 0; i < level; i++)
+    {
+        kpImagePyramidLevel &lvl = d->levels [i];
+
+        const QSize size ((prev.width () + 1) / 2, (prev.height () + 1) / 2);
+        if (lvl.image.size () != size)
+        {
+            lvl.image = QImage (size, QImage::Format_ARGB32_Premultiplied);
+            lvl.dirtyRegion = lvl.image.rect ();
+        }
+
+        if (!lvl.dirtyRegion.isEmpty ())
+        {
+        #if DEBUG_KP_IMAGE_PYRAMID
+            qCDebug(kpLogImagelib) << "kpImagePyramid::level() rebuild level"
+                      << i + 1 << "dirty=" << lvl.dirtyRegion;
+        #endif
+
+            // Round out to whole tiles.
+            QRegion tileRegion;
+            for (const QRect &r : lvl.dirtyRegion)
+            {
+                const QRect tileRect (
+                    QPoint (r.left () / TileSize * TileSize,
+                            r.top () / TileSize * TileSize),
+                    QPoint ((r.right () / TileSize + 1) * TileSize - 1,
+                            (r.bottom () / TileSize + 1) * TileSize - 1));
+                tileRegion += tileRect & lvl.image.rect ();
+            }
+
+            for (const QRect &r : tileRegion) {
+                Downsample (prev, &lvl.image, r);
+            }
+
+            lvl.dirtyRegion = QRegion ();
+        }
+
+        prev = lvl.image;
+    }
+
+    return prev;
+}
+
+//---------------------------------------------------------------------
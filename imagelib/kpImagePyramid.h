@@ -0,0 +1,97 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_IMAGE_PYRAMID_H
+#define KP_IMAGE_PYRAMID_H
+
+
+#include <QRect>
+#include <QSize>
+
+#include "kpImage.h"
+
+
+struct kpImagePyramidPrivate;
+
+//
+// A mipmap pyramid of a kpImage, for drawing it zoomed out.
+//
+// Level 0 is the source image itself.  Level n is level n-1 downscaled by
+// 2 in each direction with a 2x2 box filter (odd sizes round up, with the
+// last row/column averaged with itself).
+//
+// Levels are built lazily, on the first request for them, and afterwards
+// kept up to date incrementally: invalidate() marks a rectangle of the
+// source as changed and only the tiles of each level that cover it are
+// rebuilt, on the next request for that level.
+//
+// The source image is not owned and must be passed to each level() call.
+// If its size changes, all levels are rebuilt.
+//
+// Not thread-safe.
+//
+class kpImagePyramid
+{
+public:
+    kpImagePyramid ();
+    ~kpImagePyramid ();
+
+    kpImagePyramid (const kpImagePyramid &) = delete;
+    kpImagePyramid &operator= (const kpImagePyramid &) = delete;
+
+
+    // Returns the coarsest level whose pixels still map to at least 1
+    // destination pixel when drawn at <scale> (e.g. 1 for 50%, 0 for
+    // >50%).  Never returns more than MaxLevel.
+    static int levelForScale (double scale);
+    static const int MaxLevel;
+
+    // Returns the rectangle of level <level> that covers <rect> of level 0.
+    static QRect levelRect (const QRect &rect, int level);
+
+
+    // Discards all levels.
+    void clear ();
+
+    // Marks <rect> (in source coordinates) as changed.
+    void invalidate (const QRect &rect);
+
+    // Returns level <level> of <source>, first bringing it up to date.
+    // <level> == 0 returns <source>.
+    //
+    // The returned image is implicitly shared; it is only guaranteed to
+    // reflect <source> until the next invalidate().
+    kpImage level (const kpImage &source, int level);
+
+
+private:
+    kpImagePyramidPrivate * const d;
+};
+
+
+#endif  // KP_IMAGE_PYRAMID_H
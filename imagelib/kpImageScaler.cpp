@@ -0,0 +1,455 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_IMAGE_SCALER 0
+
+
+#include "kpImageScaler.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include <QVector>
+#include <QtMath>
+
+#include "kpLogCategories.h"
+
+#include "generic/kpParallel.h"
+
+//---------------------------------------------------------------------
+
+// Filter weights are fixed point numbers with this many fractional bits.
+// A channel (<= 255) times the sum of the absolute weights of a Lanczos3
+// window still fits comfortably in 32 bits.
+static const int WeightBits = 14;
+
+// The most that one pass shrinks an axis by.  Beyond this, there would be
+// so many taps that each would get only a few fixed point steps of
+// weight, and rounding them would make a mess of regular patterns (e.g.
+// dithering), so bigger shrinks are first done in Box filtered passes of
+// this size.
+static const int MaxShrinkPerPass = 64;
+
+//---------------------------------------------------------------------
+
+// Returns how far from its centre <filter> is non-zero, in source pixels
+// (when not shrinking).
+static double FilterSupport (kpImageScaler::Filter filter)
+{
+    switch (filter)
+    {
+    case kpImageScaler::Box:
+        return 0.5;
+    case kpImageScaler::Bilinear:
+        return 1.0;
+    case kpImageScaler::Bicubic:
+        return 2.0;
+    case kpImageScaler::Lanczos3:
+        return 3.0;
+    }
+
+    return 1.0;
+}
+
+//---------------------------------------------------------------------
+
+static double Sinc (double x)
+{
+    if (x == 0) {
+        return 1.0;
+    }
+
+    x *= M_PI;
+    return std::sin (x) / x;
+}
+
+//---------------------------------------------------------------------
+
+// Returns the (unnormalized) weight of <filter> at distance <x> from its
+// centre.
+static double FilterWeight (kpImageScaler::Filter filter, double x)
+{
+    x = std::fabs (x);
+
+    switch (filter)
+    {
+    case kpImageScaler::Box:
+        return (x < 0.5) ? 1.0 : 0.0;
+
+    case kpImageScaler::Bilinear:
+        return (x < 1.0) ? 1.0 - x : 0.0;
+
+    case kpImageScaler::Bicubic:
+    {
+        // Keys' cubic convolution with a = -0.5 (Catmull-Rom).
+        const double a = -0.5;
+        if (x < 1.0) {
+            return ((a + 2) * x - (a + 3)) * x * x + 1;
+        }
+        if (x < 2.0) {
+            return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+        }
+        return 0.0;
+    }
+
+    case kpImageScaler::Lanczos3:
+        return (x < 3.0) ? ::Sinc (x) * ::Sinc (x / 3.0) : 0.0;
+    }
+
+    return 0.0;
+}
+
+//---------------------------------------------------------------------
+
+// The filter taps for one axis: destination pixel <i> is the sum of the
+// <count[i]> source pixels from <start[i]>, weighted by the fixed point
+// <weights> from index <i * maxTaps>.
+struct kpImageScalerTaps
+{
+    QVector <int> start, count;
+    QVector <qint16> weights;
+    int maxTaps = 0;
+};
+
+//---------------------------------------------------------------------
+
+static kpImageScalerTaps CalculateTaps (int srcLength, int destLength,
+        kpImageScaler::Filter filter)
+{
+    const double scale = double (srcLength) / double (destLength);
+
+    // When shrinking, stretch the filter over the source pixels, so that it
+    // also removes the detail that is too fine for the destination.
+    const double filterScale = qMax (1.0, scale);
+    const double support = ::FilterSupport (filter) * filterScale;
+
+    kpImageScalerTaps taps;
+    taps.maxTaps = int (std::ceil (support * 2)) + 1;
+    taps.start.resize (destLength);
+    taps.count.resize (destLength);
+    taps.weights.fill (0, destLength * taps.maxTaps);
+
+    QVector <double> weights (taps.maxTaps);
+
+    for (int i = 0; i < destLength; i++)
+    {
+        // (Source pixel <j> covers [j, j + 1).)
+        const double centre = (i + 0.5) * scale;
+        const int first = qMax (0, int (std::floor (centre - support + 0.5)));
+        const int end = qMin (srcLength,
+            qMax (first + 1, int (std::floor (centre + support + 0.5))));
+        const int count = qMin (end - first, taps.maxTaps);
+
+        double sum = 0;
+        for (int j = 0; j < count; j++)
+        {
+            weights [j] = ::FilterWeight (filter,
+                (first + j + 0.5 - centre) / filterScale);
+            sum += weights [j];
+        }
+
+        qint16 *fixedWeights = taps.weights.data () + i * taps.maxTaps;
+
+        if (sum == 0)
+        {
+            // Can only happen with tiny destination sizes and a Box
+            // filter that falls between pixels: take the nearest pixel.
+            taps.start [i] = qBound (0, int (centre), srcLength - 1);
+            taps.count [i] = 1;
+            fixedWeights [0] = qint16 (1 << WeightBits);
+            continue;
+        }
+
+        // Normalize so that the weights sum to exactly 1.  The running
+        // total is rounded, rather than each weight, so no weight is off by
+        // more than one step or changes sign.  When shrinking a lot, there
+        // are hundreds of small weights, and rounding each of them could
+        // leave the total further off than any single weight could
+        // absorb.
+        double total = 0;
+        int fixedTotal = 0;
+        for (int j = 0; j < count; j++)
+        {
+            total += weights [j] / sum;
+            const int newFixedTotal = qRound (total * (1 << WeightBits));
+            fixedWeights [j] = qint16 (newFixedTotal - fixedTotal);
+            fixedTotal = newFixedTotal;
+        }
+
+        // Don't waste time on taps that rounded to nothing at either end.
+        int skip = 0, used = count;
+        while (used > 1 && fixedWeights [skip] == 0) {
+            skip++;
+            used--;
+        }
+        while (used > 1 && fixedWeights [skip + used - 1] == 0) {
+            used--;
+        }
+        for (int j = 0; j < used; j++) {
+            fixedWeights [j] = fixedWeights [skip + j];
+        }
+        for (int j = used; j < count; j++) {
+            fixedWeights [j] = 0;
+        }
+
+        taps.start [i] = first + skip;
+        taps.count [i] = used;
+    }
+
+    return taps;
+}
+
+//---------------------------------------------------------------------
+
+// Returns <pixel> with each color channel clamped to its alpha, as negative
+// filter lobes can otherwise produce invalid premultiplied pixels.
+static inline QRgb ClampPremultiplied (QRgb pixel)
+{
+    const int alpha = qAlpha (pixel);
+    return qRgba (qMin (qRed (pixel), alpha),
+                  qMin (qGreen (pixel), alpha),
+                  qMin (qBlue (pixel), alpha),
+                  alpha);
+}
+
+//---------------------------------------------------------------------
+
+// Returns the weighted sum of the <count> premultiplied pixels starting at
+// <src>, <stride> pixels apart.
+//
+// The scalar and SSE2 versions round identically so the result does not
+// depend on how the program was compiled.
+static inline QRgb ConvolvePixels (const QRgb *src, qptrdiff stride,
+        const qint16 *weights, int count)
+{
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    __m128i sum = _mm_set1_epi32 (1 << (WeightBits - 1));
+
+    int i = 0;
+    for (; i + 1 < count; i += 2)
+    {
+        const __m128i pixels = _mm_unpacklo_epi8 (
+            _mm_set_epi32 (0, 0, int (src [(i + 1) * stride]), int (src [i * stride])),
+            zero);
+        // b0 b1 g0 g1 r0 r1 a0 a1, so that each 32-bit lane of the
+        // multiply-add sums a channel of both pixels.
+        const __m128i channels = _mm_unpacklo_epi16 (pixels, _mm_srli_si128 (pixels, 8));
+        const __m128i weightPair = _mm_set1_epi32 (int (
+            (quint32 (quint16 (weights [i + 1])) << 16) | quint16 (weights [i])));
+        sum = _mm_add_epi32 (sum, _mm_madd_epi16 (channels, weightPair));
+    }
+
+    if (i < count)
+    {
+        const __m128i channels = _mm_unpacklo_epi16 (
+            _mm_unpacklo_epi8 (_mm_cvtsi32_si128 (int (src [i * stride])), zero),
+            zero);
+        sum = _mm_add_epi32 (sum,
+            _mm_madd_epi16 (channels, _mm_set1_epi32 (quint16 (weights [i]))));
+    }
+
+    sum = _mm_srai_epi32 (sum, WeightBits);
+    const __m128i sum16 = _mm_packs_epi32 (sum, sum);
+    return ::ClampPremultiplied (QRgb (_mm_cvtsi128_si32 (_mm_packus_epi16 (sum16, sum16))));
+#else
+    int blue = 1 << (WeightBits - 1), green = blue, red = blue, alpha = blue;
+    for (int i = 0; i < count; i++)
+    {
+        const QRgb pixel = src [i * stride];
+        const int weight = weights [i];
+
+        blue += int (pixel & 0xFF) * weight;
+        green += int ((pixel >> 8) & 0xFF) * weight;
+        red += int ((pixel >> 16) & 0xFF) * weight;
+        alpha += int (pixel >> 24) * weight;
+    }
+
+    auto channel = [] (int sum) {
+        return qBound (0, sum >> WeightBits, 255);
+    };
+    return ::ClampPremultiplied (qRgba (channel (red), channel (green),
+        channel (blue), channel (alpha)));
+#endif
+}
+
+//---------------------------------------------------------------------
+
+static kpImage ScaleHorizontally (const kpImage &src, int width,
+        kpImageScaler::Filter filter)
+{
+    // Shrink by at most MaxShrinkPerPass at a time.
+    if (src.width () / width > MaxShrinkPerPass)
+    {
+        const kpImage smaller = ::ScaleHorizontally (src,
+            (src.width () + MaxShrinkPerPass - 1) / MaxShrinkPerPass,
+            kpImageScaler::Box);
+        return smaller.isNull () ? smaller : ::ScaleHorizontally (smaller, width, filter);
+    }
+
+    const kpImageScalerTaps taps = ::CalculateTaps (src.width (), width, filter);
+
+    kpImage dest (width, src.height (), QImage::Format_ARGB32_Premultiplied);
+    if (dest.isNull ()) {
+        return dest;
+    }
+
+    uchar * const destBits = dest.bits ();
+    const int destBytesPerLine = dest.bytesPerLine ();
+    const uchar * const srcBits = src.constBits ();
+    const int srcBytesPerLine = src.bytesPerLine ();
+
+    kpParallel::forEachBand (src.height (),
+        qMax (1, 65536 / qMax (1, width * taps.maxTaps)),
+        [&] (int firstRow, int endRow)
+        {
+            for (int y = firstRow; y < endRow; y++)
+            {
+                const auto *srcLine = reinterpret_cast <const QRgb *> (
+                    srcBits + qsizetype (y) * srcBytesPerLine);
+                auto *destLine = reinterpret_cast <QRgb *> (
+                    destBits + qsizetype (y) * destBytesPerLine);
+
+                for (int x = 0; x < width; x++)
+                {
+                    destLine [x] = ::ConvolvePixels (srcLine + taps.start [x], 1,
+                        taps.weights.constData () + x * taps.maxTaps,
+                        taps.count [x]);
+                }
+            }
+        });
+
+    return dest;
+}
+
+//---------------------------------------------------------------------
+
+static kpImage ScaleVertically (const kpImage &src, int height,
+        kpImageScaler::Filter filter)
+{
+    // (see ScaleHorizontally())
+    if (src.height () / height > MaxShrinkPerPass)
+    {
+        const kpImage smaller = ::ScaleVertically (src,
+            (src.height () + MaxShrinkPerPass - 1) / MaxShrinkPerPass,
+            kpImageScaler::Box);
+        return smaller.isNull () ? smaller : ::ScaleVertically (smaller, height, filter);
+    }
+
+    const kpImageScalerTaps taps = ::CalculateTaps (src.height (), height, filter);
+
+    kpImage dest (src.width (), height, QImage::Format_ARGB32_Premultiplied);
+    if (dest.isNull ()) {
+        return dest;
+    }
+
+    const int width = src.width ();
+    uchar * const destBits = dest.bits ();
+    const int destBytesPerLine = dest.bytesPerLine ();
+    const uchar * const srcBits = src.constBits ();
+    const qptrdiff srcStride = src.bytesPerLine () / qptrdiff (sizeof (QRgb));
+
+    kpParallel::forEachBand (height,
+        qMax (1, 65536 / qMax (1, width * taps.maxTaps)),
+        [&] (int firstRow, int endRow)
+        {
+            for (int y = firstRow; y < endRow; y++)
+            {
+                const auto *srcTop = reinterpret_cast <const QRgb *> (srcBits) +
+                    taps.start [y] * srcStride;
+                auto *destLine = reinterpret_cast <QRgb *> (
+                    destBits + qsizetype (y) * destBytesPerLine);
+                const qint16 *weights = taps.weights.constData () + y * taps.maxTaps;
+                const int count = taps.count [y];
+
+                for (int x = 0; x < width; x++)
+                {
+                    destLine [x] = ::ConvolvePixels (srcTop + x, srcStride,
+                        weights, count);
+                }
+            }
+        });
+
+    return dest;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+kpImage kpImageScaler::scale (const kpImage &image, int width, int height,
+        Filter filter)
+{
+#if DEBUG_KP_IMAGE_SCALER
+    qCDebug(kpLogImagelib) << "kpImageScaler::scale(" << image.size ()
+                           << "->" << width << "x" << height
+                           << ",filter=" << filter << ")";
+#endif
+
+    Q_ASSERT (width > 0 && height > 0);
+
+    kpImage ret = (image.format () == QImage::Format_ARGB32_Premultiplied) ?
+        image : image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    if (ret.isNull ()) {
+        return ret;
+    }
+
+    // Shrinking horizontally first means the vertical pass has less to do
+    // and vice versa.
+    const bool horizontalFirst = (double (width) / ret.width () <=
+                                  double (height) / ret.height ());
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if ((pass == 0) == horizontalFirst)
+        {
+            if (width != ret.width ()) {
+                ret = ::ScaleHorizontally (ret, width, filter);
+            }
+        }
+        else
+        {
+            if (height != ret.height ()) {
+                ret = ::ScaleVertically (ret, height, filter);
+            }
+        }
+
+        if (ret.isNull ())
+        {
+            qCCritical(kpLogImagelib) << "kpImageScaler::scale() could not allocate";
+            break;
+        }
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
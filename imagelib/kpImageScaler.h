@@ -0,0 +1,73 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef KP_IMAGE_SCALER_H
+#define KP_IMAGE_SCALER_H
+
+
+#include "kpImage.h"
+
+
+//
+// High quality image scaling, for Smooth Scale.
+//
+// The image is resampled separably (first horizontally, then vertically)
+// with the chosen filter.  When shrinking, the filter is widened to cover
+// every source pixel that falls under a destination pixel, so big
+// downscales do not alias the way QImage::scaled() does.
+//
+// The filter weights for each axis are computed once per call, and the
+// rows of each pass are spread across threads.
+//
+class kpImageScaler
+{
+public:
+    // Stored in KConfig so do not reorder.
+    enum Filter
+    {
+        // Averages the source pixels covered by each destination pixel.
+        // Upscaling with it duplicates pixels.
+        Box,
+        Bilinear,
+        // Catmull-Rom.
+        Bicubic,
+        // Sharpest, but can ring around hard edges.
+        Lanczos3,
+
+        DefaultFilter = Lanczos3
+    };
+
+    // Returns <image> scaled to <width> x <height> with <filter>, as
+    // Format_ARGB32_Premultiplied.
+    //
+    // ASSUMPTION: width > 0 && height > 0.
+    static kpImage scale (const kpImage &image, int width, int height,
+        Filter filter = DefaultFilter);
+};
+
+
+#endif  // KP_IMAGE_SCALER_H
@@ -468,45 +468,3 @@ QRect kpPainter::washRect (kpImage *image,
 }
 
 //---------------------------------------------------------------------
-
-// public static
-void kpPainter::sprayPoints (kpImage *image,
-        const QList <QPoint> &points,
-        const kpColor &color,
-        int spraycanSize)
-{
-#if DEBUG_KP_PAINTER
-    qCDebug(kpLogImagelib) << "kpPainter::sprayPoints()";
-#endif
-
-    Q_ASSERT (spraycanSize > 0);
-
-    QPainter painter(image);
-    const int radius = spraycanSize / 2;
-
-    // Set the drawing colors for the painters.
-
-    painter.setPen(color.toQColor());
-
-    for (const auto &p : points)
-    {
-        for (int i = 0; i < 10; i++)
-        {
-            const int dx = (QRandomGenerator::global()->generate() % spraycanSize) - radius;
-            const int dy = (QRandomGenerator::global()->generate() % spraycanSize) - radius;
-
-            // Make it look circular.
-            // TODO: Can be done better by doing a random vector angle & length
-            //       but would sin and cos be too slow?
-            if ((dx * dx) + (dy * dy) > (radius * radius)) {
-                continue;
-            }
-
-            const QPoint p2 (p.x () + dx, p.y () + dy);
-
-            painter.drawPoint(p2);
-        }
-    }
-}
-
-//---------------------------------------------------------------------
@@ -0,0 +1,279 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_SPRAYCAN_ENGINE 0
+
+
+#include "kpSpraycanEngine.h"
+
+#include "kpColor.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+
+#include "kpLogCategories.h"
+
+//---------------------------------------------------------------------
+
+// xoshiro128** 1.1 by David Blackman and Sebastiano Vigna (public domain).
+//
+// A handful of shifts and rotates per number, no locks and plenty random
+// for spraying graffiti.  Not suitable for anything cryptographic.
+class kpSpraycanRandom
+{
+public:
+    kpSpraycanRandom ()
+    {
+        // Seed once from the system source.  xoshiro must not be seeded
+        // with all zeroes.
+        do
+        {
+            QRandomGenerator::global ()->fillRange (m_state, 4);
+        }
+        while (m_state [0] == 0 && m_state [1] == 0 &&
+               m_state [2] == 0 && m_state [3] == 0);
+    }
+
+    quint32 generate ()
+    {
+        const quint32 result = rotl (m_state [1] * 5, 7) * 9;
+        const quint32 t = m_state [1] << 9;
+
+        m_state [2] ^= m_state [0];
+        m_state [3] ^= m_state [1];
+        m_state [1] ^= m_state [2];
+        m_state [0] ^= m_state [3];
+
+        m_state [2] ^= t;
+
+        m_state [3] = rotl (m_state [3], 11);
+
+        return result;
+    }
+
+    // Returns a number in [0, <highest>).
+    //
+    // Uses Lemire's multiply-shift reduction instead of a division.  The
+    // bias is < <highest> / 2^32, which is irrelevant for our purposes.
+    quint32 bounded (quint32 highest)
+    {
+        return quint32 ((quint64 (generate ()) * highest) >> 32);
+    }
+
+private:
+    static quint32 rotl (quint32 x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    quint32 m_state [4];
+};
+
+//---------------------------------------------------------------------
+
+struct kpSpraycanEnginePrivate
+{
+    kpSpraycanRandom random;
+
+    int spraycanSize = 0;
+    int density = kpSpraycanEngine::DefaultDensity;
+
+    // All offsets (from the spray point) of pixels inside the spray circle.
+    QVector <QPoint> circleOffsets;
+};
+
+//---------------------------------------------------------------------
+
+kpSpraycanEngine::kpSpraycanEngine ()
+    : d (new kpSpraycanEnginePrivate ())
+{
+}
+
+//---------------------------------------------------------------------
+
+kpSpraycanEngine::~kpSpraycanEngine ()
+{
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpSpraycanEngine::spraycanSize () const
+{
+    return d->spraycanSize;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpSpraycanEngine::setSpraycanSize (int spraycanSize)
+{
+    Q_ASSERT (spraycanSize > 0);
+
+    if (spraycanSize == d->spraycanSize) {
+        return;
+    }
+
+    d->spraycanSize = spraycanSize;
+
+
+    // Enumerate the circle once, so that sprayPoints() can pick a random
+    // pixel inside it with a single random number.
+    //
+    // This is the same set of pixels that the old kpPainter::sprayPoints()
+    // accepted after rejecting random points in the bounding square.
+    const int radius = spraycanSize / 2;
+
+    d->circleOffsets.clear ();
+    for (int dy = -radius; dy <= spraycanSize - 1 - radius; dy++)
+    {
+        for (int dx = -radius; dx <= spraycanSize - 1 - radius; dx++)
+        {
+            if ((dx * dx) + (dy * dy) <= (radius * radius)) {
+                d->circleOffsets.append (QPoint (dx, dy));
+            }
+        }
+    }
+
+#if DEBUG_KP_SPRAYCAN_ENGINE
+    qCDebug(kpLogImagelib) << "kpSpraycanEngine::setSpraycanSize(" << spraycanSize
+                           << ") #circleOffsets=" << d->circleOffsets.size ();
+#endif
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpSpraycanEngine::density () const
+{
+    return d->density;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpSpraycanEngine::setDensity (int density)
+{
+    Q_ASSERT (density > 0);
+
+    d->density = density;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QRect kpSpraycanEngine::sprayPoints (kpImage *image,
+        const QList <QPoint> &points,
+        const kpColor &color)
+{
+#if DEBUG_KP_SPRAYCAN_ENGINE
+    qCDebug(kpLogImagelib) << "kpSpraycanEngine::sprayPoints() #points=" << points.size ();
+#endif
+
+    Q_ASSERT (image);
+    Q_ASSERT (d->spraycanSize > 0);
+
+    if (points.isEmpty () || image->isNull ()) {
+        return {};
+    }
+
+    const int width = image->width (), height = image->height ();
+
+    const QPoint *offsets = d->circleOffsets.constData ();
+    const auto numOffsets = quint32 (d->circleOffsets.size ());
+
+    // Pick a cell of the bounding square: the circle's cells are numbered
+    // first and the corners after, so this hits the circle exactly as
+    // often as the old "random point in the square, reject if outside the
+    // circle" did, which density() is calibrated for.
+    const auto numSquareCells = quint32 (d->spraycanSize) * quint32 (d->spraycanSize);
+
+    // The document is always ARGB32_Premultiplied, so we can poke the
+    // pixels directly.  Anything else goes through the slow QImage API.
+    const bool isPremultiplied =
+        (image->format () == QImage::Format_ARGB32_Premultiplied);
+    const QRgb premultipliedPixel = qPremultiply (color.toQRgb ());
+    const QColor qcolor = color.toQColor ();
+
+    uchar *bits = nullptr;
+    qsizetype bytesPerLine = 0;
+
+    int minX = width, minY = height, maxX = -1, maxY = -1;
+
+    for (const auto &p : points)
+    {
+        for (int i = 0; i < d->density; i++)
+        {
+            const quint32 cell = d->random.bounded (numSquareCells);
+            if (cell >= numOffsets) {
+                continue;
+            }
+
+            const QPoint &offset = offsets [cell];
+
+            const int x = p.x () + offset.x ();
+            const int y = p.y () + offset.y ();
+
+            if (x < 0 || y < 0 || x >= width || y >= height) {
+                continue;
+            }
+
+            if (isPremultiplied)
+            {
+                // (only now that we know we are going to write, detach from
+                //  any copies e.g. held by the current kpToolFlowCommand)
+                if (!bits)
+                {
+                    bits = image->bits ();
+                    bytesPerLine = image->bytesPerLine ();
+                }
+
+                reinterpret_cast <QRgb *> (bits + y * bytesPerLine) [x] =
+                    premultipliedPixel;
+            }
+            else
+            {
+                image->setPixelColor (x, y, qcolor);
+            }
+
+            minX = qMin (minX, x);
+            minY = qMin (minY, y);
+            maxX = qMax (maxX, x);
+            maxY = qMax (maxY, y);
+        }
+    }
+
+    if (maxX < 0) {
+        return {};
+    }
+
+    return QRect (QPoint (minX, minY), QPoint (maxX, maxY));
+}
+
+//---------------------------------------------------------------------
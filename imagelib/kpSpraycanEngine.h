@@ -0,0 +1,108 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_SPRAYCAN_ENGINE_H
+#define KP_SPRAYCAN_ENGINE_H
+
+
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+#include "kpImage.h"
+
+
+class kpColor;
+
+
+struct kpSpraycanEnginePrivate;
+
+//
+// Sprays random dots onto a kpImage, for the Spraycan tool.
+//
+// Unlike the rest of kpPainter, this is stateful:
+//
+// 1. It owns a fast, unlocked pseudo-random number generator
+//    (xoshiro128**), instead of hammering QRandomGenerator::global()
+//    which takes a lock on every call.
+//
+// 2. It caches the list of pixel offsets inside the spray circle, so that
+//    each dot is placed with a single random number.
+//
+// Dots are written straight into the image's pixels, without a QPainter.
+//
+// Not thread-safe: use one engine per tool.
+//
+class kpSpraycanEngine
+{
+public:
+    kpSpraycanEngine ();
+    ~kpSpraycanEngine ();
+
+    kpSpraycanEngine (const kpSpraycanEngine &) = delete;
+    kpSpraycanEngine &operator= (const kpSpraycanEngine &) = delete;
+
+
+    // The density used until setDensity() is called, and by the Spraycan
+    // tool unless kolourpaintrc says otherwise.
+    static const int DefaultDensity = 10;
+
+
+    // Diameter of the spray circle: dots land within a spraycanSize x
+    // spraycanSize square centred on each point.
+    //
+    // ASSUMPTION: spraycanSize > 0.
+    int spraycanSize () const;
+    void setSpraycanSize (int spraycanSize);
+
+    // Number of dots aimed at each point passed to sprayPoints().  As with
+    // KolourPaint's original spraycan, each is aimed anywhere in the
+    // spraycanSize x spraycanSize square and those outside the circle are
+    // dropped, so about pi/4 of them land.
+    //
+    // ASSUMPTION: density > 0.
+    int density () const;
+    void setDensity (int density);
+
+
+    // For each point in <points>, sprays a random pattern of up to density()
+    // dots of <color>, each within a circle of diameter spraycanSize(), onto
+    // <image>.  Dots that fall outside <image> are clipped.
+    //
+    // Returns the dirty rectangle, which is empty if no pixel was touched.
+    QRect sprayPoints (kpImage *image,
+        const QList <QPoint> &points,
+        const kpColor &color);
+
+
+private:
+    kpSpraycanEnginePrivate * const d;
+};
+
+
+#endif  // KP_SPRAYCAN_ENGINE_H
@@ -323,6 +323,32 @@ void kpTransformAutoCropBorder::invalidate ()
 }
 
 
+// Returns the rectangle of an image of <size> that is left after removing
+// the borders that exist.
+static QRect ContentsRect (const QSize &size,
+        const kpTransformAutoCropBorder &leftBorder,
+        const kpTransformAutoCropBorder &rightBorder,
+        const kpTransformAutoCropBorder &topBorder,
+        const kpTransformAutoCropBorder &botBorder)
+{
+    QPoint topLeft (leftBorder.exists () ?
+                        leftBorder.rect ().right () + 1 :
+                        0,
+                    topBorder.exists () ?
+                        topBorder.rect ().bottom () + 1 :
+                        0);
+    QPoint botRight (rightBorder.exists () ?
+                         rightBorder.rect ().left () - 1 :
+                         size.width () - 1,
+                     botBorder.exists () ?
+                         botBorder.rect ().top () - 1 :
+                         size.height () - 1);
+
+    return {topLeft, botRight};
+}
+
+//---------------------------------------------------------------------
+
 struct kpTransformAutoCropCommandPrivate
 {
     bool actOnSelection{};
@@ -594,24 +620,106 @@ void kpTransformAutoCropCommand::unexecute ()
 // private
 QRect kpTransformAutoCropCommand::contentsRect () const
 {
-    const kpImage image = document ()->image (d->actOnSelection);
+    return ::ContentsRect (QSize (d->oldWidth, d->oldHeight),
+        d->leftBorder, d->rightBorder, d->topBorder, d->botBorder);
+}
 
-    QPoint topLeft (d->leftBorder.exists () ?
-                        d->leftBorder.rect ().right () + 1 :
-                        0,
-                    d->topBorder.exists () ?
-                        d->topBorder.rect ().bottom () + 1 :
-                        0);
-    QPoint botRight (d->rightBorder.exists () ?
-                         d->rightBorder.rect ().left () - 1 :
-                         image.width () - 1,
-                     d->botBorder.exists () ?
-                         d->botBorder.rect ().top () - 1 :
-                         image.height () - 1);
 
-    return {topLeft, botRight};
+// Calculates the borders, which must have been constructed with the image
+// to crop and <processedColorSimilarity>, and invalidates those that
+// should be left alone.  Returns false if no border could be found.
+static bool FindBorders (int processedColorSimilarity,
+        kpTransformAutoCropBorder *leftBorder,
+        kpTransformAutoCropBorder *rightBorder,
+        kpTransformAutoCropBorder *topBorder,
+        kpTransformAutoCropBorder *botBorder)
+{
+    // TODO: With Colour Similarity, a lot of weird (and wonderful) things can
+    //       happen resulting in a huge number of code paths.  Needs refactoring
+    //       and regression testing.
+    //
+    // TODO: e.g. When the top fills entire rect but bot doesn't we could
+    //       invalidate top and continue autocrop.
+    int numRegions = 0;
+    if (!leftBorder->calculate (true/*x*/, +1/*going right*/) ||
+        leftBorder->fillsEntireImage () ||
+        !rightBorder->calculate (true/*x*/, -1/*going left*/) ||
+        rightBorder->fillsEntireImage () ||
+        !topBorder->calculate (false/*y*/, +1/*going down*/) ||
+        topBorder->fillsEntireImage () ||
+        !botBorder->calculate (false/*y*/, -1/*going up*/) ||
+        botBorder->fillsEntireImage () ||
+        ((numRegions = leftBorder->exists () +
+                       rightBorder->exists () +
+                       topBorder->exists () +
+                       botBorder->exists ()) == 0))
+    {
+    #if DEBUG_KP_TOOL_AUTO_CROP
+        qCDebug(kpLogImagelib) << "\tcan't find border; leftBorder->rect=" << leftBorder->rect ()
+                   << " rightBorder->rect=" << rightBorder->rect ()
+                   << " topBorder->rect=" << topBorder->rect ()
+                   << " botBorder->rect=" << botBorder->rect ();
+    #endif
+        return false;
+    }
+
+#if DEBUG_KP_TOOL_AUTO_CROP
+    qCDebug(kpLogImagelib) << "\tnumRegions=" << numRegions;
+    qCDebug(kpLogImagelib) << "\t\tleft=" << leftBorder->rect ()
+               << " refCol=" << (leftBorder->exists () ? (int *) leftBorder->referenceColor ().toQRgb () : nullptr)
+               << " avgCol=" << (leftBorder->exists () ? (int *) leftBorder->averageColor ().toQRgb () : nullptr);
+    qCDebug(kpLogImagelib) << "\t\tright=" << rightBorder->rect ()
+               << " refCol=" << (rightBorder->exists () ? (int *) rightBorder->referenceColor ().toQRgb () : nullptr)
+               << " avgCol=" << (rightBorder->exists () ? (int *) rightBorder->averageColor ().toQRgb () : nullptr);
+    qCDebug(kpLogImagelib) << "\t\ttop=" << topBorder->rect ()
+               << " refCol=" << (topBorder->exists () ? (int *) topBorder->referenceColor ().toQRgb () : nullptr)
+               << " avgCol=" << (topBorder->exists () ? (int *) topBorder->averageColor ().toQRgb () : nullptr);
+    qCDebug(kpLogImagelib) << "\t\tbot=" << botBorder->rect ()
+               << " refCol=" << (botBorder->exists () ? (int *) botBorder->referenceColor ().toQRgb () : nullptr)
+               << " avgCol=" << (botBorder->exists () ? (int *) botBorder->averageColor ().toQRgb () : nullptr);
+#endif
+
+    // In case e.g. the user pastes a solid, coloured-in rectangle,
+    // we favor killing the bottom and right regions
+    // (these regions probably contain the unwanted whitespace due
+    //  to the doc being bigger than the pasted selection to start with).
+    //
+    // We also kill if they kiss or even overlap.
+
+    if (leftBorder->exists () && rightBorder->exists ())
+    {
+        const kpColor leftCol = leftBorder->averageColor ();
+        const kpColor rightCol = rightBorder->averageColor ();
+
+        if ((numRegions == 2 && !leftCol.isSimilarTo (rightCol, processedColorSimilarity)) ||
+            leftBorder->right () >= rightBorder->left () - 1)  // kissing or overlapping
+        {
+        #if DEBUG_KP_TOOL_AUTO_CROP
+            qCDebug(kpLogImagelib) << "\tignoring left border";
+        #endif
+            leftBorder->invalidate ();
+        }
+    }
+
+    if (topBorder->exists () && botBorder->exists ())
+    {
+        const kpColor topCol = topBorder->averageColor ();
+        const kpColor botCol = botBorder->averageColor ();
+
+        if ((numRegions == 2 && !topCol.isSimilarTo (botCol, processedColorSimilarity)) ||
+            topBorder->bottom () >= botBorder->top () - 1)  // kissing or overlapping
+        {
+        #if DEBUG_KP_TOOL_AUTO_CROP
+            qCDebug(kpLogImagelib) << "\tignoring top border";
+        #endif
+            topBorder->invalidate ();
+        }
+    }
+
+    return true;
 }
 
+//---------------------------------------------------------------------
 
 static void ShowNothingToAutocropMessage (kpMainWindow *mainWindow, bool actOnSelection)
 {
@@ -663,89 +771,13 @@ bool kpTransformAutoCrop (kpMainWindow *mainWindow)
 
     mainWindow->colorToolBar ()->flashColorSimilarityToolBarItem ();
 
-    // TODO: With Colour Similarity, a lot of weird (and wonderful) things can
-    //       happen resulting in a huge number of code paths.  Needs refactoring
-    //       and regression testing.
-    //
-    // TODO: e.g. When the top fills entire rect but bot doesn't we could
-    //       invalidate top and continue autocrop.
-    int numRegions = 0;
-    if (!leftBorder.calculate (true/*x*/, +1/*going right*/) ||
-        leftBorder.fillsEntireImage () ||
-        !rightBorder.calculate (true/*x*/, -1/*going left*/) ||
-        rightBorder.fillsEntireImage () ||
-        !topBorder.calculate (false/*y*/, +1/*going down*/) ||
-        topBorder.fillsEntireImage () ||
-        !botBorder.calculate (false/*y*/, -1/*going up*/) ||
-        botBorder.fillsEntireImage () ||
-        ((numRegions = leftBorder.exists () +
-                       rightBorder.exists () +
-                       topBorder.exists () +
-                       botBorder.exists ()) == 0))
+    if (!::FindBorders (processedColorSimilarity,
+            &leftBorder, &rightBorder, &topBorder, &botBorder))
     {
-    #if DEBUG_KP_TOOL_AUTO_CROP
-        qCDebug(kpLogImagelib) << "\tcan't find border; leftBorder.rect=" << leftBorder.rect ()
-                   << " rightBorder.rect=" << rightBorder.rect ()
-                   << " topBorder.rect=" << topBorder.rect ()
-                   << " botBorder.rect=" << botBorder.rect ();
-    #endif
         ::ShowNothingToAutocropMessage (mainWindow, static_cast<bool> (doc->selection ()));
         return false;
     }
 
-#if DEBUG_KP_TOOL_AUTO_CROP
-    qCDebug(kpLogImagelib) << "\tnumRegions=" << numRegions;
-    qCDebug(kpLogImagelib) << "\t\tleft=" << leftBorder.rect ()
-               << " refCol=" << (leftBorder.exists () ? (int *) leftBorder.referenceColor ().toQRgb () : nullptr)
-               << " avgCol=" << (leftBorder.exists () ? (int *) leftBorder.averageColor ().toQRgb () : nullptr);
-    qCDebug(kpLogImagelib) << "\t\tright=" << rightBorder.rect ()
-               << " refCol=" << (rightBorder.exists () ? (int *) rightBorder.referenceColor ().toQRgb () : nullptr)
-               << " avgCol=" << (rightBorder.exists () ? (int *) rightBorder.averageColor ().toQRgb () : nullptr);
-    qCDebug(kpLogImagelib) << "\t\ttop=" << topBorder.rect ()
-               << " refCol=" << (topBorder.exists () ? (int *) topBorder.referenceColor ().toQRgb () : nullptr)
-               << " avgCol=" << (topBorder.exists () ? (int *) topBorder.averageColor ().toQRgb () : nullptr);
-    qCDebug(kpLogImagelib) << "\t\tbot=" << botBorder.rect ()
-               << " refCol=" << (botBorder.exists () ? (int *) botBorder.referenceColor ().toQRgb () : nullptr)
-               << " avgCol=" << (botBorder.exists () ? (int *) botBorder.averageColor ().toQRgb () : nullptr);
-#endif
-
-    // In case e.g. the user pastes a solid, coloured-in rectangle,
-    // we favor killing the bottom and right regions
-    // (these regions probably contain the unwanted whitespace due
-    //  to the doc being bigger than the pasted selection to start with).
-    //
-    // We also kill if they kiss or even overlap.
-
-    if (leftBorder.exists () && rightBorder.exists ())
-    {
-        const kpColor leftCol = leftBorder.averageColor ();
-        const kpColor rightCol = rightBorder.averageColor ();
-
-        if ((numRegions == 2 && !leftCol.isSimilarTo (rightCol, processedColorSimilarity)) ||
-            leftBorder.right () >= rightBorder.left () - 1)  // kissing or overlapping
-        {
-        #if DEBUG_KP_TOOL_AUTO_CROP
-            qCDebug(kpLogImagelib) << "\tignoring left border";
-        #endif
-            leftBorder.invalidate ();
-        }
-    }
-
-    if (topBorder.exists () && botBorder.exists ())
-    {
-        const kpColor topCol = topBorder.averageColor ();
-        const kpColor botCol = botBorder.averageColor ();
-
-        if ((numRegions == 2 && !topCol.isSimilarTo (botCol, processedColorSimilarity)) ||
-            topBorder.bottom () >= botBorder.top () - 1)  // kissing or overlapping
-        {
-        #if DEBUG_KP_TOOL_AUTO_CROP
-            qCDebug(kpLogImagelib) << "\tignoring top border";
-        #endif
-            topBorder.invalidate ();
-        }
-    }
-
 
     mainWindow->addImageOrSelectionCommand (
         new kpTransformAutoCropCommand (static_cast<bool> (doc->selection ()),
@@ -754,3 +786,24 @@ bool kpTransformAutoCrop (kpMainWindow *mainWindow)
 
     return true;
 }
+
+//---------------------------------------------------------------------
+
+QRect kpTransformAutoCropRect (const kpImage &image, int processedColorSimilarity)
+{
+    kpTransformAutoCropBorder leftBorder (&image, processedColorSimilarity),
+                         rightBorder (&image, processedColorSimilarity),
+                         topBorder (&image, processedColorSimilarity),
+                         botBorder (&image, processedColorSimilarity);
+
+    if (!::FindBorders (processedColorSimilarity,
+            &leftBorder, &rightBorder, &topBorder, &botBorder))
+    {
+        return {};
+    }
+
+    return ::ContentsRect (image.size (),
+        leftBorder, rightBorder, topBorder, botBorder);
+}
+
+//---------------------------------------------------------------------
@@ -31,11 +31,11 @@
 
 
 #include "commands/kpNamedCommand.h"
+#include "imagelib/kpImage.h"
 
 
 class QRect;
 
-//class kpImage;
 class kpMainWindow;
 class kpTransformAutoCropBorder;
 
@@ -81,5 +81,9 @@ private:
 // (returns true on success (even if it did nothing) or false on error)
 bool kpTransformAutoCrop (kpMainWindow *mainWindow);
 
+// Returns the part of <image> that kpTransformAutoCrop() would keep, or an
+// empty rectangle if it could not find a border.  Needs no kpMainWindow.
+QRect kpTransformAutoCropRect (const kpImage &image, int processedColorSimilarity);
+
 
 #endif  // KP_TRANSFORM_AUTO_CROP_H
@@ -28,6 +28,9 @@
 
 #include <KAboutData>
 
+#include "kpBatchProcessor.h"
+#include "document/kpDocumentLoadQueue.h"
+#include "generic/kpStartupTrace.h"
 #include "kpVersion.h"
 #include "mainWindow/kpMainWindow.h"
 #include <kolourpaintlicense.h>
@@ -39,8 +42,12 @@
 
 int main(int argc, char *argv [])
 {
+  kpStartupTrace::start();
+  kpBatchProcessor::prepareEnvironment(argc, argv);
+
   QApplication app(argc, argv);
   QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
+  kpStartupTrace::mark("QApplication");
 
   KLocalizedString::setApplicationDomain("kolourpaint");
 
@@ -87,10 +94,20 @@ int main(int argc, char *argv [])
   KAboutData::setApplicationData(aboutData);
   QApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral("kolourpaint"), QApplication::windowIcon()));
   cmdLine.addPositionalArgument(QStringLiteral("files"), i18n("Image files to open, optionally"), QStringLiteral("[files...]"));
+  kpBatchProcessor::addCommandLineOptions(&cmdLine);
 
   aboutData.setupCommandLine(&cmdLine);
   cmdLine.process(app);
   aboutData.processCommandLine(&cmdLine);
+  kpStartupTrace::mark("commandLine");
+
+  if (kpBatchProcessor::isRequested(cmdLine)) {
+    return kpBatchProcessor::run(cmdLine);
+  }
+
+  // Decodes the files given on the command line in parallel, while their
+  // windows are already up.
+  kpDocumentLoadQueue loadQueue;
 
   if ( app.isSessionRestored() )
   {
@@ -107,7 +124,8 @@ int main(int argc, char *argv [])
     {
       for (int i = 0; i < args.count(); i++)
       {
-        mainWindow = new kpMainWindow(QUrl::fromUserInput(args[i], QDir::currentPath(), QUrl::AssumeLocalFile));
+        mainWindow = new kpMainWindow(QUrl::fromUserInput(args[i], QDir::currentPath(), QUrl::AssumeLocalFile),
+                                      &loadQueue);
         mainWindow->show();
       }
     }
@@ -116,6 +134,8 @@ int main(int argc, char *argv [])
       mainWindow = new kpMainWindow();
       mainWindow->show();
     }
+
+    kpStartupTrace::finishWhenPainted(mainWindow);
   }
 
   return QApplication::exec();
@@ -0,0 +1,941 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#define DEBUG_KP_BATCH_PROCESSOR 0
+
+
+#include "kpBatchProcessor.h"
+
+#include <climits>
+#include <cstdio>
+#include <functional>
+
+#include <QColor>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMimeDatabase>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+
+#include <KLocalizedString>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+#include "document/kpDocumentSaveOptions.h"
+#include "imagelib/kpColor.h"
+#include "imagelib/kpDocumentMetaInfo.h"
+#include "imagelib/kpImageScaler.h"
+#include "imagelib/effects/kpEffectBalance.h"
+#include "imagelib/effects/kpEffectBlurSharpen.h"
+#include "imagelib/effects/kpEffectEmboss.h"
+#include "imagelib/effects/kpEffectFlatten.h"
+#include "imagelib/effects/kpEffectGrayscale.h"
+#include "imagelib/effects/kpEffectHSV.h"
+#include "imagelib/effects/kpEffectInvert.h"
+#include "imagelib/effects/kpEffectReduceColors.h"
+#include "imagelib/effects/kpEffectToneEnhance.h"
+#include "imagelib/transforms/kpTransformAutoCrop.h"
+#include "pixmapfx/kpPixmapFX.h"
+
+//---------------------------------------------------------------------
+
+#define kpBatchOptionBatch "batch"
+#define kpBatchOptionOutput "output"
+#define kpBatchOptionFilesFrom "files-from"
+#define kpBatchOptionFormat "format"
+#define kpBatchOptionQuality "quality"
+#define kpBatchOptionColorDepth "color-depth"
+#define kpBatchOptionJobs "jobs"
+#define kpBatchOptionMemoryLimit "memory-limit"
+
+// (not translated as it is mostly names)
+static const char * const OperationsHelp =
+    "Operations:\n"
+    "  rotate:<degrees>                  clockwise\n"
+    "  skew:<horizontal>:<vertical>      degrees\n"
+    "  flip:h | flip:v | flip:hv\n"
+    "  scale:<w>x<h> | scale:<percent>%  nearest neighbour\n"
+    "  smoothscale:<w>x<h>[:<filter>] | smoothscale:<percent>%[:<filter>]\n"
+    "                                    filter: box, bilinear, bicubic, lanczos\n"
+    "  autocrop[:<similarity percent>]\n"
+    "  reducecolors:<1|8>[:dither]\n"
+    "  grayscale\n"
+    "  invert\n"
+    "  blur:<1-10>\n"
+    "  sharpen:<1-10>\n"
+    "  emboss:<1-10>\n"
+    "  flatten:<color1>:<color2>\n"
+    "  balance:<brightness>:<contrast>:<gamma>   each -50 to 50\n"
+    "  hsv:<hue>:<saturation>:<value>            -180 to 180, -1 to 1, -1 to 1\n"
+    "  toneenhance:<granularity>:<amount>        each 0 to 1\n";
+
+// Transparent areas created by transforms, like in an image selection.
+static const kpColor &BackgroundColor = kpColor::Transparent;
+
+//---------------------------------------------------------------------
+
+typedef std::function <kpImage (const kpImage &)> kpBatchOperation;
+
+struct kpBatchOptions
+{
+    QList <kpBatchOperation> pipeline;
+
+    QString outputDir;
+
+    // (invalid values mean "the same as the input file")
+    QString mimeType;
+    int quality = kpDocumentSaveOptions::invalidQuality ();
+    int colorDepth = kpDocumentSaveOptions::invalidColorDepth ();
+
+    int jobs = 1;
+    int memoryLimitMiB = 1024;
+};
+
+struct kpBatchFile
+{
+    QString inputPath;
+    QString outputPath;
+    QString mimeType;
+};
+
+//---------------------------------------------------------------------
+
+static void PrintError (const QString &message)
+{
+    std::fprintf (stderr, "kolourpaint: %s\n", qPrintable (message));
+}
+
+//---------------------------------------------------------------------
+
+// Prints <object> as a line of JSON on stdout.  (It can be called from any
+// thread.)
+static void PrintJson (const QJsonObject &object)
+{
+    static QMutex mutex;
+    QMutexLocker locker (&mutex);
+
+    const QByteArray line = QJsonDocument (object).toJson (QJsonDocument::Compact);
+    std::fwrite (line.constData (), 1, size_t (line.size ()), stdout);
+    std::fputc ('\n', stdout);
+    std::fflush (stdout);
+}
+
+//---------------------------------------------------------------------
+
+static bool ParseInt (const QString &string, int min, int max, int *value)
+{
+    bool ok = false;
+    *value = string.toInt (&ok);
+    return ok && *value >= min && *value <= max;
+}
+
+//---------------------------------------------------------------------
+
+static bool ParseDouble (const QString &string, double min, double max, double *value)
+{
+    bool ok = false;
+    *value = string.toDouble (&ok);
+    return ok && *value >= min && *value <= max;
+}
+
+//---------------------------------------------------------------------
+
+// Parses "<w>x<h>" or "<percent>%" into a function returning the size to
+// scale an image of a given size to.
+static bool ParseScaleSize (const QString &string,
+        std::function <QSize (const QSize &)> *newSize)
+{
+    if (string.endsWith (QLatin1Char ('%')))
+    {
+        double percent;
+        if (!::ParseDouble (string.left (string.length () - 1), 0.01, 100000, &percent)) {
+            return false;
+        }
+
+        *newSize = [percent] (const QSize &size) {
+            return QSize (qMax (1, qRound (size.width () * percent / 100)),
+                          qMax (1, qRound (size.height () * percent / 100)));
+        };
+        return true;
+    }
+
+    const QStringList dimensions = string.split (QLatin1Char ('x'));
+    int width, height;
+    if (dimensions.count () != 2 ||
+        !::ParseInt (dimensions [0], 1, 1 << 16, &width) ||
+        !::ParseInt (dimensions [1], 1, 1 << 16, &height))
+    {
+        return false;
+    }
+
+    *newSize = [width, height] (const QSize &) { return QSize (width, height); };
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// Parses one "<name>[:<arg>...]" operation of the pipeline.
+static bool ParseOperation (const QString &spec, kpBatchOperation *op)
+{
+    const QStringList parts = spec.split (QLatin1Char (':'));
+    const QString name = parts [0].trimmed ().toLower ();
+    const QStringList args = parts.mid (1);
+
+#define ARGS(min, max) if (args.count () < (min) || args.count () > (max)) return false
+
+    if (name == QLatin1String ("rotate"))
+    {
+        ARGS (1, 1);
+        double angle;
+        if (!::ParseDouble (args [0], -360, 360, &angle)) {
+            return false;
+        }
+
+        *op = [angle] (const kpImage &image) {
+            return kpPixmapFX::rotate (image, angle, BackgroundColor);
+        };
+    }
+    else if (name == QLatin1String ("skew"))
+    {
+        ARGS (2, 2);
+        double hangle, vangle;
+        if (!::ParseDouble (args [0], -89, 89, &hangle) ||
+            !::ParseDouble (args [1], -89, 89, &vangle))
+        {
+            return false;
+        }
+
+        *op = [hangle, vangle] (const kpImage &image) {
+            return kpPixmapFX::skew (image, hangle, vangle, BackgroundColor);
+        };
+    }
+    else if (name == QLatin1String ("flip"))
+    {
+        ARGS (1, 1);
+        const QString axes = args [0].toLower ();
+        const bool horiz = axes.contains (QLatin1Char ('h'));
+        const bool vert = axes.contains (QLatin1Char ('v'));
+        if (axes.isEmpty () || axes.length () != int (horiz) + int (vert)) {
+            return false;
+        }
+
+        *op = [horiz, vert] (const kpImage &image) {
+            return kpPixmapFX::flip (image, horiz, vert);
+        };
+    }
+    else if (name == QLatin1String ("scale"))
+    {
+        ARGS (1, 1);
+        std::function <QSize (const QSize &)> newSize;
+        if (!::ParseScaleSize (args [0], &newSize)) {
+            return false;
+        }
+
+        *op = [newSize] (const kpImage &image) {
+            const QSize size = newSize (image.size ());
+            return kpPixmapFX::scale (image, size.width (), size.height ());
+        };
+    }
+    else if (name == QLatin1String ("smoothscale"))
+    {
+        ARGS (1, 2);
+        std::function <QSize (const QSize &)> newSize;
+        if (!::ParseScaleSize (args [0], &newSize)) {
+            return false;
+        }
+
+        kpImageScaler::Filter filter = kpImageScaler::DefaultFilter;
+        if (args.count () == 2)
+        {
+            const QString filterName = args [1].toLower ();
+            if (filterName == QLatin1String ("box")) {
+                filter = kpImageScaler::Box;
+            }
+            else if (filterName == QLatin1String ("bilinear")) {
+                filter = kpImageScaler::Bilinear;
+            }
+            else if (filterName == QLatin1String ("bicubic")) {
+                filter = kpImageScaler::Bicubic;
+            }
+            else if (filterName == QLatin1String ("lanczos")) {
+                filter = kpImageScaler::Lanczos3;
+            }
+            else {
+                return false;
+            }
+        }
+
+        *op = [newSize, filter] (const kpImage &image) {
+            const QSize size = newSize (image.size ());
+            return kpImageScaler::scale (image, size.width (), size.height (), filter);
+        };
+    }
+    else if (name == QLatin1String ("autocrop"))
+    {
+        ARGS (0, 1);
+        double similarity = 0;
+        if (args.count () == 1 && !::ParseDouble (args [0], 0, 100, &similarity)) {
+            return false;
+        }
+        const int processedColorSimilarity = kpColor::processSimilarity (similarity / 100);
+
+        // (images without a border are left alone)
+        *op = [processedColorSimilarity] (const kpImage &image) {
+            const QRect rect = kpTransformAutoCropRect (image, processedColorSimilarity);
+            return rect.isEmpty () ? image : image.copy (rect);
+        };
+    }
+    else if (name == QLatin1String ("reducecolors"))
+    {
+        ARGS (1, 2);
+        int depth;
+        if (!::ParseInt (args [0], 1, 8, &depth) || (depth != 1 && depth != 8)) {
+            return false;
+        }
+        if (args.count () == 2 && args [1].toLower () != QLatin1String ("dither")) {
+            return false;
+        }
+        const bool dither = (args.count () == 2);
+
+        *op = [depth, dither] (const kpImage &image) {
+            return kpEffectReduceColors::applyEffect (image, depth, dither);
+        };
+    }
+    else if (name == QLatin1String ("grayscale"))
+    {
+        ARGS (0, 0);
+        *op = [] (const kpImage &image) {
+            return kpEffectGrayscale::applyEffect (image);
+        };
+    }
+    else if (name == QLatin1String ("invert"))
+    {
+        ARGS (0, 0);
+        *op = [] (const kpImage &image) {
+            return kpEffectInvert::applyEffect (image);
+        };
+    }
+    else if (name == QLatin1String ("blur") || name == QLatin1String ("sharpen"))
+    {
+        ARGS (1, 1);
+        int strength;
+        if (!::ParseInt (args [0], kpEffectBlurSharpen::MinStrength + 1,
+                kpEffectBlurSharpen::MaxStrength, &strength))
+        {
+            return false;
+        }
+        const kpEffectBlurSharpen::Type type =
+            (name == QLatin1String ("blur")) ? kpEffectBlurSharpen::Blur : kpEffectBlurSharpen::Sharpen;
+
+        *op = [type, strength] (const kpImage &image) {
+            return kpEffectBlurSharpen::applyEffect (image, type, strength);
+        };
+    }
+    else if (name == QLatin1String ("emboss"))
+    {
+        ARGS (1, 1);
+        int strength;
+        if (!::ParseInt (args [0], kpEffectEmboss::MinStrength + 1,
+                kpEffectEmboss::MaxStrength, &strength))
+        {
+            return false;
+        }
+
+        *op = [strength] (const kpImage &image) {
+            return kpEffectEmboss::applyEffect (image, strength);
+        };
+    }
+    else if (name == QLatin1String ("flatten"))
+    {
+        ARGS (2, 2);
+        const QColor color1 (args [0]), color2 (args [1]);
+        if (!color1.isValid () || !color2.isValid ()) {
+            return false;
+        }
+
+        *op = [color1, color2] (const kpImage &image) {
+            return kpEffectFlatten::applyEffect (image, color1, color2);
+        };
+    }
+    else if (name == QLatin1String ("balance"))
+    {
+        ARGS (3, 3);
+        int brightness, contrast, gamma;
+        if (!::ParseInt (args [0], -50, 50, &brightness) ||
+            !::ParseInt (args [1], -50, 50, &contrast) ||
+            !::ParseInt (args [2], -50, 50, &gamma))
+        {
+            return false;
+        }
+
+        *op = [brightness, contrast, gamma] (const kpImage &image) {
+            return kpEffectBalance::applyEffect (image, kpEffectBalance::RGB,
+                brightness, contrast, gamma);
+        };
+    }
+    else if (name == QLatin1String ("hsv"))
+    {
+        ARGS (3, 3);
+        double hue, saturation, value;
+        if (!::ParseDouble (args [0], -180, 180, &hue) ||
+            !::ParseDouble (args [1], -1, 1, &saturation) ||
+            !::ParseDouble (args [2], -1, 1, &value))
+        {
+            return false;
+        }
+
+        *op = [hue, saturation, value] (const kpImage &image) {
+            return kpEffectHSV::applyEffect (image, hue, saturation, value);
+        };
+    }
+    else if (name == QLatin1String ("toneenhance"))
+    {
+        ARGS (2, 2);
+        double granularity, amount;
+        if (!::ParseDouble (args [0], 0, 1, &granularity) ||
+            !::ParseDouble (args [1], 0, 1, &amount))
+        {
+            return false;
+        }
+
+        *op = [granularity, amount] (const kpImage &image) {
+            return kpEffectToneEnhance::applyEffect (image, granularity, amount);
+        };
+    }
+    else
+    {
+        return false;
+    }
+
+#undef ARGS
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// Returns the mime type for the --format option, which may be a mime type
+// or a filename extension, or an empty string if it cannot be written.
+static QString ParseFormat (const QString &format)
+{
+    QMimeDatabase db;
+
+    QMimeType mimeType = db.mimeTypeForName (format);
+    if (!mimeType.isValid ())
+    {
+        mimeType = db.mimeTypeForFile (QLatin1String ("file.") + format,
+                                       QMimeDatabase::MatchExtension);
+    }
+
+    if (!QImageWriter::supportedMimeTypes ().contains (mimeType.name ().toLatin1 ())) {
+        return {};
+    }
+
+    return mimeType.name ();
+}
+
+//---------------------------------------------------------------------
+
+// Expands <arg>, which may be a wildcard pattern like "photos/*.jpg"
+// (shells don't expand quoted patterns nor ones that match too many
+// files), into <paths>.
+static void ExpandFileArgument (const QString &arg, QStringList *paths)
+{
+    if (!arg.contains (QLatin1Char ('*')) &&
+        !arg.contains (QLatin1Char ('?')) &&
+        !arg.contains (QLatin1Char ('[')))
+    {
+        paths->append (arg);
+        return;
+    }
+
+    const QFileInfo pattern (arg);
+    const QDir dir = pattern.dir ();
+    for (const QString &name : dir.entryList (QStringList (pattern.fileName ()),
+                                              QDir::Files, QDir::Name))
+    {
+        paths->append (dir.filePath (name));
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Decodes, processes and saves <file>.  Returns the report for PrintJson().
+static QJsonObject ProcessFile (const kpBatchFile &file,
+        const kpBatchOptions &options,
+        QSemaphore *memoryBudget)
+{
+    QJsonObject report;
+    report [QLatin1String ("file")] = file.inputPath;
+
+    auto fail = [&report] (const QString &error) {
+        report [QLatin1String ("status")] = QLatin1String ("error");
+        report [QLatin1String ("error")] = error;
+        return report;
+    };
+
+    QElapsedTimer timer;
+    timer.start ();
+
+    QImageReader reader (file.inputPath);
+    reader.setAutoTransform (true);
+
+    // Bound the memory used by all threads: reserve enough for the decoded
+    // image, a processed copy and one more for encoding, in MiB.  (An image
+    // too big for the whole budget waits for everything else to finish.)
+    const QSize size = reader.size ();
+    const qint64 bytesNeeded = size.isValid () ?
+        qint64 (size.width ()) * size.height () * 4 * 3 :
+        QFileInfo (file.inputPath).size () * 4;
+    const int memoryNeededMiB = int (qBound (qint64 (1),
+        bytesNeeded / (1024 * 1024) + 1,
+        qint64 (options.memoryLimitMiB)));
+    memoryBudget->acquire (memoryNeededMiB);
+    QSemaphoreReleaser memoryReleaser (memoryBudget, memoryNeededMiB);
+
+    report [QLatin1String ("waitMs")] = double (timer.restart ());
+
+    QImage image = reader.read ();
+    if (image.isNull ()) {
+        return fail (QLatin1String ("could not read: ") + reader.errorString ());
+    }
+
+    kpDocumentSaveOptions saveOptions;
+    kpDocumentMetaInfo metaInfo;
+    kpDocument::getDataFromImage (image, saveOptions, metaInfo);
+
+    // (as kpDocument::getPixmapFromFile() does)
+    if (image.format () != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    }
+
+    report [QLatin1String ("width")] = image.width ();
+    report [QLatin1String ("height")] = image.height ();
+    report [QLatin1String ("decodeMs")] = double (timer.restart ());
+
+    for (const kpBatchOperation &op : options.pipeline)
+    {
+        image = op (image);
+        if (image.isNull ()) {
+            return fail (QLatin1String ("out of memory"));
+        }
+    }
+
+    report [QLatin1String ("processMs")] = double (timer.restart ());
+
+    saveOptions.setMimeType (file.mimeType);
+    if (!kpDocumentSaveOptions::qualityIsInvalid (options.quality)) {
+        saveOptions.setQuality (options.quality);
+    }
+    if (!kpDocumentSaveOptions::colorDepthIsInvalid (options.colorDepth)) {
+        saveOptions.setColorDepth (options.colorDepth);
+    }
+
+    // sync: All failure exit paths _must_ call QSaveFile::cancelWriting().
+    QSaveFile atomicFileWriter (file.outputPath);
+    if (!atomicFileWriter.open (QIODevice::WriteOnly))
+    {
+        atomicFileWriter.cancelWriting ();
+        return fail (QLatin1String ("could not write: ") + atomicFileWriter.errorString ());
+    }
+
+    if (!kpDocument::savePixmapToDevice (image, &atomicFileWriter,
+                                         saveOptions, metaInfo,
+                                         false/*no lossy prompt*/,
+                                         nullptr/*no dialogs*/))
+    {
+        atomicFileWriter.cancelWriting ();
+        return fail (QLatin1String ("could not encode as ") + file.mimeType);
+    }
+
+    const qint64 outputBytes = atomicFileWriter.size ();
+    if (!atomicFileWriter.commit ())
+    {
+        atomicFileWriter.cancelWriting ();
+        return fail (QLatin1String ("could not write: ") + atomicFileWriter.errorString ());
+    }
+
+    report [QLatin1String ("encodeMs")] = double (timer.elapsed ());
+    report [QLatin1String ("output")] = file.outputPath;
+    report [QLatin1String ("outputWidth")] = image.width ();
+    report [QLatin1String ("outputHeight")] = image.height ();
+    report [QLatin1String ("outputBytes")] = double (outputBytes);
+    report [QLatin1String ("status")] = QLatin1String ("ok");
+    return report;
+}
+
+//---------------------------------------------------------------------
+
+class kpBatchTask : public QRunnable
+{
+public:
+    explicit kpBatchTask (const std::function <void ()> &func)
+        : m_func (func)
+    {
+    }
+
+    void run () override
+    {
+        m_func ();
+    }
+
+private:
+    const std::function <void ()> m_func;
+};
+
+//---------------------------------------------------------------------
+
+// public static
+void kpBatchProcessor::prepareEnvironment (int argc, char *argv [])
+{
+    bool batch = false;
+    for (int i = 1; i < argc && !batch; i++)
+    {
+        const QByteArray arg (argv [i]);
+        batch = (arg == "--" kpBatchOptionBatch || arg.startsWith ("--" kpBatchOptionBatch "="));
+    }
+
+    if (batch && qEnvironmentVariableIsEmpty ("QT_QPA_PLATFORM")) {
+        qputenv ("QT_QPA_PLATFORM", "offscreen");
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpBatchProcessor::addCommandLineOptions (QCommandLineParser *parser)
+{
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionBatch),
+        i18n ("Process the files without a GUI, applying the comma-separated"
+              " <pipeline> of operations e.g. \"autocrop,rotate:90,smoothscale:50%\"."
+              " Use \"--batch help\" to list the operations."),
+        i18n ("pipeline")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionOutput),
+        i18n ("Batch mode: the folder to save the processed files in."),
+        i18n ("folder")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionFilesFrom),
+        i18n ("Batch mode: read the files to process from <file>, one per line"
+              " (\"-\" for standard input)."),
+        i18n ("file")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionFormat),
+        i18n ("Batch mode: the format to save in, as a mime type or filename extension."
+              " Defaults to the format of each input file."),
+        i18n ("format")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionQuality),
+        i18n ("Batch mode: the quality to save in, for lossy formats (1-100)."),
+        i18n ("quality")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionColorDepth),
+        i18n ("Batch mode: the color depth to save in, for formats that support"
+              " several (1, 8 or 32)."),
+        i18n ("depth")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionJobs),
+        i18n ("Batch mode: the number of files to process at once."
+              " Defaults to the number of cores."),
+        i18n ("count")));
+    parser->addOption (QCommandLineOption (QStringLiteral (kpBatchOptionMemoryLimit),
+        i18n ("Batch mode: roughly how much memory, in MiB, images being"
+              " processed may take up at once.  Defaults to 1024."),
+        i18n ("MiB")));
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpBatchProcessor::isRequested (const QCommandLineParser &parser)
+{
+    return parser.isSet (QStringLiteral (kpBatchOptionBatch));
+}
+
+//---------------------------------------------------------------------
+
+// public static
+int kpBatchProcessor::run (const QCommandLineParser &parser)
+{
+    const QString pipelineSpec = parser.value (QStringLiteral (kpBatchOptionBatch));
+    if (pipelineSpec == QLatin1String ("help"))
+    {
+        std::fputs (OperationsHelp, stdout);
+        return 0;
+    }
+
+
+    //
+    // Options
+    //
+
+    kpBatchOptions options;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const auto skipEmptyParts = Qt::SkipEmptyParts;
+#else
+    const auto skipEmptyParts = QString::SkipEmptyParts;
+#endif
+    for (const QString &spec : pipelineSpec.split (QLatin1Char (','), skipEmptyParts))
+    {
+        kpBatchOperation op;
+        if (!::ParseOperation (spec, &op))
+        {
+            ::PrintError (i18n ("Invalid operation \"%1\" in --batch.", spec));
+            std::fputs (OperationsHelp, stderr);
+            return 2;
+        }
+
+        options.pipeline.append (op);
+    }
+
+    options.outputDir = parser.value (QStringLiteral (kpBatchOptionOutput));
+    if (options.outputDir.isEmpty ())
+    {
+        ::PrintError (i18n ("--batch needs an --output folder."));
+        return 2;
+    }
+    if (!QDir ().mkpath (options.outputDir))
+    {
+        ::PrintError (i18n ("Could not create the folder \"%1\".", options.outputDir));
+        return 2;
+    }
+
+    if (parser.isSet (QStringLiteral (kpBatchOptionFormat)))
+    {
+        const QString format = parser.value (QStringLiteral (kpBatchOptionFormat));
+        options.mimeType = ::ParseFormat (format);
+        if (options.mimeType.isEmpty ())
+        {
+            ::PrintError (i18n ("Cannot save in the format \"%1\".", format));
+            return 2;
+        }
+    }
+
+    if (parser.isSet (QStringLiteral (kpBatchOptionQuality)) &&
+        !::ParseInt (parser.value (QStringLiteral (kpBatchOptionQuality)), 1, 100, &options.quality))
+    {
+        ::PrintError (i18n ("--quality must be from 1 to 100."));
+        return 2;
+    }
+
+    if (parser.isSet (QStringLiteral (kpBatchOptionColorDepth)) &&
+        (!::ParseInt (parser.value (QStringLiteral (kpBatchOptionColorDepth)), 1, 32, &options.colorDepth) ||
+            (options.colorDepth != 1 && options.colorDepth != 8 && options.colorDepth != 32)))
+    {
+        ::PrintError (i18n ("--color-depth must be 1, 8 or 32."));
+        return 2;
+    }
+
+    options.jobs = QThread::idealThreadCount ();
+    if (parser.isSet (QStringLiteral (kpBatchOptionJobs)) &&
+        !::ParseInt (parser.value (QStringLiteral (kpBatchOptionJobs)), 1, 1024, &options.jobs))
+    {
+        ::PrintError (i18n ("--jobs must be a positive number."));
+        return 2;
+    }
+
+    if (parser.isSet (QStringLiteral (kpBatchOptionMemoryLimit)) &&
+        !::ParseInt (parser.value (QStringLiteral (kpBatchOptionMemoryLimit)), 1, INT_MAX,
+                     &options.memoryLimitMiB))
+    {
+        ::PrintError (i18n ("--memory-limit must be a positive number."));
+        return 2;
+    }
+
+
+    //
+    // Files
+    //
+
+    QStringList inputPaths;
+    for (const QString &arg : parser.positionalArguments ()) {
+        ::ExpandFileArgument (arg, &inputPaths);
+    }
+
+    if (parser.isSet (QStringLiteral (kpBatchOptionFilesFrom)))
+    {
+        const QString listName = parser.value (QStringLiteral (kpBatchOptionFilesFrom));
+
+        QFile list (listName);
+        const bool opened = (listName == QLatin1String ("-")) ?
+            list.open (stdin, QIODevice::ReadOnly | QIODevice::Text) :
+            list.open (QIODevice::ReadOnly | QIODevice::Text);
+        if (!opened)
+        {
+            ::PrintError (i18n ("Could not read \"%1\".", listName));
+            return 2;
+        }
+
+        while (!list.atEnd ())
+        {
+            const QString line = QString::fromLocal8Bit (list.readLine ()).trimmed ();
+            if (!line.isEmpty ()) {
+                ::ExpandFileArgument (line, &inputPaths);
+            }
+        }
+    }
+
+    if (inputPaths.isEmpty ())
+    {
+        ::PrintError (i18n ("--batch needs some files to process."));
+        return 2;
+    }
+
+    // Work out the output paths up front, so that clashes are found before
+    // anything is written.
+    //
+    // Outputs are named after their inputs, so e.g. "--output ." in the
+    // folder of the inputs, without a change of --format, would silently
+    // replace the originals.  Refuse to write over any input.
+    QSet <QString> canonicalInputPaths;
+    for (const QString &inputPath : inputPaths)
+    {
+        const QString canonicalPath = QFileInfo (inputPath).canonicalFilePath ();
+        if (!canonicalPath.isEmpty ()) {
+            canonicalInputPaths.insert (canonicalPath);
+        }
+    }
+
+    const QDir canonicalOutputDir (QFileInfo (options.outputDir).canonicalFilePath ());
+
+    QMimeDatabase db;
+    QList <kpBatchFile> files;
+    QHash <QString, QString> inputPathForOutputPath;
+    for (const QString &inputPath : inputPaths)
+    {
+        kpBatchFile file;
+        file.inputPath = inputPath;
+        file.mimeType = options.mimeType.isEmpty () ?
+            db.mimeTypeForFile (inputPath).name () :
+            options.mimeType;
+
+        const QString suffix = db.mimeTypeForName (file.mimeType).preferredSuffix ();
+        const QString outputName = QFileInfo (inputPath).completeBaseName () +
+            (suffix.isEmpty () ? QString () : QLatin1Char ('.') + suffix);
+        file.outputPath = QDir (options.outputDir).filePath (outputName);
+
+        if (canonicalInputPaths.contains (canonicalOutputDir.filePath (outputName)))
+        {
+            ::PrintError (i18n ("Saving \"%1\" would overwrite an input file."
+                                " Choose another --output folder or --format.",
+                                file.outputPath));
+            return 2;
+        }
+
+        const QString clash = inputPathForOutputPath.value (file.outputPath);
+        if (!clash.isEmpty ())
+        {
+            ::PrintError (i18n ("\"%1\" and \"%2\" would both be saved as \"%3\".",
+                                clash, inputPath, file.outputPath));
+            return 2;
+        }
+        inputPathForOutputPath.insert (file.outputPath, inputPath);
+
+        files.append (file);
+    }
+
+
+    //
+    // Process
+    //
+
+#if DEBUG_KP_BATCH_PROCESSOR
+    qCDebug(kpLogMisc) << "kpBatchProcessor::run() files=" << files.count ()
+                       << "jobs=" << options.jobs
+                       << "memoryLimitMiB=" << options.memoryLimitMiB;
+#endif
+
+    QSemaphore memoryBudget (options.memoryLimitMiB);
+
+    QMutex totalsMutex;
+    int succeeded = 0, failed = 0;
+    double inputMegapixels = 0;
+
+    QElapsedTimer timer;
+    timer.start ();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount (options.jobs);
+    for (const kpBatchFile &file : files)
+    {
+        pool.start (new kpBatchTask (
+            [&, file] ()
+            {
+                QElapsedTimer fileTimer;
+                fileTimer.start ();
+
+                QJsonObject report = ::ProcessFile (file, options, &memoryBudget);
+                report [QLatin1String ("totalMs")] = double (fileTimer.elapsed ());
+                ::PrintJson (report);
+
+                QMutexLocker locker (&totalsMutex);
+                if (report.value (QLatin1String ("status")).toString () == QLatin1String ("ok"))
+                {
+                    succeeded++;
+                    inputMegapixels += report.value (QLatin1String ("width")).toDouble () *
+                                       report.value (QLatin1String ("height")).toDouble () / 1e6;
+                }
+                else {
+                    failed++;
+                }
+            }));
+    }
+    pool.waitForDone ();
+
+    const double seconds = qMax (qint64 (1), timer.elapsed ()) / 1000.0;
+
+    QJsonObject summary;
+    summary [QLatin1String ("summary")] = true;
+    summary [QLatin1String ("files")] = files.count ();
+    summary [QLatin1String ("succeeded")] = succeeded;
+    summary [QLatin1String ("failed")] = failed;
+    summary [QLatin1String ("jobs")] = options.jobs;
+    summary [QLatin1String ("elapsedMs")] = double (timer.elapsed ());
+    summary [QLatin1String ("filesPerSecond")] = files.count () / seconds;
+    summary [QLatin1String ("megapixelsPerSecond")] = inputMegapixels / seconds;
+    ::PrintJson (summary);
+
+    return failed ? 1 : 0;
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,70 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef KP_BATCH_PROCESSOR_H
+#define KP_BATCH_PROCESSOR_H
+
+
+class QCommandLineParser;
+
+
+//
+// "kolourpaint --batch <pipeline> --output <dir> <files...>" applies a
+// pipeline of image operations to many files, without a GUI, using all
+// cores.
+//
+// The pipeline is a comma-separated list of operations, each of which
+// may take colon-separated arguments e.g.
+//
+//     autocrop,rotate:90,smoothscale:50%,reducecolors:8:dither
+//
+// See OperationsHelp in kpBatchProcessor.cpp for the full list.
+//
+// A JSON object is printed on stdout per file, as each finishes, with its
+// timings, followed by one summarizing the throughput.  This makes the
+// output easy to process with other tools.
+//
+class kpBatchProcessor
+{
+public:
+    // Call before constructing the QApplication.  Batch mode does not need
+    // a display so, unless the user has chosen a platform plugin, this
+    // selects "offscreen".
+    static void prepareEnvironment (int argc, char *argv []);
+
+    static void addCommandLineOptions (QCommandLineParser *parser);
+    static bool isRequested (const QCommandLineParser &parser);
+
+    // Processes the files given on the command line.  Returns the exit
+    // status: 0 if all files were processed, 1 if some failed and 2 if
+    // the command line was invalid.
+    static int run (const QCommandLineParser &parser);
+};
+
+
+#endif  // KP_BATCH_PROCESSOR_H
@@ -67,6 +67,7 @@
 #define kpSettingDitherOnOpen "Dither on Open if Screen is 15/16bpp and Image Num Colors More Than"
 #define kpSettingPrintImageCenteredOnPage "Print Image Centered On Page"
 #define kpSettingOpenImagesInSameWindow "Open Images in the Same Window"
+#define kpSettingViewUpdateFrameRate "View Update Frame Rate"
 
 #define kpSettingsGroupFileSaveAs "File/Save As"
 #define kpSettingsGroupFileExport "File/Export"
@@ -108,6 +109,7 @@
 #define kpSettingsGroupTools "Tool Settings"
 #define kpSettingLastTool "Last Used Tool"
 #define kpSettingToolBoxIconSize "Tool Box Icon Size"
+#define kpSettingSpraycanDensity "Spraycan Density"
 
 
 #define kpSettingsGroupText "Text Settings"
@@ -66,6 +66,22 @@ struct kpAbstractImageSelectionPrivate
     // The mask for the image, after selection transparency (a.k.a. background
     // subtraction) is applied.
     QBitmap transparencyMaskCache;  // OPT: calculate lazily i.e. on-demand only
+
+    // <baseImage> with <transparencyMaskCache> applied i.e. transparentImage().
+    // Only valid if <transparentImageCacheValid>.
+    mutable kpImage transparentImageCache;
+    mutable bool transparentImageCacheValid = false;
+
+    // calculatePoints() and shapeRegion(), relative to the selection's
+    // top-left.  Only valid if <shapeCacheValid>.
+    mutable QPolygon pointsCache;
+    mutable QRegion shapeRegionCache;
+    mutable bool shapeCacheValid = false;
+
+    // If not null, <baseImage> is this scaled to the selection's size and
+    // is only calculated when it is asked for.  See setBaseImageScaledFrom().
+    mutable kpImage scaledFromImage;
+    mutable kpImage scaledFromTransparentImage;
 };
 
 //---------------------------------------------------------------------
@@ -115,10 +131,21 @@ kpAbstractImageSelection &kpAbstractImageSelection::operator= (
     kpAbstractSelection::operator= (rhs);
 
     d->baseImage = rhs.d->baseImage;
+    d->scaledFromImage = rhs.d->scaledFromImage;
+    d->scaledFromTransparentImage = rhs.d->scaledFromTransparentImage;
 
     d->transparency = rhs.d->transparency;
     d->transparencyMaskCache = rhs.d->transparencyMaskCache;
 
+    // <rhs> has the same image and shape so its caches are just as good
+    // (and are implicitly shared, so this is cheap).
+    d->transparentImageCache = rhs.d->transparentImageCache;
+    d->transparentImageCacheValid = rhs.d->transparentImageCacheValid;
+
+    d->pointsCache = rhs.d->pointsCache;
+    d->shapeRegionCache = rhs.d->shapeRegionCache;
+    d->shapeCacheValid = rhs.d->shapeCacheValid;
+
     return *this;
 }
 
@@ -156,7 +183,9 @@ bool kpAbstractImageSelection::readFromStream (QDataStream &stream)
             return false;
         }
 
-        d->baseImage = qimage;
+        // The image comes from PNG, so is not premultiplied.  Same as
+        // setBaseImage().
+        d->baseImage = qimage.convertToFormat (QImage::Format_ARGB32_Premultiplied);
     }
     // (was just a selection border in the clipboard, even though KolourPaint's
     //  GUI doesn't allow you to copy such a thing into the clipboard)
@@ -164,6 +193,13 @@ bool kpAbstractImageSelection::readFromStream (QDataStream &stream)
         d->baseImage = kpImage ();
     }
 
+    d->scaledFromImage = kpImage ();
+    d->scaledFromTransparentImage = kpImage ();
+    d->transparentImageCacheValid = false;
+    // Subclasses read their shape after calling us but the cache is only
+    // rebuilt on demand.
+    invalidateShapeCache ();
+
     // TODO: Reset transparency mask?
     // TODO: Concrete subclass need to emit changed()?
     //       [we can't since changed() must be called after all reading
@@ -179,6 +215,8 @@ void kpAbstractImageSelection::writeToStream (QDataStream &stream) const
 {
     kpAbstractSelection::writeToStream (stream);
 
+    scaleBaseImageIfNeeded ();
+
     if (!d->baseImage.isNull ())
     {
         const QImage image = d->baseImage;
@@ -209,6 +247,8 @@ QString kpAbstractImageSelection::name () const
 // public virtual [base kpAbstractSelection]
 kpCommandSize::SizeType kpAbstractImageSelection::size () const
 {
+    scaleBaseImageIfNeeded ();
+
     return kpAbstractSelection::size () +
         kpCommandSize::ImageSize (d->baseImage) +
         (d->transparencyMaskCache.width() * d->transparencyMaskCache.height()) / 8;
@@ -219,6 +259,8 @@ kpCommandSize::SizeType kpAbstractImageSelection::size () const
 // public
 kpCommandSize::SizeType kpAbstractImageSelection::sizeWithoutImage () const
 {
+    scaleBaseImageIfNeeded ();
+
     return (size () - kpCommandSize::ImageSize (d->baseImage));
 }
 
@@ -255,8 +297,7 @@ QBitmap kpAbstractImageSelection::shapeBitmap (bool nullForRectangular) const
         painter.setPen (Qt::color1/*opaque*/);
         painter.setBrush (Qt::color1/*opaque*/);
 
-        QPolygon points = calculatePoints ();
-        points.translate (-x (), -y ());
+        const QPolygon points = cachedPoints ().translated (-x (), -y ());
 
         // Unlike QPainter::drawRect(), this draws the points literally
         // without being 1 pixel wider and higher.  This requires a QPen
@@ -282,7 +323,7 @@ kpImage kpAbstractImageSelection::givenImageMaskedByShape (const kpImage &image)
         return image;
     }
 
-    const QRegion mRegion = shapeRegion ().translated (-topLeft ());
+    const QRegion mRegion = cachedShapeRegion ().translated (-topLeft ());
 
 #if DEBUG_KP_SELECTION
     qCDebug(kpLogLayers) << "\tshapeRegion=" << shapeRegion ()
@@ -305,10 +346,47 @@ kpImage kpAbstractImageSelection::givenImageMaskedByShape (const kpImage &image)
 
 //---------------------------------------------------------------------
 
+// protected
+QPolygon kpAbstractImageSelection::cachedPoints () const
+{
+    if (!d->shapeCacheValid)
+    {
+        d->pointsCache = calculatePoints ().translated (-topLeft ());
+        d->shapeRegionCache = shapeRegion ().translated (-topLeft ());
+        d->shapeCacheValid = true;
+    }
+
+    return d->pointsCache.translated (topLeft ());
+}
+
+//---------------------------------------------------------------------
+
+// protected
+QRegion kpAbstractImageSelection::cachedShapeRegion () const
+{
+    if (!d->shapeCacheValid) {
+        (void) cachedPoints ();
+    }
+
+    return d->shapeRegionCache.translated (topLeft ());
+}
+
+//---------------------------------------------------------------------
+
+// protected
+void kpAbstractImageSelection::invalidateShapeCache ()
+{
+    d->shapeCacheValid = false;
+    d->pointsCache = QPolygon ();
+    d->shapeRegionCache = QRegion ();
+}
+
+//---------------------------------------------------------------------
+
 // public virtual [kpAbstractSelection]
 bool kpAbstractImageSelection::hasContent () const
 {
-    return !d->baseImage.isNull ();
+    return !d->baseImage.isNull () || !d->scaledFromImage.isNull ();
 }
 
 //---------------------------------------------------------------------
@@ -329,6 +407,8 @@ void kpAbstractImageSelection::deleteContent ()
 // public
 kpImage kpAbstractImageSelection::baseImage () const
 {
+    scaleBaseImageIfNeeded ();
+
     return d->baseImage;
 }
 
@@ -342,6 +422,8 @@ void kpAbstractImageSelection::setBaseImage (const kpImage &baseImage)
     // qt doc: the image format must be set to Format_ARGB32Premultiplied or Format_ARGB32
     // for the composition modes to have any effect
     d->baseImage = baseImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    d->scaledFromImage = kpImage ();
+    d->scaledFromTransparentImage = kpImage ();
 
     recalculateTransparencyMaskCache ();
 
@@ -367,6 +449,8 @@ bool kpAbstractImageSelection::setTransparency (
         return false;
     }
 
+    scaleBaseImageIfNeeded ();
+
     d->transparency = transparency;
 
     bool haveChanged = true;
@@ -424,67 +508,133 @@ bool kpAbstractImageSelection::setTransparency (
 
 //---------------------------------------------------------------------
 
-// private
-void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
+// Returns the mask for <baseImage>, after selection <transparency> (a.k.a.
+// background subtraction) is applied, or a null bitmap if that would not
+// make any pixel transparent.
+static QBitmap CalculateTransparencyMask (const kpImage &baseImage,
+        const kpImageSelectionTransparency &transparency)
 {
-#if DEBUG_KP_SELECTION
-    qCDebug(kpLogLayers) << "kpAbstractImageSelection::recalculateTransparencyMaskCache()";
-#endif
-
-    if (d->baseImage.isNull ())
+    if (baseImage.isNull ())
     {
     #if DEBUG_KP_SELECTION
         qCDebug(kpLogLayers) << "\tno image - no need for transparency mask";
     #endif
-        d->transparencyMaskCache = QBitmap ();
-        return;
+        return {};
     }
 
-    if (d->transparency.isOpaque ())
+    if (transparency.isOpaque ())
     {
     #if DEBUG_KP_SELECTION
         qCDebug(kpLogLayers) << "\topaque - no need for transparency mask";
     #endif
-        d->transparencyMaskCache = QBitmap ();
-        return;
+        return {};
     }
 
-    d->transparencyMaskCache = QBitmap(d->baseImage.size());
+    // Build the mask a scanline at a time, rather than with a QPainter
+    // drawPoint() per pixel.  setBaseImage() guarantees the format.
+    Q_ASSERT (baseImage.format () == QImage::Format_ARGB32_Premultiplied);
+
+    QImage maskImage (baseImage.size (), QImage::Format_MonoLSB);
+    maskImage.setColorCount (2);
+    maskImage.setColor (0, QColor (Qt::color0).rgb ()/*opaque*/);
+    maskImage.setColor (1, QColor (Qt::color1).rgb ()/*transparent*/);
+    maskImage.fill (0);
 
-    QPainter transparencyMaskPainter (&d->transparencyMaskCache);
+    const kpColor transparentColor = transparency.transparentColor ();
+    const int processedColorSimilarity = transparency.processedColorSimilarity ();
 
     bool hasTransparent = false;
-    for (int y = 0; y < d->baseImage.height (); y++)
+    for (int y = 0; y < baseImage.height (); y++)
     {
-        for (int x = 0; x < d->baseImage.width (); x++)
+        const auto *srcLine = reinterpret_cast<const QRgb *> (baseImage.constScanLine (y));
+        uchar *maskLine = maskImage.scanLine (y);
+
+        for (int x = 0; x < baseImage.width (); x++)
         {
-            const kpColor pixelCol = kpPixmapFX::getColorAtPixel (d->baseImage, x, y);
+            // Same as kpPixmapFX::getColorAtPixel().
+            const kpColor pixelCol (qUnpremultiply (srcLine [x]));
             if (pixelCol == kpColor::Transparent ||
-                pixelCol.isSimilarTo (d->transparency.transparentColor (),
-                                      d->transparency.processedColorSimilarity ()))
+                pixelCol.isSimilarTo (transparentColor, processedColorSimilarity))
             {
-                transparencyMaskPainter.setPen (Qt::color1/*transparent*/);
+                maskLine [x >> 3] |= (1 << (x & 7));
                 hasTransparent = true;
             }
-            else
-            {
-                transparencyMaskPainter.setPen (Qt::color0/*opaque*/);
-            }
-
-            transparencyMaskPainter.drawPoint (x, y);
         }
     }
 
-    transparencyMaskPainter.end ();
-
     if (!hasTransparent)
     {
     #if DEBUG_KP_SELECTION
         qCDebug(kpLogLayers) << "\tcolour useless - completely opaque";
     #endif
-        d->transparencyMaskCache = QBitmap ();
+        return {};
+    }
+
+    return QBitmap::fromImage (maskImage);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
+{
+#if DEBUG_KP_SELECTION
+    qCDebug(kpLogLayers) << "kpAbstractImageSelection::recalculateTransparencyMaskCache()";
+#endif
+
+    d->transparentImageCacheValid = false;
+
+    d->transparencyMaskCache = ::CalculateTransparencyMask (d->baseImage,
+                                                            d->transparency);
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpAbstractImageSelection::setBaseImageScaledFrom (const kpImage &image,
+        const kpImage &transparentImage)
+{
+    Q_ASSERT (!image.isNull ());
+    Q_ASSERT (image.size () == transparentImage.size ());
+
+    d->baseImage = kpImage ();
+    d->transparencyMaskCache = QBitmap ();
+    d->transparentImageCacheValid = false;
+
+    d->scaledFromImage = image;
+    d->scaledFromTransparentImage = transparentImage;
+
+    emit changed (boundingRect ());
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpAbstractImageSelection::scaleBaseImageIfNeeded () const
+{
+    if (d->scaledFromImage.isNull ()) {
         return;
     }
+
+#if DEBUG_KP_SELECTION
+    qCDebug(kpLogLayers) << "kpAbstractImageSelection::scaleBaseImageIfNeeded() "
+                         << d->scaledFromImage.size () << "->" << boundingRect ().size ();
+#endif
+
+    // Nearest neighbour scaling commutes with applying the transparency so
+    // the transparent image can be scaled separately.
+    d->baseImage = kpPixmapFX::scale (d->scaledFromImage, width (), height ())
+        .convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    d->transparencyMaskCache = ::CalculateTransparencyMask (d->baseImage,
+                                                            d->transparency);
+
+    d->transparentImageCache = kpPixmapFX::scale (d->scaledFromTransparentImage,
+                                                  width (), height ())
+        .convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    d->transparentImageCacheValid = true;
+
+    d->scaledFromImage = kpImage ();
+    d->scaledFromTransparentImage = kpImage ();
 }
 
 //---------------------------------------------------------------------
@@ -492,16 +642,24 @@ void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
 // public
 kpImage kpAbstractImageSelection::transparentImage () const
 {
-    kpImage image = baseImage ();
+    scaleBaseImageIfNeeded ();
 
-    if (!d->transparencyMaskCache.isNull ())
+    if (!d->transparentImageCacheValid)
     {
-      QPainter painter(&image);
-      painter.setCompositionMode(QPainter::CompositionMode_Clear);
-      painter.drawPixmap(0, 0, d->transparencyMaskCache);
+        kpImage image = baseImage ();
+
+        if (!d->transparencyMaskCache.isNull ())
+        {
+          QPainter painter(&image);
+          painter.setCompositionMode(QPainter::CompositionMode_Clear);
+          painter.drawPixmap(0, 0, d->transparencyMaskCache);
+        }
+
+        d->transparentImageCache = image;
+        d->transparentImageCacheValid = true;
     }
 
-    return image;
+    return d->transparentImageCache;
 }
 
 //---------------------------------------------------------------------
@@ -533,12 +691,14 @@ void kpAbstractImageSelection::flip (bool horiz, bool vert)
                << ",vert=" << vert << ")";
 #endif
 
+    scaleBaseImageIfNeeded ();
+
     if (!d->baseImage.isNull ())
     {
     #if DEBUG_KP_SELECTION && 1
         qCDebug(kpLogLayers) << "\thave pixmap - flipping that";
     #endif
-        d->baseImage = d->baseImage.mirrored(horiz, vert);
+        kpPixmapFX::flip (&d->baseImage, horiz, vert);
     }
 
     if (!d->transparencyMaskCache.isNull ())
@@ -550,6 +710,14 @@ void kpAbstractImageSelection::flip (bool horiz, bool vert)
         d->transparencyMaskCache = QBitmap::fromImage(image);
     }
 
+    if (d->transparentImageCacheValid && !d->transparentImageCache.isNull ())
+    {
+        kpPixmapFX::flip (&d->transparentImageCache, horiz, vert);
+    }
+
+    // Our subclasses have already flipped their shape.
+    invalidateShapeCache ();
+
     emit changed (boundingRect ());
 }
 
@@ -558,12 +726,33 @@ void kpAbstractImageSelection::flip (bool horiz, bool vert)
 static void Paint (const kpAbstractImageSelection *sel, const kpImage &srcImage,
                    QImage *destImage, const QRect &docRect)
 {
-    if (!srcImage.isNull ())
+    if (srcImage.isNull ()) {
+        return;
+    }
+
+    // Only composite the part of the selection that is inside <docRect>,
+    // rather than relying on QPainter to clip the whole image.
+    const QRect rect = sel->boundingRect () & docRect;
+    if (rect.isEmpty ()) {
+        return;
+    }
+
+    QPainter painter (destImage);
+
+    if (srcImage.width () != sel->width () || srcImage.height () != sel->height ())
     {
-        kpPixmapFX::paintPixmapAt (destImage,
-                                   sel->topLeft () - docRect.topLeft (),
-                                   srcImage);
+        // Scale (nearest neighbour, as there is no SmoothPixmapTransform)
+        // just the part being painted.  See setBaseImageScaledFrom().
+        painter.setClipRect (rect.translated (-docRect.topLeft ()));
+        painter.drawImage (QRect (sel->topLeft () - docRect.topLeft (),
+                                  QSize (sel->width (), sel->height ())),
+                           srcImage);
+        return;
     }
+
+    painter.drawImage (rect.topLeft () - docRect.topLeft (),
+                       srcImage,
+                       rect.translated (-sel->topLeft ()));
 }
 
 //---------------------------------------------------------------------
@@ -572,7 +761,10 @@ static void Paint (const kpAbstractImageSelection *sel, const kpImage &srcImage,
 void kpAbstractImageSelection::paint (QImage *destImage,
         const QRect &docRect) const
 {
-    ::Paint (this, transparentImage (), destImage, docRect);
+    ::Paint (this,
+             d->scaledFromImage.isNull () ? transparentImage () :
+                                            d->scaledFromTransparentImage,
+             destImage, docRect);
 }
 
 //---------------------------------------------------------------------
@@ -581,7 +773,9 @@ void kpAbstractImageSelection::paint (QImage *destImage,
 void kpAbstractImageSelection::paintWithBaseImage (QImage *destImage,
         const QRect &docRect) const
 {
-    ::Paint (this, baseImage (), destImage, docRect);
+    ::Paint (this,
+             d->scaledFromImage.isNull () ? baseImage () : d->scaledFromImage,
+             destImage, docRect);
 }
 
 //---------------------------------------------------------------------
@@ -181,9 +181,24 @@ public:
     // Note: This must be consistent with the outputs of calculatePoints() and
     //       shapeRegion().
     //
-    // OPT: QRegion is probably incredibly slow - cache
+    // Use cachedShapeRegion() instead when calling this repeatedly.
     virtual QRegion shapeRegion () const = 0;
 
+protected:
+    // Cached versions of calculatePoints() and shapeRegion().
+    //
+    // The cache is kept relative to the selection's top-left so that
+    // moving the selection does not invalidate it.  It is only rebuilt
+    // after the shape changes (flip(), operator=(), readFromStream()).
+    QPolygon cachedPoints () const;
+    QRegion cachedShapeRegion () const;
+
+    // Subclasses that change their shape, without going through one of
+    // the above methods, must call this.
+    void invalidateShapeCache ();
+
+public:
+
     // Returns the given <image> with the pixels outside of the selection's
     // shape set to transparent.
     //
@@ -207,6 +222,21 @@ public:
     kpImage baseImage () const;
     void setBaseImage (const kpImage &baseImage);
 
+    // Sets the base image to <image> scaled to the selection's size, with
+    // nearest neighbour sampling.  <transparentImage> must be <image> after
+    // applying transparency().
+    //
+    // The scaled image is only calculated when something asks for it.
+    // Until then, paint() scales just the part of <image> being painted.
+    // This is for previewing interactive resizes, which replace the
+    // selection on every mouse move.
+    void setBaseImageScaledFrom (const kpImage &image,
+                                 const kpImage &transparentImage);
+
+private:
+    // Calculates the base image if it was set by setBaseImageScaledFrom().
+    void scaleBaseImageIfNeeded () const;
+
 
 //
 // Background Subtraction
@@ -230,7 +260,11 @@ private:
     void recalculateTransparencyMaskCache ();
 
 public:
-    // Returns baseImage() after applying kpImageSelectionTransparency
+    // Returns baseImage() after applying kpImageSelectionTransparency.
+    //
+    // This is cached, in premultiplied form ready to be composited onto
+    // the document, and is only recalculated after the base image or the
+    // transparency changes.
     kpImage transparentImage () const;
 
 
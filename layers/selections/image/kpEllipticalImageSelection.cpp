@@ -163,7 +163,7 @@ bool kpEllipticalImageSelection::contains (const QPoint &point) const
         return false;
     }
 
-    return shapeRegion ().contains (point);
+    return cachedShapeRegion ().contains (point);
 }
 
 //---------------------------------------------------------------------
@@ -177,7 +177,7 @@ void kpEllipticalImageSelection::paintBorder (QImage *destPixmap, const QRect &d
       return;
     }
 
-    paintPolygonalBorder (calculatePoints (),
+    paintPolygonalBorder (cachedPoints (),
         destPixmap, docRect,
         selectionFinished);
 }
@@ -311,7 +311,7 @@ bool kpFreeFormImageSelection::contains (const QPoint &point) const
     // We can't use the baseImage() (when non-null) and get the transparency of
     // the pixel at <point>, instead of this region test, as the pixel may be
     // transparent but still within the border.
-    return shapeRegion ().contains (point);
+    return cachedShapeRegion ().contains (point);
 }
 
 
@@ -33,6 +33,7 @@
 
 #include <QDataStream>
 #include <QImage>
+#include <QStringList>
 #include <QUrl>
 
 #include "kpLogCategories.h"
@@ -43,6 +44,10 @@
 
 //---------------------------------------------------------------------
 
+// public static
+const char * const kpSelectionDrag::RawSelectionMimeType =
+    "application/x-kolourpaint-selection-500";
+
 // public static
 const char * const kpSelectionDrag::SelectionMimeType =
     "application/x-kolourpaint-selection-400";
@@ -50,6 +55,7 @@ const char * const kpSelectionDrag::SelectionMimeType =
 //---------------------------------------------------------------------
 
 kpSelectionDrag::kpSelectionDrag (const kpAbstractImageSelection &sel)
+    : m_selection (sel.clone ())
 {
 #if DEBUG_KP_SELECTION_DRAG && 1
     qCDebug(kpLogLayers) << "kpSelectionDrag() w=" << sel.width ()
@@ -57,30 +63,78 @@ kpSelectionDrag::kpSelectionDrag (const kpAbstractImageSelection &sel)
 #endif
 
     Q_ASSERT (sel.hasContent ());
+}
 
-    // Store as selection.
-    QByteArray ba;
-    {
-        QDataStream stream (&ba, QIODevice::WriteOnly);
-        stream << sel;
-    }
-    setData (kpSelectionDrag::SelectionMimeType, ba);
+//---------------------------------------------------------------------
 
-    // Store as image (so that QMimeData::hasImage()) works).
-    // OPT: an awful waste of memory storing image in both selection and QImage
-    const QImage image = sel.baseImage ();
-#if DEBUG_KP_SELECTION_DRAG && 1
-    qCDebug(kpLogLayers) << "\timage: w=" << image.width ()
-               << " h=" << image.height ();
+kpSelectionDrag::~kpSelectionDrag ()
+{
+    delete m_selection;
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [base QMimeData]
+QStringList kpSelectionDrag::formats () const
+{
+    // The image one is what QMimeData::setImageData() would have added,
+    // so that hasImage() works and the platform clipboard offers the usual
+    // image formats (e.g. image/png), converting from imageData().
+    return QStringList ()
+        << QLatin1String (kpSelectionDrag::RawSelectionMimeType)
+        << QLatin1String (kpSelectionDrag::SelectionMimeType)
+        << QStringLiteral ("application/x-qt-image");
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [base QMimeData]
+bool kpSelectionDrag::hasFormat (const QString &mimeType) const
+{
+    return formats ().contains (mimeType);
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base QMimeData]
+QVariant kpSelectionDrag::retrieveData (const QString &mimeType, QVariant::Type type) const
+{
+#if DEBUG_KP_SELECTION_DRAG
+    qCDebug(kpLogLayers) << "kpSelectionDrag::retrieveData(" << mimeType
+                         << "," << type << ")";
 #endif
-    if (image.isNull ())
+
+    if (mimeType == QLatin1String (kpSelectionDrag::RawSelectionMimeType)) {
+        return kpSelectionFactory::ToRawData (*m_selection);
+    }
+
+    if (mimeType == QLatin1String (kpSelectionDrag::SelectionMimeType))
     {
-        // TODO: proper error handling.
-        qCCritical(kpLogLayers) << "kpSelectionDrag::setSelection() could not convert to image";
+        QByteArray ba;
+        {
+            QDataStream stream (&ba, QIODevice::WriteOnly);
+            stream << *m_selection;
+        }
+        return ba;
     }
-    else {
-        setImageData (image);
+
+    if (mimeType == QLatin1String ("application/x-qt-image"))
+    {
+        const QImage image = m_selection->baseImage ();
+    #if DEBUG_KP_SELECTION_DRAG && 1
+        qCDebug(kpLogLayers) << "\timage: w=" << image.width ()
+                   << " h=" << image.height ();
+    #endif
+        if (image.isNull ())
+        {
+            // TODO: proper error handling.
+            qCCritical(kpLogLayers) << "kpSelectionDrag::retrieveData() could not convert to image";
+        }
+
+        return image;
     }
+
+    return QMimeData::retrieveData (mimeType, type);
 }
 
 //---------------------------------------------------------------------
@@ -97,7 +151,8 @@ bool kpSelectionDrag::canDecode(const QMimeData *mimeData)
 #endif
 
     // mimeData->hasImage() would not check if the data is a valid image
-    return mimeData->hasFormat(kpSelectionDrag::SelectionMimeType) ||
+    return mimeData->hasFormat(kpSelectionDrag::RawSelectionMimeType) ||
+           mimeData->hasFormat(kpSelectionDrag::SelectionMimeType) ||
            !qvariant_cast<QImage>(mimeData->imageData()).isNull();
 }
 
@@ -111,6 +166,30 @@ kpAbstractImageSelection *kpSelectionDrag::decode(const QMimeData *mimeData)
 #endif
     Q_ASSERT (mimeData);
 
+    // Copied from this process?  Then there is no need to encode and
+    // decode the selection.
+    const auto *selectionDrag = qobject_cast <const kpSelectionDrag *> (mimeData);
+    if (selectionDrag)
+    {
+    #if DEBUG_KP_SELECTION_DRAG
+        qCDebug(kpLogLayers) << "\tmimeSource is our kpSelectionDrag - clone its selection";
+    #endif
+        return selectionDrag->m_selection->clone ();
+    }
+
+    if (mimeData->hasFormat (kpSelectionDrag::RawSelectionMimeType))
+    {
+        kpAbstractImageSelection *sel = kpSelectionFactory::FromRawData (
+            mimeData->data (kpSelectionDrag::RawSelectionMimeType));
+        if (sel) {
+            return sel;
+        }
+
+    #if DEBUG_KP_SELECTION_DRAG
+        qCDebug(kpLogLayers) << "\tinvalid or newer raw selection - try the other formats";
+    #endif
+    }
+
     if (mimeData->hasFormat (kpSelectionDrag::SelectionMimeType))
     {
     #if DEBUG_KP_SELECTION_DRAG
@@ -33,19 +33,42 @@
 class kpAbstractImageSelection;
 
 
+//
+// Clipboard and drag data for an image selection.
+//
+// The formats are only produced when something asks for them, through
+// retrieveData().  Until then, only a copy of the selection is held,
+// which shares its image with the original.  Pasting back into
+// KolourPaint, from the same process, copies the selection directly.
+//
 class kpSelectionDrag : public QMimeData
 {
   Q_OBJECT
 
   public:
+    // The fast format (see kpSelectionFactory::ToRawData()), preferred
+    // when both ends support it.
+    static const char * const RawSelectionMimeType;
+    // The original format, which stores the image as PNG.  Still offered
+    // and accepted, for older versions of KolourPaint.
     static const char * const SelectionMimeType;
 
     // ASSUMPTION: <sel> has content (is not just a border).
     kpSelectionDrag(const kpAbstractImageSelection &sel);
+    ~kpSelectionDrag() override;
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+  protected:
+    QVariant retrieveData(const QString &mimeType, QVariant::Type type) const override;
 
   public:
     static bool canDecode(const QMimeData *mimeData);
     static kpAbstractImageSelection *decode(const QMimeData *mimeData);
+
+  private:
+    kpAbstractImageSelection *m_selection;
 };
 
 
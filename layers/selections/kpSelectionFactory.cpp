@@ -31,14 +31,277 @@
 
 #include "kpSelectionFactory.h"
 
+#include <climits>
+
+#include <QByteArray>
 #include <QDataStream>
+#include <QPolygon>
+#include <QtEndian>
+
+#include "kpLogCategories.h"
 
+#include "imagelib/kpColor.h"
 #include "layers/selections/image/kpRectangularImageSelection.h"
 #include "layers/selections/image/kpEllipticalImageSelection.h"
 #include "layers/selections/image/kpFreeFormImageSelection.h"
 
 //---------------------------------------------------------------------
 
+// The raw format is a QDataStream header followed by the pixels:
+//
+//     quint32 RawMagic
+//     quint32 version (RawVersion)
+//     qint32 serialID
+//     QRect boundingRect
+//     bool isOpaque, kpColor transparentColor, double colorSimilarity
+//     QPolygon points (the originalPoints() of free-form selections,
+//                      otherwise empty)
+//     qint32 width, height (0x0 if the selection has no content)
+//     quint8 pixelFormat (RawPixelFormatARGB32Premultiplied)
+//     quint8 byteOrder (QSysInfo::Endian of the writer, for the pixels)
+//     quint8 compression (RawCompressionNone)
+//     qint64 byteCount (width * height * 4)
+//     <byteCount bytes of rows, top to bottom, without padding>
+//
+// Bump RawVersion if this changes.  Readers reject versions newer than
+// they know, falling back to kpSelectionDrag::SelectionMimeType.
+static const quint32 RawMagic = 0x4B50534C;  // "KPSL"
+static const quint32 RawVersion = 1;
+
+static const quint8 RawPixelFormatARGB32Premultiplied = 0;
+
+// zlib, even at its fastest, is much slower than copying the pixels
+// across, so they are always stored uncompressed for now.
+static const quint8 RawCompressionNone = 0;
+
+static const int RawBytesPerPixel = 4;
+
+// How QDataStream writes a QPoint.
+static const int RawBytesPerPoint = 8;
+
+// More than everything before the points takes.
+static const int RawMaxHeaderBytes = 128;
+
+// A QByteArray cannot quite hold INT_MAX bytes, as its allocation also
+// includes a header and a terminating nul.
+static const qint64 RawMaxBytes = INT_MAX - 64;
+
+//---------------------------------------------------------------------
+
+// public static
+QByteArray kpSelectionFactory::ToRawData (const kpAbstractImageSelection &sel)
+{
+    QImage image = sel.baseImage ();
+    if (!image.isNull () && image.format () != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const int rowBytes = image.width () * RawBytesPerPixel;
+    const qint64 byteCount = qint64 (rowBytes) * image.height ();
+
+    QPolygon points;
+    if (const auto *freeFormSel = dynamic_cast <const kpFreeFormImageSelection *> (&sel)) {
+        points = freeFormSel->originalPoints ();
+    }
+
+    // Too big to fit?  Then the other formats are used instead.
+    const qint64 maxRawBytes = RawMaxHeaderBytes +
+        qint64 (points.count ()) * RawBytesPerPoint + byteCount;
+    if (maxRawBytes > RawMaxBytes)
+    {
+    #if DEBUG_KP_SELECTION && 1
+        qCDebug(kpLogLayers) << "kpSelectionFactory::ToRawData() too big:" << maxRawBytes;
+    #endif
+        return {};
+    }
+
+    QByteArray data;
+    data.reserve (int (maxRawBytes));
+
+    QDataStream stream (&data, QIODevice::WriteOnly);
+    stream.setVersion (QDataStream::Qt_5_0);
+
+    const kpImageSelectionTransparency transparency = sel.transparency ();
+
+    stream << RawMagic << RawVersion
+           << qint32 (sel.serialID ())
+           << sel.boundingRect ()
+           << transparency.isOpaque ()
+           << transparency.transparentColor ()
+           << transparency.colorSimilarity ()
+           << points
+           << qint32 (image.width ()) << qint32 (image.height ())
+           << RawPixelFormatARGB32Premultiplied
+           << quint8 (QSysInfo::ByteOrder)
+           << RawCompressionNone
+           << byteCount;
+
+    if (!image.isNull ())
+    {
+        if (image.bytesPerLine () == rowBytes) {
+            stream.writeRawData (reinterpret_cast <const char *> (image.constBits ()),
+                                 int (byteCount));
+        }
+        else
+        {
+            for (int y = 0; y < image.height (); y++)
+            {
+                stream.writeRawData (reinterpret_cast <const char *> (image.constScanLine (y)),
+                                     rowBytes);
+            }
+        }
+    }
+
+    if (stream.status () != QDataStream::Ok) {
+        return {};
+    }
+
+    return data;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+// (unlike FromStream(), this checks everything it reads, and never
+//  allocates more than the size of <data> before doing so)
+kpAbstractImageSelection *kpSelectionFactory::FromRawData (const QByteArray &data)
+{
+#if DEBUG_KP_SELECTION && 1
+    qCDebug(kpLogLayers) << "kpSelectionFactory::FromRawData() size=" << data.size ();
+#endif
+
+    QDataStream stream (data);
+    stream.setVersion (QDataStream::Qt_5_0);
+
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if (stream.status () != QDataStream::Ok ||
+        magic != RawMagic || version == 0 || version > RawVersion)
+    {
+        return nullptr;
+    }
+
+    qint32 serialID;
+    QRect rect;
+    bool isOpaque;
+    kpColor transparentColor;
+    double colorSimilarity;
+    stream >> serialID
+           >> rect
+           >> isOpaque >> transparentColor >> colorSimilarity;
+
+    // Not "stream >> points", which would allocate for whatever point count
+    // it is given, before finding out that the data is not there.
+    quint32 numPoints = 0;
+    stream >> numPoints;
+    if (stream.status () != QDataStream::Ok ||
+        numPoints > quint64 (stream.device ()->bytesAvailable ()) / RawBytesPerPoint)
+    {
+        return nullptr;
+    }
+
+    QPolygon points (int (numPoints));
+    for (int i = 0; i < int (numPoints); i++)
+    {
+        qint32 x, y;
+        stream >> x >> y;
+        points.setPoint (i, x, y);
+    }
+
+    qint32 width, height;
+    quint8 pixelFormat, byteOrder, compression;
+    qint64 byteCount;
+    stream >> width >> height
+           >> pixelFormat >> byteOrder >> compression
+           >> byteCount;
+
+#if DEBUG_KP_SELECTION && 1
+    qCDebug(kpLogLayers) << "\tserialID=" << serialID << "rect=" << rect
+                         << "image=" << width << "x" << height;
+#endif
+
+    if (stream.status () != QDataStream::Ok ||
+        !rect.isValid () ||
+        pixelFormat != RawPixelFormatARGB32Premultiplied ||
+        compression != RawCompressionNone ||
+        colorSimilarity < 0 || colorSimilarity > 1)
+    {
+        return nullptr;
+    }
+
+    // A selection without content (just a border) or with an image the
+    // size of the selection.
+    const bool hasContent = (width != 0 || height != 0);
+    if (hasContent &&
+        (width <= 0 || height <= 0 ||
+         width > INT_MAX / RawBytesPerPixel ||
+         width != rect.width () || height != rect.height ()))
+    {
+        return nullptr;
+    }
+
+    // (can't overflow: rowBytes <= INT_MAX and height <= INT_MAX)
+    const qint64 rowBytes = qint64 (width) * RawBytesPerPixel;
+    if (byteCount != rowBytes * height ||
+        byteCount > stream.device ()->bytesAvailable ())
+    {
+        return nullptr;
+    }
+
+    kpImage image;
+    if (hasContent)
+    {
+        image = kpImage (width, height, QImage::Format_ARGB32_Premultiplied);
+        if (image.isNull ()) {
+            return nullptr;
+        }
+
+        for (int y = 0; y < height; y++)
+        {
+            if (stream.readRawData (reinterpret_cast <char *> (image.scanLine (y)),
+                                    int (rowBytes)) != rowBytes)
+            {
+                return nullptr;
+            }
+        }
+
+        if (byteOrder != quint8 (QSysInfo::ByteOrder))
+        {
+            for (int y = 0; y < height; y++)
+            {
+                auto *row = reinterpret_cast <quint32 *> (image.scanLine (y));
+                for (int x = 0; x < width; x++) {
+                    row [x] = qbswap (row [x]);
+                }
+            }
+        }
+    }
+
+    const kpImageSelectionTransparency transparency (isOpaque,
+        transparentColor, colorSimilarity);
+
+    switch (serialID)
+    {
+    case kpRectangularImageSelection::SerialID:
+        return new kpRectangularImageSelection (rect, image, transparency);
+
+    case kpEllipticalImageSelection::SerialID:
+        return new kpEllipticalImageSelection (rect, image, transparency);
+
+    case kpFreeFormImageSelection::SerialID:
+        if (points.isEmpty () || points.boundingRect () != rect) {
+            return nullptr;
+        }
+        return new kpFreeFormImageSelection (points, image, transparency);
+
+    default:
+        // Unknown selection type?
+        return nullptr;
+    }
+}
+
+//---------------------------------------------------------------------
+
 // public static
 // TODO: KolourPaint has not been tested against invalid or malicious
 //       clipboard data [Bug #28].
@@ -33,6 +33,7 @@
 #include "pixmapfx/kpPixmapFX.h"
 
 
+class QByteArray;
 class QDataStream;
 
 class kpAbstractImageSelection;
@@ -42,6 +43,19 @@ class kpSelectionFactory
 {
 public:
     static kpAbstractImageSelection *FromStream (QDataStream &stream);
+
+    // The fast format of kpSelectionDrag::RawSelectionMimeType, which is
+    // versioned and stores the image as uncompressed, premultiplied rows
+    // instead of the PNG that "stream << sel" uses.  Both directions are
+    // little more than a memcpy() of the pixels.
+    //
+    // ToRawData() returns an empty QByteArray if the selection would not
+    // fit in one, which is the case for images of over about 512
+    // megapixels.  FromRawData() returns nullptr for that, as well as if
+    // <data> is invalid or from a newer version.  Either way,
+    // kpSelectionDrag::decode() falls back to the other formats.
+    static QByteArray ToRawData (const kpAbstractImageSelection &sel);
+    static kpAbstractImageSelection *FromRawData (const QByteArray &data);
 };
 
 
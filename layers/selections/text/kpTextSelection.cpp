@@ -39,6 +39,7 @@
 #include "kpLogCategories.h"
 
 #include <QFontMetrics>
+#include <QHash>
 #include <QList>
 
 
@@ -79,6 +80,10 @@ kpTextSelection &kpTextSelection::operator= (const kpTextSelection &rhs)
     d->textStyle = rhs.d->textStyle;
     d->preeditText = rhs.d->preeditText;
 
+    d->lineCache = rhs.d->lineCache;
+    d->renderedImage = rhs.d->renderedImage;
+    d->renderedDirtyRegion = rhs.d->renderedDirtyRegion;
+
     return *this;
 }
 
@@ -286,9 +291,55 @@ QList <QString> kpTextSelection::textLines () const
 // public
 void kpTextSelection::setTextLines (const QList <QString> &textLines_)
 {
+    const QList <QString> oldTextLines = d->textLines;
     d->textLines = textLines_;
 
-    emit changed (boundingRect ());
+    // Keep the layout of the lines that have not changed, even if they are
+    // on a different row now (e.g. after Enter or Backspace).
+    if (!d->lineCache.isEmpty ())
+    {
+        QHash <QString, int> oldRowForText;
+        for (int row = 0; row < d->lineCache.size (); row++) {
+            oldRowForText.insert (d->lineCache [row].text, row);
+        }
+
+        QVector <kpTextSelectionLine> newLineCache (d->textLines.size ());
+        for (int row = 0; row < d->textLines.size (); row++)
+        {
+            const auto it = oldRowForText.constFind (d->textLines [row]);
+            if (it != oldRowForText.constEnd ()) {
+                newLineCache [row] = d->lineCache [*it];
+            }
+            else {
+                newLineCache [row].text = d->textLines [row];
+            }
+        }
+
+        d->lineCache = newLineCache;
+    }
+
+    // Only the rows whose text is different need to be redrawn.
+    int firstChangedRow = -1, lastChangedRow = -1;
+    for (int row = 0; row < qMax (oldTextLines.size (), d->textLines.size ()); row++)
+    {
+        if (row < oldTextLines.size () && row < d->textLines.size () &&
+            oldTextLines [row] == d->textLines [row])
+        {
+            continue;
+        }
+
+        if (firstChangedRow < 0) {
+            firstChangedRow = row;
+        }
+        lastChangedRow = row;
+    }
+
+    if (firstChangedRow >= 0) {
+        emit changed (invalidateTextLines (firstChangedRow, lastChangedRow));
+    }
+    else {
+        emit changed (boundingRect ());
+    }
 }
 
 //--------------------------------------------------------------------------------
@@ -330,6 +381,10 @@ void kpTextSelection::setTextStyle (const kpTextStyle &textStyle)
 {
     d->textStyle = textStyle;
 
+    // The font or colors may have changed.
+    d->lineCache.clear ();
+    d->renderedDirtyRegion = QRect (0, 0, width (), height ());
+
     emit changed (boundingRect ());
 }
 
@@ -340,7 +395,12 @@ kpPreeditText kpTextSelection::preeditText () const
 
 void kpTextSelection::setPreeditText (const kpPreeditText &preeditText)
 {
+    const int oldRow = d->preeditText.position ().y ();
+    const int newRow = preeditText.position ().y ();
+
     d->preeditText = preeditText;
-    emit changed (boundingRect ());
+
+    // Redraw the rows the preedit text was and is now in.
+    emit changed (invalidateTextLines (qMin (oldRow, newRow), qMax (oldRow, newRow)));
 }
 
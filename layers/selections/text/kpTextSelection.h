@@ -265,6 +265,22 @@ public:
 private:
     void drawPreeditString(QPainter &painter, int &x, int y, const kpPreeditText &preeditText) const;
 
+    // Returns the rect, relative to the selection's top-left, that the
+    // text line at <row> is drawn in (with some slack for glyphs that
+    // overhang the line).
+    QRect textLineRect (int row) const;
+
+    // Marks the given text lines as needing to be redrawn and returns
+    // the corresponding document rect, for emitting changed().
+    QRect invalidateTextLines (int firstRow, int lastRow) const;
+
+    // Lays out the text line at <row>, if it has not been already.
+    const struct kpTextSelectionLine &laidOutTextLine (int row) const;
+
+    // Redraws the part of the cached rendering, that is inside <rect> but
+    // out of date.  <rect> is relative to the selection's top-left.
+    void updateRenderedImage (const QRect &rect) const;
+
 public:
     void paint(QImage *destPixmap, const QRect &docRect) const override;
 
@@ -30,17 +30,42 @@
 #define kpTextSelectionPrivate_H
 
 
+#include <QGlyphRun>
 #include <QList>
+#include <QRegion>
+#include <QVector>
 
 #include "imagelib/kpImage.h"
 #include "layers/selections/text/kpTextStyle.h"
 #include "layers/selections/text/kpPreeditText.h"
 
+// A text line that has been laid out, so that it can be redrawn from its
+// glyphs without shaping the text again.
+struct kpTextSelectionLine
+{
+    QString text;
+    bool laidOut = false;
+
+    // Glyph positions are relative to the top-left of the line, which is
+    // <ascent> above the baseline.
+    QList <QGlyphRun> glyphRuns;
+    qreal ascent = 0;
+};
+
 struct kpTextSelectionPrivate
 {
     QList <QString> textLines;
     kpTextStyle textStyle;
     kpPreeditText preeditText;
+
+    // Rendering caches for kpTextSelection::paint().
+    //
+    // <lineCache> is parallel to <textLines> (or empty, if not yet built).
+    // <renderedImage> is the whole selection, relative to its top-left, and
+    // <renderedDirtyRegion> is the part of it that needs to be redrawn.
+    mutable QVector <kpTextSelectionLine> lineCache;
+    mutable kpImage renderedImage;
+    mutable QRegion renderedDirtyRegion;
 };
 
 
@@ -46,6 +46,7 @@
 #include <QList>
 #include <QPainter>
 #include <QTextCharFormat>
+#include <QTextLayout>
 
 //---------------------------------------------------------------------
 
@@ -113,45 +114,116 @@ void kpTextSelection::drawPreeditString(QPainter &painter, int &x, int y, const
 
 //---------------------------------------------------------------------
 
-// public virtual [kpAbstractSelection]
-void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
+// private
+QRect kpTextSelection::textLineRect (int row) const
+{
+    const QFontMetrics fontMetrics (d->textStyle.font ());
+    const int lineSpacing = fontMetrics.lineSpacing ();
+
+    const QRect textArea = textAreaRect ().translated (-topLeft ());
+    const QRect rowRect (0, textArea.y () + row * lineSpacing,
+                         width (), lineSpacing);
+
+    // Glyphs can stick out of their line (e.g. accents and characters from
+    // fallback fonts) so include half of the neighboring lines.
+    return rowRect.adjusted (0, -lineSpacing / 2, 0, lineSpacing / 2) &
+           QRect (0, 0, width (), height ());
+}
+
+//---------------------------------------------------------------------
+
+// private
+QRect kpTextSelection::invalidateTextLines (int firstRow, int lastRow) const
+{
+    Q_ASSERT (firstRow <= lastRow);
+
+    const QRect rect = textLineRect (firstRow).united (textLineRect (lastRow));
+    d->renderedDirtyRegion += rect;
+
+    return rect.translated (topLeft ());
+}
+
+//---------------------------------------------------------------------
+
+// private
+const kpTextSelectionLine &kpTextSelection::laidOutTextLine (int row) const
 {
+    if (d->lineCache.size () != d->textLines.size ())
+    {
+        d->lineCache = QVector <kpTextSelectionLine> (d->textLines.size ());
+        for (int i = 0; i < d->textLines.size (); i++) {
+            d->lineCache [i].text = d->textLines [i];
+        }
+    }
+
+    kpTextSelectionLine &line = d->lineCache [row];
+    if (line.laidOut) {
+        return line;
+    }
+
 #if DEBUG_KP_SELECTION
-    qCDebug(kpLogLayers) << "kpTextSelection::paint() textStyle: fcol="
-            << (int *) d->textStyle.foregroundColor ().toQRgb ()
-            << " bcol="
-            << (int *) d->textStyle.backgroundColor ().toQRgb ();
+    qCDebug(kpLogLayers) << "kpTextSelection::laidOutTextLine(" << row << ")"
+                         << line.text;
 #endif
 
-    // Drawing text is slow so if the text box will be rendered completely
-    // outside of <destRect>, don't bother rendering it at all.
-    const QRect modifyingRect = docRect.intersected (boundingRect ());
-    if (modifyingRect.isEmpty ()) {
-        return;
+    // Lay out the line for the same device that it will be drawn on.
+    QTextLayout layout (line.text, d->textStyle.font (), &d->renderedImage);
+
+    QTextOption option;
+    option.setWrapMode (QTextOption::NoWrap);
+    layout.setTextOption (option);
+
+    layout.beginLayout ();
+    QTextLine textLine = layout.createLine ();
+    if (textLine.isValid ())
+    {
+        textLine.setNumColumns (line.text.length ());
+        textLine.setPosition (QPointF (0, 0));
     }
+    layout.endLayout ();
 
+    line.glyphRuns = layout.glyphRuns ();
+    line.ascent = textLine.isValid () ? textLine.ascent () : 0;
+    line.laidOut = true;
 
-    // Is the text box completely invisible?
-    if (textStyle ().foregroundColor ().isTransparent () &&
-        textStyle ().backgroundColor ().isTransparent ())
+    return line;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTextSelection::updateRenderedImage (const QRect &rect) const
+{
+    if (d->renderedImage.width () != width () ||
+        d->renderedImage.height () != height ())
     {
+        d->renderedImage = kpImage (width (), height (),
+                                    QImage::Format_ARGB32_Premultiplied);
+        d->renderedDirtyRegion = QRect (0, 0, width (), height ());
+    }
+
+    const QRegion region = d->renderedDirtyRegion & rect;
+    if (region.isEmpty ()) {
         return;
     }
 
-    kpImage floatImage(modifyingRect.size(), QImage::Format_ARGB32_Premultiplied);
-    floatImage.fill(0);
+    d->renderedDirtyRegion -= region;
+
+#if DEBUG_KP_SELECTION
+    qCDebug(kpLogLayers) << "kpTextSelection::updateRenderedImage() region="
+                         << region.boundingRect ();
+#endif
 
-    QRect theWholeAreaRect, theTextAreaRect;
-    theWholeAreaRect = boundingRect ().translated (-modifyingRect.topLeft ());
-    theTextAreaRect = textAreaRect ().translated (-modifyingRect.topLeft ());
+    const QRect theWholeAreaRect (0, 0, width (), height ());
+    const QRect theTextAreaRect = textAreaRect ().translated (-topLeft ());
 
-    QList <QString> theTextLines = textLines();
-    kpTextStyle theTextStyle = textStyle();
+    const QList <QString> &theTextLines = d->textLines;
+    const kpTextStyle &theTextStyle = d->textStyle;
 
     const QFontMetrics fontMetrics (theTextStyle.font ());
+    const int lineSpacing = fontMetrics.lineSpacing ();
 
 #if DEBUG_KP_SELECTION
-    qCDebug(kpLogLayers) << "kpTextSelection_Paint.cpp:DrawTextHelper";
     qCDebug(kpLogLayers) << "\theight=" << fontMetrics.height ()
                << " leading=" << fontMetrics.leading ()
                << " ascent=" << fontMetrics.ascent ()
@@ -159,20 +231,39 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
                << " lineSpacing=" << fontMetrics.lineSpacing ();
 #endif
 
-    QPainter painter(&floatImage);
+    QPainter painter(&d->renderedImage);
+    painter.setClipRegion(region);
 
-    // Fill in the background using the transparent/opaque tool setting
+    // Fill in the background using the transparent/opaque tool setting.
+    // This replaces the previously rendered pixels.
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
     if ( theTextStyle.isBackgroundTransparent() ) {
       painter.fillRect(theWholeAreaRect, Qt::transparent);
     }
     else {
       painter.fillRect(theWholeAreaRect, theTextStyle.backgroundColor().toQColor());
     }
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
 
-    painter.setClipRect(theWholeAreaRect);
     painter.setPen(theTextStyle.foregroundColor().toQColor());
     painter.setFont(theTextStyle.font());
 
+    // Only draw the lines that can touch <region>.
+    const QRect dirtyRect = region.boundingRect ();
+    auto lineIsDirty = [&] (int baseLine)
+    {
+        return QRect (0, baseLine - fontMetrics.ascent () - lineSpacing,
+                      width (), lineSpacing * 3).intersects (dirtyRect);
+    };
+
+    auto drawTextLine = [&] (int row, int x, int baseLine)
+    {
+        const kpTextSelectionLine &line = laidOutTextLine (row);
+        for (const auto &glyphRun : line.glyphRuns) {
+            painter.drawGlyphRun (QPointF (x, baseLine - line.ascent), glyphRun);
+        }
+    };
+
     if ( theTextStyle.foregroundColor().toQColor().alpha() < 255 )
     {
       // if the foreground color has an alpha channel, we want to
@@ -181,10 +272,12 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
       painter.setCompositionMode(QPainter::CompositionMode_Clear);
 
       int baseLine = theTextAreaRect.y () + fontMetrics.ascent ();
-      for (const auto &str : theTextLines)
+      for (int row = 0; row < theTextLines.size (); row++)
       {
-          painter.drawText (theTextAreaRect.x (), baseLine, str);
-          baseLine += fontMetrics.lineSpacing ();
+          if (lineIsDirty (baseLine)) {
+              drawTextLine (row, theTextAreaRect.x (), baseLine);
+          }
+          baseLine += lineSpacing;
 
           // if the next textline would already be below the visible text area, stop drawing
           if ( (baseLine - fontMetrics.ascent()) > (theTextAreaRect.y() + theTextAreaRect.height()) ) {
@@ -201,7 +294,7 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
     // characters (!) and then the cursor gets out of sync.
     int baseLine = theTextAreaRect.y () + fontMetrics.ascent ();
 
-    kpPreeditText thePreeditText = preeditText();
+    const kpPreeditText &thePreeditText = d->preeditText;
 
     if ( theTextLines.isEmpty() )
     {
@@ -213,13 +306,19 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
     }
     else
     {
-        int i = 0;
         int row = thePreeditText.position().y();
         int col = thePreeditText.position().x();
-        for (const auto &str : theTextLines)
+        for (int i = 0; i < theTextLines.size (); i++)
         {
-            if (row == i && !thePreeditText.isEmpty())
+            if (!lineIsDirty (baseLine))
+            {
+                // Still rendered.
+            }
+            // The preedit text is only there while composing input so is
+            // not worth caching.
+            else if (row == i && !thePreeditText.isEmpty())
             {
+                const QString &str = theTextLines [i];
                 QString left = str.left(col);
                 QString right = str.mid(col);
                 int x = theTextAreaRect.x();
@@ -231,10 +330,9 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
             }
             else
             {
-                painter.drawText(theTextAreaRect.x (), baseLine, str);
+                drawTextLine (i, theTextAreaRect.x (), baseLine);
             }
-            baseLine += fontMetrics.lineSpacing();
-            i++;
+            baseLine += lineSpacing;
 
             // if the next textline would already be below the visible text area, stop drawing
             if ( (baseLine - fontMetrics.ascent()) > (theTextAreaRect.y() + theTextAreaRect.height()) ) {
@@ -242,12 +340,47 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
             }
         }
     }
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [kpAbstractSelection]
+void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
+{
+#if DEBUG_KP_SELECTION
+    qCDebug(kpLogLayers) << "kpTextSelection::paint() textStyle: fcol="
+            << (int *) d->textStyle.foregroundColor ().toQRgb ()
+            << " bcol="
+            << (int *) d->textStyle.backgroundColor ().toQRgb ();
+#endif
+
+    // If the text box will be rendered completely outside of <destRect>,
+    // don't bother rendering it at all.
+    const QRect modifyingRect = docRect.intersected (boundingRect ());
+    if (modifyingRect.isEmpty ()) {
+        return;
+    }
+
+
+    // Is the text box completely invisible?
+    if (textStyle ().foregroundColor ().isTransparent () &&
+        textStyle ().backgroundColor ().isTransparent ())
+    {
+        return;
+    }
+
+    // Drawing text is slow so the text box is rendered once and kept.
+    // Only the parts that have changed since (e.g. the line being typed
+    // into) are rendered again.
+    const QRect renderedRect = modifyingRect.translated (-topLeft ());
+    updateRenderedImage (renderedRect);
 
     // ... convert that into "painting" transparent pixels on top of
     // the document.
-    kpPixmapFX::paintPixmapAt (destPixmap,
-        modifyingRect.topLeft () - docRect.topLeft (),
-        floatImage);
+    QPainter painter (destPixmap);
+    painter.drawImage (modifyingRect.topLeft () - docRect.topLeft (),
+                       d->renderedImage,
+                       renderedRect);
 }
 
 //---------------------------------------------------------------------
@@ -42,8 +42,7 @@ kpTempImage::kpTempImage (bool isBrush, RenderMode renderMode,
       m_topLeft (topLeft),
       m_image (image),
       m_width (image.width ()), m_height (image.height ()),
-      m_userFunction (nullptr),
-      m_userData (nullptr)
+      m_userFunction (nullptr)
 {
     // Use below constructor for that.
     Q_ASSERT (renderMode != UserFunction);
@@ -52,7 +51,7 @@ kpTempImage::kpTempImage (bool isBrush, RenderMode renderMode,
 //---------------------------------------------------------------------
 
 kpTempImage::kpTempImage (bool isBrush, const QPoint &topLeft,
-        UserFunctionType userFunction, void *userData,
+        UserFunctionType userFunction, const QSharedPointer <void> &userData,
         int width, int height)
     : m_isBrush (isBrush),
       m_renderMode (UserFunction),
@@ -73,7 +72,8 @@ kpTempImage::kpTempImage (const kpTempImage &rhs)
       m_image (rhs.m_image),
       m_width (rhs.m_width), m_height (rhs.m_height),
       m_userFunction (rhs.m_userFunction),
-      m_userData (rhs.m_userData)
+      m_userData (rhs.m_userData),
+      m_region (rhs.m_region)
 {
 }
 
@@ -93,6 +93,7 @@ kpTempImage &kpTempImage::operator= (const kpTempImage &rhs)
     m_height = rhs.m_height;
     m_userFunction = rhs.m_userFunction;
     m_userData = rhs.m_userData;
+    m_region = rhs.m_region;
 
     return *this;
 }
@@ -142,7 +143,7 @@ kpTempImage::UserFunctionType kpTempImage::userFunction () const
 // public
 void *kpTempImage::userData () const
 {
-    return m_userData;
+    return m_userData.data ();
 }
 
 //---------------------------------------------------------------------
@@ -179,6 +180,26 @@ int kpTempImage::height () const
 
 //---------------------------------------------------------------------
 
+// public
+QRegion kpTempImage::region () const
+{
+    if (m_region.isEmpty ()) {
+        return rect ();
+    }
+
+    return m_region & rect ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpTempImage::setRegion (const QRegion &region)
+{
+    m_region = region;
+}
+
+//---------------------------------------------------------------------
+
 // public
 bool kpTempImage::paintMayAddMask () const
 {
@@ -209,7 +230,7 @@ void kpTempImage::paint (kpImage *destImage, const QRect &docRect) const
 
       case UserFunction:
       {
-        m_userFunction(destImage, REL_TOP_LEFT, m_userData);
+        m_userFunction(destImage, REL_TOP_LEFT, m_userData.data ());
         break;
       }
     }
@@ -33,6 +33,8 @@
 
 
 #include <QPoint>
+#include <QRegion>
+#include <QSharedPointer>
 
 #include "imagelib/kpImage.h"
 
@@ -64,10 +66,15 @@ public:
      * <userFunction>   This is the only way of specifying the "UserFunction"
      *                  <renderMode>.  <userFunction> must not draw outside
      *                  the claimed rectangle.
+     *
+     * <userData>       Passed to <userFunction>.  It is shared by all copies
+     *                  of the temporary image, which may outlive whoever
+     *                  created it, so give it data of its own rather than
+     *                  pointing into e.g. a tool.
      */
     kpTempImage (bool isBrush, RenderMode renderMode, const QPoint &topLeft, const kpImage &image);
     kpTempImage (bool isBrush, const QPoint &topLeft,
-        UserFunctionType userFunction, void *userData,
+        UserFunctionType userFunction, const QSharedPointer <void> &userData,
         int width, int height);
     kpTempImage (const kpTempImage &rhs);
     kpTempImage &operator= (const kpTempImage &rhs);
@@ -84,6 +91,14 @@ public:
     int width () const;
     int height () const;
 
+    // The part of rect() that paint() may change from what is in the
+    // document e.g. just the outline of an unfilled shape.  Only this is
+    // repainted when the image is set or invalidated.
+    //
+    // Defaults to rect().  It is clipped to rect().
+    QRegion region () const;
+    void setRegion (const QRegion &region);
+
 
     // Returns whether a call to paint() may add a mask to <*destImage>.
     bool paintMayAddMask () const;
@@ -103,7 +118,9 @@ private:
     // == m_image.{width,height}() unless m_renderMode == UserFunction.
     int m_width, m_height;
     UserFunctionType m_userFunction;
-    void *m_userData;
+    QSharedPointer <void> m_userData;
+    // Empty means rect().
+    QRegion m_region;
 };
 
 
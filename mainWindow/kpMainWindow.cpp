@@ -44,6 +44,7 @@
 #include "views/manager/kpViewManager.h"
 #include "kpViewScrollableContainer.h"
 #include "generic/kpWidgetMapper.h"
+#include "generic/kpStartupTrace.h"
 #include "views/kpZoomedThumbnailView.h"
 #include "views/kpZoomedView.h"
 
@@ -66,6 +67,7 @@ kpMainWindow::kpMainWindow ()
 {
     init ();
     open (QUrl (), true/*create an empty doc*/);
+    kpStartupTrace::mark ("openDocument");
 
     d->isFullyConstructed = true;
 }
@@ -77,6 +79,20 @@ kpMainWindow::kpMainWindow (const QUrl &url)
 {
     init ();
     open (url, true/*create an empty doc with the same url if url !exist*/);
+    kpStartupTrace::mark ("openDocument");
+
+    d->isFullyConstructed = true;
+}
+
+//---------------------------------------------------------------------
+
+kpMainWindow::kpMainWindow (const QUrl &url, kpDocumentLoadQueue *loadQueue)
+    : KXmlGuiWindow (nullptr/*parent*/)
+{
+    init ();
+    setDocument (nullptr);
+    openInBackground (url, loadQueue);
+    kpStartupTrace::mark ("openDocument");
 
     d->isFullyConstructed = true;
 }
@@ -211,16 +227,21 @@ void kpMainWindow::init ()
 
     readGeneralSettings ();
     readThumbnailSettings ();
+    kpStartupTrace::mark ("readSettings");
 
     //
     // create GUI
     //
     setupActions ();
+    kpStartupTrace::mark ("setupActions");
     createStatusBar ();
     createGUI ();
+    kpStartupTrace::mark ("createGUI");
 
     createColorBox ();
+    kpStartupTrace::mark ("createColorBox");
     createToolBox ();
+    kpStartupTrace::mark ("createToolBox");
 
 
     // Let the Tool Box take all the vertical space, since it can be quite
@@ -256,6 +277,7 @@ void kpMainWindow::init ()
              this, &kpMainWindow::slotScrollViewAfterScroll);
 
     setCentralWidget (d->scrollView);
+    kpStartupTrace::mark ("createScrollView");
 
     //
     // set initial pos/size of GUI
@@ -275,6 +297,7 @@ void kpMainWindow::init ()
       cfg.writeEntry(kpSettingFirstTime, d->configFirstTime = false);
       cfg.sync();
     }
+    kpStartupTrace::mark ("setAutoSaveSettings");
 
 
 #if DEBUG_KP_MAIN_WINDOW
@@ -683,11 +706,19 @@ void kpMainWindow::setDocument (kpDocument *newDoc)
         connect (d->document, &kpDocument::documentSaved,
                  this, &kpMainWindow::slotEnableSettingsShowPath);
 
+        // File/Save action and Recent Files list
+        connect (d->document, &kpDocument::savingChanged,
+                 this, &kpMainWindow::slotDocumentSavingChanged);
+        connect (d->document, &kpDocument::documentSaved,
+                 this, &kpMainWindow::slotDocumentSaved);
+
         // Command history
         Q_ASSERT (d->commandHistory);
         connect (d->commandHistory, &kpCommandHistory::documentRestored,
                  this, &kpMainWindow::slotDocumentRestored); // caption "!modified"
 
+        connect (d->document, &kpDocument::documentSaving,
+                 d->commandHistory, &kpCommandHistory::documentSaving);
         connect (d->document, &kpDocument::documentSaved,
                  d->commandHistory, &kpCommandHistory::documentSaved);
 
@@ -61,6 +61,7 @@ class kpCommandEnvironment;
 class kpCommandHistory;
 class kpDocument;
 class kpDocumentEnvironment;
+class kpDocumentLoadQueue;
 class kpDocumentMetaInfo;
 class kpDocumentSaveOptions;
 class kpViewManager;
@@ -86,6 +87,12 @@ public:
     // or creates a blank document if <url> could not be opened.
     kpMainWindow (const QUrl &url);
 
+    // Same as above except that the window is shown without a document
+    // and <url> is loaded in the background, when <loadQueue> gets to it.
+    // This lets many windows be opened at once, with their files decoded
+    // in parallel.
+    kpMainWindow (const QUrl &url, kpDocumentLoadQueue *loadQueue);
+
     // Opens a new window with the document <newDoc>
     // (<newDoc> can be 0 although this would result in a new
     //  window without a document at all).
@@ -323,6 +330,15 @@ private:
     // make sense to bubble the Recent Files list.
     bool open (const QUrl &url, bool newDocSameNameIfNotExist = false);
 
+    // Same as open() with <newDocSameNameIfNotExist> set, except that it
+    // returns immediately and the document is set once <url> has been
+    // loaded.  This window must not have a document yet.
+    void openInBackground (const QUrl &url, kpDocumentLoadQueue *loadQueue);
+private slots:
+    void slotBackgroundLoaderProgress (int percent);
+    void slotBackgroundLoaderFinished ();
+
+private:
     QList<QUrl> askForOpenURLs(const QString &caption,
                               bool allowMultipleURLs = true);
 
@@ -344,6 +360,12 @@ private slots:
     bool save (bool localOnly = false);
     bool slotSave ();
 
+    // An untitled document only gets its url once its first save has
+    // finished, so Save is disabled until then.  Otherwise, it would
+    // ask for a filename again.
+    void slotDocumentSavingChanged (bool isSaving);
+    void slotDocumentSaved ();
+
 private:
     QUrl askForSaveURL (const QString &caption,
                         const QString &startURL,
@@ -56,6 +56,7 @@ class kpZoomedView;
 class kpThumbnail;
 class kpThumbnailView;
 class kpDocument;
+class kpDocumentLoader;
 class kpViewManager;
 class kpColorToolBar;
 class kpToolToolBar;
@@ -147,6 +148,8 @@ struct kpMainWindowPrivate
 
       scanDialog(nullptr),
 
+      backgroundLoader(nullptr),
+
       exportFirstTime(false),
 
       // Edit Menu
@@ -326,6 +329,10 @@ struct kpMainWindowPrivate
 
   SaneDialog *scanDialog;
 
+  // Loading the document that this window was constructed for, while the
+  // window has no document yet.
+  kpDocumentLoader *backgroundLoader;
+
   QUrl lastExportURL;
   kpDocumentSaveOptions lastExportSaveOptions;
   bool exportFirstTime;
@@ -68,6 +68,8 @@
 #include "commands/kpCommandHistory.h"
 #include "kpDefs.h"
 #include "document/kpDocument.h"
+#include "document/kpDocumentLoader.h"
+#include "document/kpDocumentLoadQueue.h"
 #include "commands/imagelib/kpDocumentMetaInfoCommand.h"
 #include "dialogs/imagelib/kpDocumentMetaInfoDialog.h"
 #include "widgets/kpDocumentSaveOptionsWidget.h"
@@ -75,6 +77,7 @@
 #include "widgets/kpPrintDialogPage.h"
 #include "views/kpView.h"
 #include "views/manager/kpViewManager.h"
+#include "lgpl/generic/kpUrlFormatter.h"
 
 #if HAVE_KSANE
 #include "../scan/sanedialog.h"
@@ -429,6 +432,87 @@ bool kpMainWindow::open (const QUrl &url, bool newDocSameNameIfNotExist)
 
 //---------------------------------------------------------------------
 
+// private
+void kpMainWindow::openInBackground (const QUrl &url, kpDocumentLoadQueue *loadQueue)
+{
+#if DEBUG_KP_MAIN_WINDOW
+    qCDebug(kpLogMainWindow) << "kpMainWindow::openInBackground(" << url << ")";
+#endif
+
+    Q_ASSERT (!d->document && !d->backgroundLoader);
+
+    // (deleted with the window, which cancels it)
+    d->backgroundLoader = new kpDocumentLoader (url, this);
+    d->backgroundLoader->setWindow (this);
+
+    connect (d->backgroundLoader, &kpDocumentLoader::progress,
+             this, &kpMainWindow::slotBackgroundLoaderProgress);
+    connect (d->backgroundLoader, &kpDocumentLoader::finished,
+             this, &kpMainWindow::slotBackgroundLoaderFinished);
+
+    setCaption (kpUrlFormatter::PrettyFilename (url));
+    setStatusBarMessage (i18n ("Opening \"%1\"...", kpUrlFormatter::PrettyFilename (url)));
+
+    loadQueue->enqueue (d->backgroundLoader);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotBackgroundLoaderProgress (int percent)
+{
+    setStatusBarMessage (i18n ("Opening \"%1\"... %2%",
+        kpUrlFormatter::PrettyFilename (d->backgroundLoader->url ()), percent));
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotBackgroundLoaderFinished ()
+{
+    kpDocumentLoader *loader = d->backgroundLoader;
+    d->backgroundLoader = nullptr;
+    loader->deleteLater ();
+
+#if DEBUG_KP_MAIN_WINDOW
+    qCDebug(kpLogMainWindow) << "kpMainWindow::slotBackgroundLoaderFinished() url="
+                             << loader->url () << "status=" << loader->status ();
+#endif
+
+    setStatusBarMessage ();
+
+    if (loader->status () == kpDocumentLoader::Cancelled)
+    {
+        slotUpdateCaption ();
+        return;
+    }
+
+    const QSize docSize = defaultDocSize ();
+    auto *newDoc = new kpDocument (docSize.width (), docSize.height (),
+                                   documentEnvironment ());
+
+    // (with <newDocSameNameIfNotExist>, this always succeeds)
+    newDoc->open (*loader, true/*create an empty doc with the same url if url !exist*/);
+
+    // The user may have opened something else in this window in the
+    // meantime.
+    if (d->document)
+    {
+        auto *win = new kpMainWindow (newDoc);
+        win->show ();
+    }
+    else
+    {
+        setDocument (newDoc);
+    }
+
+    if (newDoc->isFromExistingURL ()) {
+        addRecentURL (loader->url ());
+    }
+}
+
+//---------------------------------------------------------------------
+
 // private
 QList<QUrl> kpMainWindow::askForOpenURLs(const QString &caption, bool allowMultipleURLs)
 {
@@ -733,6 +817,11 @@ void kpMainWindow::slotProperties ()
 // private slot
 bool kpMainWindow::save (bool localOnly)
 {
+    // Until a save in progress has finished, an untitled document has no
+    // url to save to.  Save is disabled meanwhile but closing the window,
+    // for instance, can still get here.
+    d->document->waitForSave ();
+
     if (d->document->url ().isEmpty () ||
         !QImageWriter::supportedMimeTypes()
             .contains(d->document->saveOptions ()->mimeType().toLatin1()) ||
@@ -745,13 +834,9 @@ bool kpMainWindow::save (bool localOnly)
         return saveAs (localOnly);
     }
 
-    if (d->document->save (!d->document->savedAtLeastOnceBefore ()/*lossy prompt*/))
-    {
-        addRecentURL (d->document->url ());
-        return true;
-    }
-
-    return false;
+    // (slotDocumentSaved() adds the url to the Recent Files list, once
+    //  the save has succeeded)
+    return d->document->save (!d->document->savedAtLeastOnceBefore ()/*lossy prompt*/);
 }
 
 //---------------------------------------------------------------------
@@ -766,6 +851,22 @@ bool kpMainWindow::slotSave ()
 
 //---------------------------------------------------------------------
 
+// private slot
+void kpMainWindow::slotDocumentSavingChanged (bool isSaving)
+{
+    d->actionSave->setEnabled (d->document && !isSaving);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotDocumentSaved ()
+{
+    addRecentURL (d->document->url ());
+}
+
+//---------------------------------------------------------------------
+
 // private
 QUrl kpMainWindow::askForSaveURL (const QString &caption,
                                   const QString &startURL,
@@ -974,16 +1075,10 @@ bool kpMainWindow::saveAs (bool localOnly)
     }
 
 
-    if (!d->document->saveAs (chosenURL, chosenSaveOptions,
-                             allowLossyPrompt))
-    {
-        return false;
-    }
-
-
-    addRecentURL (chosenURL);
-
-    return true;
+    // (slotDocumentSaved() adds the url to the Recent Files list, once
+    //  the save has succeeded)
+    return d->document->saveAs (chosenURL, chosenSaveOptions,
+                                allowLossyPrompt);
 }
 
 //---------------------------------------------------------------------
@@ -1058,6 +1153,9 @@ bool kpMainWindow::slotReload ()
 
     Q_ASSERT (d->document);
 
+    // (don't read back a file that is still being written)
+    d->document->waitForSave ();
+
 
     QUrl oldURL = d->document->url ();
 
@@ -1391,6 +1489,9 @@ void kpMainWindow::slotMail ()
 {
     toolEndShape ();
 
+    // (the attachment must be on disk)
+    d->document->waitForSave ();
+
     if (d->document->url ().isEmpty ()/*no name*/ ||
         !(d->document->isFromExistingURL () && d->document->urlExists (d->document->url ())) ||
         d->document->isModified ()/*needs to be saved*/)
@@ -1403,7 +1504,7 @@ void kpMainWindow::slotMail ()
 
         if (result == KMessageBox::Yes)
         {
-            if (!save ())
+            if (!save () || !d->document->waitForSave ())
             {
                 // save failed or aborted - don't email
                 return;
@@ -1433,6 +1534,11 @@ bool kpMainWindow::queryCloseDocument ()
 {
     toolEndShape ();
 
+    // A save in progress may yet leave the document unmodified.
+    if (d->document) {
+        d->document->waitForSave ();
+    }
+
     if (!d->document || !d->document->isModified ()) {
         return true;  // ok to close current doc
     }
@@ -1447,7 +1553,8 @@ bool kpMainWindow::queryCloseDocument ()
     switch (result)
     {
     case KMessageBox::Yes:
-        return slotSave ();  // close only if save succeeds
+        // close only if save succeeds
+        return slotSave () && d->document->waitForSave ();
     case KMessageBox::No:
         return true;  // close without saving
     default:
@@ -399,7 +399,8 @@ void kpMainWindow::slotResizeScale ()
             dialog.actOnSelection (),
             dialog.imageWidth (), dialog.imageHeight (),
             dialog.type (),
-            commandEnvironment ());
+            commandEnvironment (),
+            dialog.smoothScaleFilter ());
 
         bool addSelCreateCommand = (dialog.actOnSelection () ||
                                     cmd->scaleSelectionWithImage ());
@@ -130,7 +130,8 @@ public:
 
     //
     // Scales an image to the given width and height.
-    // If <pretty> is true, a smooth scale will be used.
+    // If <pretty> is true, a smooth scale will be used (see kpImageScaler,
+    // which can also use other filters).
     //
     static void scale (QImage *destPtr, int w, int h, bool pretty = false);
     static QImage scale (const QImage &pm, int w, int h, bool pretty = false);
@@ -153,6 +154,8 @@ public:
     // <backgroundColor>    color to fill new areas with
     // <targetWidth>        if > 0, the desired width of the resultant pixmap
     // <targetHeight>       if > 0, the desired height of the resultant pixmap
+    // <pretty>             whether to interpolate pixels (smoother but
+    //                      blurrier) -- only use for previews
     //
     // Using <targetWidth> & <targetHeight> to generate preview pixmaps is
     // significantly more efficient than skewing and then scaling yourself.
@@ -162,10 +165,12 @@ public:
 
     static void skew (QImage *destPixmapPtr, double hangle, double vangle,
                       const kpColor &backgroundColor,
-                      int targetWidth = -1, int targetHeight = -1);
+                      int targetWidth = -1, int targetHeight = -1,
+                      bool pretty = false);
     static QImage skew (const QImage &pm, double hangle, double vangle,
                          const kpColor &backgroundColor,
-                         int targetWidth = -1, int targetHeight = -1);
+                         int targetWidth = -1, int targetHeight = -1,
+                         bool pretty = false);
 
     //
     // Rotates an image.
@@ -174,6 +179,8 @@ public:
     // <backgroundColor>    color to fill new areas with
     // <targetWidth>        if > 0, the desired width of the resultant pixmap
     // <targetHeight>       if > 0, the desired height of the resultant pixmap
+    // <pretty>             whether to interpolate pixels (smoother but
+    //                      blurrier) -- only use for previews
     //
     // Using <targetWidth> & <targetHeight> to generate preview pixmaps is
     // significantly more efficient than rotating and then scaling yourself.
@@ -185,10 +192,62 @@ public:
 
     static void rotate (QImage *destPixmapPtr, double angle,
                         const kpColor &backgroundColor,
-                        int targetWidth = -1, int targetHeight = -1);
+                        int targetWidth = -1, int targetHeight = -1,
+                        bool pretty = false);
     static QImage rotate (const QImage &pm, double angle,
                            const kpColor &backgroundColor,
-                           int targetWidth = -1, int targetHeight = -1);
+                           int targetWidth = -1, int targetHeight = -1,
+                           bool pretty = false);
+
+//
+// Lossless Transforms
+//
+// These only move whole pixels around, a cache-sized tile at a time, with
+// the work spread across threads.  Unless the image's pixels are shared
+// with another QImage, they are rearranged in place so that huge images are
+// not held twice.
+//
+
+public:
+    static void flip (QImage *destPtr, bool horiz, bool vert);
+    static QImage flip (const QImage &pm, bool horiz, bool vert);
+
+    // Rotates clockwise by <quarterTurns> * 90 degrees (<quarterTurns> may
+    // be negative).
+    //
+    // 90 and 270 degree rotations of non-square images cannot be done in
+    // place and so, temporarily, need a second image.
+    static void rotateQuarterTurns (QImage *destPtr, int quarterTurns);
+
+//
+// Zooming
+//
+
+public:
+
+    //
+    // Draws <src> onto <destRect> of <*destPtr>, enlarged <hzoom> x <vzoom>
+    // times by pixel replication (nearest neighbour).  This is much faster
+    // than QPainter::scale() followed by QPainter::drawImage().
+    //
+    // <srcTopLeft> is where the top-left corner of <src> lands in
+    // <*destPtr>.  It may be outside <destRect>, which is the only area
+    // written to.
+    //
+    // If <blend> is set, <src> is composited on top of <*destPtr>
+    // ("SourceOver"), else it replaces it ("Source").
+    //
+    // If <gridColor> is valid, grid lines of that color are drawn along
+    // the top and left edges of every enlarged pixel in the same pass.
+    //
+    // ASSUMPTION: <*destPtr> and <src> are QImage::Format_ARGB32_Premultiplied.
+    //             <hzoom> >= 1 and <vzoom> >= 1.
+    //
+    static void drawZoomedImage (QImage *destPtr, const QRect &destRect,
+        const QImage &src, const QPoint &srcTopLeft,
+        int hzoom, int vzoom,
+        bool blend,
+        const kpColor &gridColor = kpColor::Invalid);
 
 //
 // Drawing Shapes
@@ -0,0 +1,464 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_PIXMAP_FX 0
+
+
+#include "kpPixmapFX.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include <QImage>
+#include <QTransform>
+
+#include "kpLogCategories.h"
+
+#include "generic/kpParallel.h"
+
+//---------------------------------------------------------------------
+
+// Pixel transposes work on square tiles of this many pixels a side.
+// A source tile and a destination tile (2 * 32 * 32 * 4 bytes = 8KiB)
+// comfortably fit in even the smallest L1 data caches, so every cache line
+// that is touched is fully used before it is evicted.
+static const int TileSize = 32;
+
+// Don't bother spreading work across threads for less than this many
+// pixels.
+static const int MinPixelsPerThread = 256 * 256;
+
+//---------------------------------------------------------------------
+
+// Returns row <y> of the 32-bit pixels <bits>.
+static inline QRgb *PixelRow (uchar *bits, int bytesPerLine, int y)
+{
+    return reinterpret_cast <QRgb *> (bits + qsizetype (y) * bytesPerLine);
+}
+
+static inline const QRgb *PixelRow (const uchar *bits, int bytesPerLine, int y)
+{
+    return reinterpret_cast <const QRgb *> (bits + qsizetype (y) * bytesPerLine);
+}
+
+//---------------------------------------------------------------------
+
+// Returns the number of rows of a <width> wide image each thread should
+// get at least.
+static inline int MinRowsPerThread (int width)
+{
+    return qMax (1, MinPixelsPerThread / qMax (1, width));
+}
+
+//---------------------------------------------------------------------
+
+// Copies the <count> pixels of <src> into <dest> in reverse order.
+// <dest> and <src> must not overlap.
+static void ReverseCopyPixels (QRgb *dest, const QRgb *src, int count)
+{
+    const QRgb *srcEnd = src + count;
+
+#if defined(__SSE2__)
+    for (; count >= 4; count -= 4, dest += 4)
+    {
+        srcEnd -= 4;
+        const __m128i pixels = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (srcEnd));
+        _mm_storeu_si128 (reinterpret_cast <__m128i *> (dest),
+            _mm_shuffle_epi32 (pixels, _MM_SHUFFLE (0, 1, 2, 3)));
+    }
+#endif
+
+    for (; count > 0; count--) {
+        *dest++ = *--srcEnd;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Replaces the <count> pixels of <a> with those of <b> in reverse order and
+// vice versa.  <a> and <b> must either not overlap or be the same row.
+static void ReverseSwapPixels (QRgb *a, QRgb *b, int count)
+{
+    if (a == b)
+    {
+        std::reverse (a, a + count);
+        return;
+    }
+
+    QRgb *bEnd = b + count;
+
+#if defined(__SSE2__)
+    for (; count >= 4; count -= 4, a += 4)
+    {
+        bEnd -= 4;
+        const __m128i aPixels = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (a));
+        const __m128i bPixels = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (bEnd));
+        _mm_storeu_si128 (reinterpret_cast <__m128i *> (a),
+            _mm_shuffle_epi32 (bPixels, _MM_SHUFFLE (0, 1, 2, 3)));
+        _mm_storeu_si128 (reinterpret_cast <__m128i *> (bEnd),
+            _mm_shuffle_epi32 (aPixels, _MM_SHUFFLE (0, 1, 2, 3)));
+    }
+#endif
+
+    for (; count > 0; count--, a++)
+    {
+        --bEnd;
+        const QRgb temp = *a;
+        *a = *bEnd;
+        *bEnd = temp;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Flips the 32-bit image <bits> in place.
+static void FlipInPlace (uchar *bits, int bytesPerLine, int width, int height,
+        bool horiz, bool vert)
+{
+    if (!vert)
+    {
+        kpParallel::forEachBand (height, ::MinRowsPerThread (width),
+            [=] (int firstRow, int endRow)
+            {
+                for (int y = firstRow; y < endRow; y++)
+                {
+                    QRgb *row = ::PixelRow (bits, bytesPerLine, y);
+                    std::reverse (row, row + width);
+                }
+            });
+        return;
+    }
+
+    // Swap each row in the top half with its mirror in the bottom half
+    // (and, if <horiz>, reverse both on the way).  The middle row of an
+    // odd height image only needs reversing.
+    kpParallel::forEachBand ((height + 1) / 2, ::MinRowsPerThread (width * 2),
+        [=] (int firstRow, int endRow)
+        {
+            for (int y = firstRow; y < endRow; y++)
+            {
+                QRgb *top = ::PixelRow (bits, bytesPerLine, y);
+                QRgb *bottom = ::PixelRow (bits, bytesPerLine, height - 1 - y);
+
+                if (horiz) {
+                    ::ReverseSwapPixels (top, bottom, width);
+                }
+                else if (top != bottom) {
+                    std::swap_ranges (top, top + width, bottom);
+                }
+            }
+        });
+}
+
+//---------------------------------------------------------------------
+
+// Writes the flipped 32-bit image <src> into <dest>, which must be the same
+// size.
+static void FlipCopy (uchar *destBits, int destBytesPerLine,
+        const uchar *srcBits, int srcBytesPerLine,
+        int width, int height,
+        bool horiz, bool vert)
+{
+    kpParallel::forEachBand (height, ::MinRowsPerThread (width),
+        [=] (int firstRow, int endRow)
+        {
+            for (int y = firstRow; y < endRow; y++)
+            {
+                QRgb *destRow = ::PixelRow (destBits, destBytesPerLine, y);
+                const QRgb *srcRow = ::PixelRow (srcBits, srcBytesPerLine,
+                    vert ? height - 1 - y : y);
+
+                if (horiz) {
+                    ::ReverseCopyPixels (destRow, srcRow, width);
+                }
+                else {
+                    std::memcpy (destRow, srcRow, size_t (width) * sizeof (QRgb));
+                }
+            }
+        });
+}
+
+//---------------------------------------------------------------------
+
+// Transposes the square 32-bit image <bits> of <size> x <size> pixels in
+// place, tile by tile.
+static void TransposeSquareInPlace (uchar *bits, int bytesPerLine, int size)
+{
+    const int tileCount = (size + TileSize - 1) / TileSize;
+
+    // Tile row <tileY> swaps the tiles on and to the right of the diagonal
+    // with their mirrors below it, so different tile rows never touch the
+    // same pixels.
+    kpParallel::forEachBand (tileCount,
+        qMax (1, ::MinRowsPerThread (size) / TileSize),
+        [=] (int firstTileY, int endTileY)
+        {
+            // Both tiles are read into these a row at a time before being
+            // written back transposed, a row at a time.  Walking down the
+            // columns of the image instead would, for power-of-2 widths,
+            // keep evicting the same few cache sets and be >2x slower.
+            QRgb tileA [TileSize][TileSize], tileB [TileSize][TileSize];
+
+            for (int tileY = firstTileY; tileY < endTileY; tileY++)
+            {
+                const int y0 = tileY * TileSize;
+                const int y1 = qMin (y0 + TileSize, size);
+
+                for (int tileX = tileY; tileX < tileCount; tileX++)
+                {
+                    const int x0 = tileX * TileSize;
+                    const int x1 = qMin (x0 + TileSize, size);
+
+                    // Tile A is (x0, y0) - (x1, y1) and tile B, its mirror,
+                    // is (y0, x0) - (y1, x1).  On the diagonal, they are the
+                    // same tile.
+                    for (int y = y0; y < y1; y++)
+                    {
+                        std::memcpy (tileA [y - y0], ::PixelRow (bits, bytesPerLine, y) + x0,
+                                     size_t (x1 - x0) * sizeof (QRgb));
+                    }
+                    if (tileX != tileY)
+                    {
+                        for (int x = x0; x < x1; x++)
+                        {
+                            std::memcpy (tileB [x - x0], ::PixelRow (bits, bytesPerLine, x) + y0,
+                                         size_t (y1 - y0) * sizeof (QRgb));
+                        }
+                    }
+
+                    const QRgb (*mirrorOfA) [TileSize] =
+                        (tileX != tileY) ? tileB : tileA;
+
+                    for (int y = y0; y < y1; y++)
+                    {
+                        QRgb *row = ::PixelRow (bits, bytesPerLine, y) + x0;
+                        for (int x = x0; x < x1; x++) {
+                            row [x - x0] = mirrorOfA [x - x0][y - y0];
+                        }
+                    }
+                    if (tileX != tileY)
+                    {
+                        for (int x = x0; x < x1; x++)
+                        {
+                            QRgb *row = ::PixelRow (bits, bytesPerLine, x) + y0;
+                            for (int y = y0; y < y1; y++) {
+                                row [y - y0] = tileA [y - y0][x - x0];
+                            }
+                        }
+                    }
+                }
+            }
+        });
+}
+
+//---------------------------------------------------------------------
+
+// Writes the 32-bit <src> (<srcWidth> x <srcHeight>), rotated by 90
+// degrees clockwise (or anticlockwise), into <dest>, which must be
+// <srcHeight> x <srcWidth>, tile by tile.
+static void RotateQuarterCopy (uchar *destBits, int destBytesPerLine,
+        const uchar *srcBits, int srcBytesPerLine,
+        int srcWidth, int srcHeight,
+        bool clockwise)
+{
+    const int destWidth = srcHeight, destHeight = srcWidth;
+    const int tileRowCount = (destHeight + TileSize - 1) / TileSize;
+
+    kpParallel::forEachBand (tileRowCount,
+        qMax (1, ::MinRowsPerThread (destWidth) / TileSize),
+        [=] (int firstTileY, int endTileY)
+        {
+            for (int tileY = firstTileY; tileY < endTileY; tileY++)
+            {
+                const int y0 = tileY * TileSize;
+                const int y1 = qMin (y0 + TileSize, destHeight);
+
+                for (int x0 = 0; x0 < destWidth; x0 += TileSize)
+                {
+                    const int x1 = qMin (x0 + TileSize, destWidth);
+
+                    for (int y = y0; y < y1; y++)
+                    {
+                        QRgb *destRow = ::PixelRow (destBits, destBytesPerLine, y);
+
+                        if (clockwise)
+                        {
+                            // dest (x, y) = src (y, srcHeight - 1 - x)
+                            for (int x = x0; x < x1; x++)
+                            {
+                                destRow [x] = ::PixelRow (srcBits, srcBytesPerLine,
+                                    srcHeight - 1 - x) [y];
+                            }
+                        }
+                        else
+                        {
+                            // dest (x, y) = src (srcWidth - 1 - y, x)
+                            const int srcX = srcWidth - 1 - y;
+                            for (int x = x0; x < x1; x++)
+                            {
+                                destRow [x] = ::PixelRow (srcBits, srcBytesPerLine, x) [srcX];
+                            }
+                        }
+                    }
+                }
+            }
+        });
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpPixmapFX::flip (QImage *destPtr, bool horiz, bool vert)
+{
+    if (!destPtr || destPtr->isNull () || (!horiz && !vert)) {
+        return;
+    }
+
+#if DEBUG_KP_PIXMAP_FX
+    qCDebug(kpLogPixmapfx) << "kpPixmapFX::flip(size=" << destPtr->size ()
+               << ",horiz=" << horiz << ",vert=" << vert
+               << ") detached=" << destPtr->isDetached ();
+#endif
+
+    if (destPtr->depth () != 32)
+    {
+        *destPtr = destPtr->mirrored (horiz, vert);
+        return;
+    }
+
+    if (destPtr->isDetached ())
+    {
+        ::FlipInPlace (destPtr->bits (), destPtr->bytesPerLine (),
+            destPtr->width (), destPtr->height (),
+            horiz, vert);
+        return;
+    }
+
+    // Someone else holds on to these pixels so writing to them would only
+    // copy them first anyway.  Instead, flip straight into a new image.
+    *destPtr = kpPixmapFX::flip (*destPtr, horiz, vert);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QImage kpPixmapFX::flip (const QImage &pm, bool horiz, bool vert)
+{
+    if (pm.isNull () || (!horiz && !vert)) {
+        return pm;
+    }
+
+    if (pm.depth () != 32) {
+        return pm.mirrored (horiz, vert);
+    }
+
+    QImage ret (pm.size (), pm.format ());
+    if (ret.isNull ())
+    {
+        qCCritical(kpLogPixmapfx) << "kpPixmapFX::flip() could not allocate" << pm.size ();
+        return pm;
+    }
+
+    ::FlipCopy (ret.bits (), ret.bytesPerLine (),
+        pm.constBits (), pm.bytesPerLine (),
+        pm.width (), pm.height (),
+        horiz, vert);
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpPixmapFX::rotateQuarterTurns (QImage *destPtr, int quarterTurns)
+{
+    if (!destPtr || destPtr->isNull ()) {
+        return;
+    }
+
+    // Normalize to 0 (no rotation), 1 (90 degrees clockwise), 2 (180) or
+    // 3 (90 degrees anticlockwise).
+    quarterTurns = ((quarterTurns % 4) + 4) % 4;
+
+#if DEBUG_KP_PIXMAP_FX
+    qCDebug(kpLogPixmapfx) << "kpPixmapFX::rotateQuarterTurns(size=" << destPtr->size ()
+               << ",quarterTurns=" << quarterTurns
+               << ") detached=" << destPtr->isDetached ();
+#endif
+
+    if (quarterTurns == 0) {
+        return;
+    }
+
+    if (quarterTurns == 2)
+    {
+        kpPixmapFX::flip (destPtr, true/*horiz*/, true/*vert*/);
+        return;
+    }
+
+    const bool clockwise = (quarterTurns == 1);
+
+    if (destPtr->depth () != 32)
+    {
+        *destPtr = destPtr->transformed (QTransform ().rotate (clockwise ? 90 : -90));
+        return;
+    }
+
+    const int width = destPtr->width (), height = destPtr->height ();
+
+    if (width == height && destPtr->isDetached ())
+    {
+        // Rotating is transposing, then reversing each row (clockwise) or
+        // the row order (anticlockwise).
+        ::TransposeSquareInPlace (destPtr->bits (), destPtr->bytesPerLine (), width);
+        ::FlipInPlace (destPtr->bits (), destPtr->bytesPerLine (), width, height,
+            clockwise/*horiz*/, !clockwise/*vert*/);
+        return;
+    }
+
+    QImage ret (height, width, destPtr->format ());
+    if (ret.isNull ())
+    {
+        qCCritical(kpLogPixmapfx) << "kpPixmapFX::rotateQuarterTurns() could not allocate"
+                                  << ret.size ();
+        return;
+    }
+
+    const QImage &src = *destPtr;
+    ::RotateQuarterCopy (ret.bits (), ret.bytesPerLine (),
+        src.constBits (), src.bytesPerLine (),
+        width, height,
+        clockwise);
+    *destPtr = ret;
+}
+
+//---------------------------------------------------------------------
@@ -31,17 +31,26 @@
 
 #include "kpPixmapFX.h"
 
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
 #include <QtMath>
 
 #include <QPainter>
 #include <QImage>
 #include <QPoint>
 #include <QRect>
+#include <QTransform>
 
 #include "kpLogCategories.h"
 
+#include "generic/kpParallel.h"
 #include "layers/selections/kpAbstractSelection.h"
 #include "imagelib/kpColor.h"
+#include "imagelib/kpImageScaler.h"
 #include "kpDefs.h"
 
 //---------------------------------------------------------------------
@@ -122,8 +131,11 @@ QImage kpPixmapFX::scale (const QImage &image, int w, int h, bool pretty)
         return image;
     }
 
-    return image.scaled(w, h, Qt::IgnoreAspectRatio,
-                        pretty ? Qt::SmoothTransformation : Qt::FastTransformation);
+    if (pretty && w > 0 && h > 0) {
+        return kpImageScaler::scale (image, w, h);
+    }
+
+    return image.scaled(w, h, Qt::IgnoreAspectRatio, Qt::FastTransformation);
 }
 
 //---------------------------------------------------------------------
@@ -257,6 +269,233 @@ static QTransform TrueMatrix (const QTransform &matrix, int srcPixmapWidth, int
 
 //---------------------------------------------------------------------
 
+// Returns the pixel (<x>, <y>) of <src> or <outsidePixel>, if that is outside
+// <src>.
+static inline QRgb SourcePixel (const uchar *srcBits, int srcBytesPerLine,
+        int srcWidth, int srcHeight,
+        int x, int y, QRgb outsidePixel)
+{
+    if (uint (x) >= uint (srcWidth) || uint (y) >= uint (srcHeight)) {
+        return outsidePixel;
+    }
+
+    return reinterpret_cast <const QRgb *> (srcBits + y * srcBytesPerLine) [x];
+}
+
+//---------------------------------------------------------------------
+
+// Returns the bilinear interpolation of the premultiplied pixels
+// <topLeft>, <topRight>, <bottomLeft> and <bottomRight>, where <distX> and
+// <distY> (0-256) are how far the sample point is from <topLeft>.
+//
+// The scalar and SSE2 versions round identically so the result does not
+// depend on how the program was compiled.
+static inline QRgb InterpolatePixels (QRgb topLeft, QRgb topRight,
+        QRgb bottomLeft, QRgb bottomRight,
+        uint distX, uint distY)
+{
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+
+    const __m128i top = _mm_unpacklo_epi8 (
+        _mm_set_epi32 (0, 0, int (topRight), int (topLeft)), zero);
+    const __m128i bottom = _mm_unpacklo_epi8 (
+        _mm_set_epi32 (0, 0, int (bottomRight), int (bottomLeft)), zero);
+
+    // Left pixel in the low 4 lanes, right pixel in the high 4 lanes.
+    __m128i v = _mm_add_epi16 (
+        _mm_mullo_epi16 (top, _mm_set1_epi16 (short (256 - distY))),
+        _mm_mullo_epi16 (bottom, _mm_set1_epi16 (short (distY))));
+    v = _mm_srli_epi16 (v, 8);
+
+    const short leftWeight = short (256 - distX), rightWeight = short (distX);
+    v = _mm_mullo_epi16 (v, _mm_set_epi16 (rightWeight, rightWeight, rightWeight, rightWeight,
+                                           leftWeight, leftWeight, leftWeight, leftWeight));
+    v = _mm_add_epi16 (v, _mm_srli_si128 (v, 8));
+    v = _mm_srli_epi16 (v, 8);
+
+    return QRgb (_mm_cvtsi128_si32 (_mm_packus_epi16 (v, v)));
+#else
+    // Returns (<x> * <a> + <y> * <b>) / 256 for each channel, 2 channels
+    // at a time.  <a> + <b> must be 256.
+    auto interpolate = [] (QRgb x, uint a, QRgb y, uint b) -> QRgb {
+        const quint32 rb = (((x & 0x00FF00FF) * a + (y & 0x00FF00FF) * b) >> 8) & 0x00FF00FF;
+        const quint32 ag = (((x >> 8) & 0x00FF00FF) * a + ((y >> 8) & 0x00FF00FF) * b) & 0xFF00FF00;
+        return rb | ag;
+    };
+
+    const QRgb left = interpolate (topLeft, 256 - distY, bottomLeft, distY);
+    const QRgb right = interpolate (topRight, 256 - distY, bottomRight, distY);
+    return interpolate (left, 256 - distX, right, distX);
+#endif
+}
+
+//---------------------------------------------------------------------
+
+// Returns whether <matrix> only shuffles whole pixels around i.e. it is a
+// flip and/or a rotation by a multiple of 90 degrees, with a whole pixel
+// translation.
+static bool IsPixelPermutation (const QTransform &matrix)
+{
+    auto isUnitOrZero = [] (double v) {
+        return v == 0 || v == 1 || v == -1;
+    };
+    auto isInt = [] (double v) {
+        return v == std::floor (v);
+    };
+
+    if (matrix.type () > QTransform::TxRotate) {
+        return false;
+    }
+
+    return isUnitOrZero (matrix.m11 ()) && isUnitOrZero (matrix.m12 ()) &&
+           isUnitOrZero (matrix.m21 ()) && isUnitOrZero (matrix.m22 ()) &&
+           (matrix.m11 () == 0) == (matrix.m22 () == 0) &&
+           (matrix.m11 () == 0) != (matrix.m12 () == 0) &&
+           isInt (matrix.dx ()) && isInt (matrix.dy ());
+}
+
+//---------------------------------------------------------------------
+
+// Renders <src> into all of <destPtr>, transformed by <matrix>, filling
+// areas not covered by <src> with <outsidePixel>.
+//
+// Every destination pixel centre is mapped back through the inverse of
+// <matrix> and is given the nearest source pixel or, if <pretty>, the
+// bilinear interpolation of the 4 nearest source pixels.  Flips and
+// rotations by multiples of 90 degrees take an exact integer path.
+//
+// This samples the same pixels as drawing with a transformed QPainter,
+// without SmoothPixmapTransform, but spreads the rows across threads and
+// does not go through QPainter's generic transform code for lossless
+// rotations.
+//
+// ASSUMPTION: <destPtr> and <src> are Format_ARGB32_Premultiplied.
+static void ResampleImage (QImage *destPtr, const QImage &src,
+        const QTransform &matrix, QRgb outsidePixel, bool pretty)
+{
+    Q_ASSERT (destPtr->format () == QImage::Format_ARGB32_Premultiplied);
+    Q_ASSERT (src.format () == QImage::Format_ARGB32_Premultiplied);
+
+    bool invertible = false;
+    const QTransform inverse = matrix.inverted (&invertible);
+    if (!invertible || src.isNull ())
+    {
+        destPtr->fill (outsidePixel);
+        return;
+    }
+
+    const int destWidth = destPtr->width ();
+    const int destBytesPerLine = destPtr->bytesPerLine ();
+    // Grab the pointers before the threads start, so that none of them
+    // can race to detach the images.
+    uchar * const destBits = destPtr->bits ();
+
+    const int srcWidth = src.width (), srcHeight = src.height ();
+    const int srcBytesPerLine = src.bytesPerLine ();
+    const uchar * const srcBits = src.constBits ();
+
+    const bool permutation = !pretty && ::IsPixelPermutation (inverse);
+
+    // Source positions are stepped along each destination row in 32.32
+    // fixed point, which stays exact for far wider images than 16.16
+    // would.
+    const double fixedOne = 4294967296.0;
+    const qint64 stepX = qint64 (inverse.m11 () * fixedOne);
+    const qint64 stepY = qint64 (inverse.m12 () * fixedOne);
+
+    auto resampleRows = [&] (int firstRow, int endRow)
+    {
+        for (int y = firstRow; y < endRow; y++)
+        {
+            auto *destLine = reinterpret_cast <QRgb *> (destBits + y * destBytesPerLine);
+
+            // Where the centre of the first pixel of this row came from.
+            const QPointF srcStart = inverse.map (QPointF (0.5, y + 0.5));
+
+            if (permutation)
+            {
+                // Each step along the row moves exactly 1 source pixel
+                // horizontally or vertically.
+                int sx = int (std::floor (srcStart.x ()));
+                int sy = int (std::floor (srcStart.y ()));
+                const int dsx = int (inverse.m11 ()), dsy = int (inverse.m12 ());
+
+                if (dsx == 1 && dsy == 0 &&
+                    sx >= 0 && sx + destWidth <= srcWidth &&
+                    sy >= 0 && sy < srcHeight)
+                {
+                    std::memcpy (destLine,
+                        srcBits + sy * srcBytesPerLine + sx * int (sizeof (QRgb)),
+                        size_t (destWidth) * sizeof (QRgb));
+                    continue;
+                }
+
+                for (int x = 0; x < destWidth; x++, sx += dsx, sy += dsy)
+                {
+                    destLine [x] = ::SourcePixel (srcBits, srcBytesPerLine,
+                        srcWidth, srcHeight, sx, sy, outsidePixel);
+                }
+
+                continue;
+            }
+
+            if (!pretty)
+            {
+                qint64 fx = qint64 (srcStart.x () * fixedOne);
+                qint64 fy = qint64 (srcStart.y () * fixedOne);
+                for (int x = 0; x < destWidth; x++, fx += stepX, fy += stepY)
+                {
+                    // (Arithmetic shifts round towards negative infinity, like
+                    //  std::floor().)
+                    destLine [x] = ::SourcePixel (srcBits, srcBytesPerLine,
+                        srcWidth, srcHeight, int (fx >> 32), int (fy >> 32),
+                        outsidePixel);
+                }
+
+                continue;
+            }
+
+            // Sample between the 4 source pixels whose centres surround
+            // the point.
+            qint64 fx = qint64 ((srcStart.x () - 0.5) * fixedOne);
+            qint64 fy = qint64 ((srcStart.y () - 0.5) * fixedOne);
+            for (int x = 0; x < destWidth; x++, fx += stepX, fy += stepY)
+            {
+                const int sx = int (fx >> 32), sy = int (fy >> 32);
+                // The top 8 bits of the fraction, 0-255.
+                const uint distX = uint ((fx >> 24) & 0xFF);
+                const uint distY = uint ((fy >> 24) & 0xFF);
+
+                if (sx < -1 || sx >= srcWidth || sy < -1 || sy >= srcHeight)
+                {
+                    destLine [x] = outsidePixel;
+                    continue;
+                }
+
+                destLine [x] = ::InterpolatePixels (
+                    ::SourcePixel (srcBits, srcBytesPerLine, srcWidth, srcHeight,
+                        sx, sy, outsidePixel),
+                    ::SourcePixel (srcBits, srcBytesPerLine, srcWidth, srcHeight,
+                        sx + 1, sy, outsidePixel),
+                    ::SourcePixel (srcBits, srcBytesPerLine, srcWidth, srcHeight,
+                        sx, sy + 1, outsidePixel),
+                    ::SourcePixel (srcBits, srcBytesPerLine, srcWidth, srcHeight,
+                        sx + 1, sy + 1, outsidePixel),
+                    distX, distY);
+            }
+        }
+    };
+
+    // Bands of at least ~64K pixels, so that small previews are not
+    // slowed down by thread hand-off.
+    kpParallel::forEachBand (destPtr->height (),
+        qMax (1, 65536 / qMax (1, destWidth)),
+        resampleRows);
+}
+
+//---------------------------------------------------------------------
+
 // Like QPixmap::transformed() but fills new areas with <backgroundColor>
 // (unless <backgroundColor> is invalid) and works around internal QTransform
 // floating point -> integer oddities, that would otherwise give fatally
@@ -268,9 +507,13 @@ static QTransform TrueMatrix (const QTransform &matrix, int srcPixmapWidth, int
 //
 // Use <targetWidth> and <targetHeight> to specify the intended output size
 // of the pixmap.  -1 if don't care.
+//
+// If <pretty>, source pixels are interpolated instead of picked, which is
+// smoother but blurs.
 static QImage TransformPixmap (const QImage &pm, const QTransform &transformMatrix_,
         const kpColor &backgroundColor,
-        int targetWidth, int targetHeight)
+        int targetWidth, int targetHeight,
+        bool pretty)
 {
     QTransform transformMatrix = transformMatrix_;
 
@@ -418,40 +661,23 @@ static QImage TransformPixmap (const QImage &pm, const QTransform &transformMatr
     }
 
 
-#if DEBUG_KP_PIXMAP_FX && 0
-    qCDebug(kpLogPixmapfx) << "\ttranslate top=" << painter.xForm (QPoint (0, 0));
-    qCDebug(kpLogPixmapfx) << "\tmatrix: m11=" << painter.worldMatrix ().m11 ()
-               << " m12=" << painter.worldMatrix ().m12 ()
-               << " m21=" << painter.worldMatrix ().m21 ()
-               << " m22=" << painter.worldMatrix ().m22 ()
-               << " dx=" << painter.worldMatrix ().dx ()
-               << " dy=" << painter.worldMatrix ().dy ()
-               << endl;
-#endif
-
-
-    // Note: Do _not_ use "p.setRenderHints (QPainter::SmoothPixmapTransform);"
+    // Note: Do _not_ resample prettily here for real edits,
     //       as the user does not want their image to get blurier every
     //       time they e.g. rotate it (especially important for multiples
     //       of 90 degrees but also true for every other angle).  Being a
     //       pixel-based program, we generally like to preserve RGB values
     //       and avoid unnecessary blurs -- in the worst case, we'd rather
     //       drop pixels, than blur.
-    QPainter p (&newQImage);
-    {
-        // Make sure transparent pixels are drawn into the destination image.
-        p.setCompositionMode (QPainter::CompositionMode_Source);
-
-        // Fill the entire new image with the background color.
-        if (backgroundColor.isValid ())
-        {
-            p.fillRect (newQImage.rect (), backgroundColor.toQColor ());
-        }
-
-        p.setWorldTransform (transformMatrix);
-        p.drawImage (QPoint (0, 0), pm);
-    }
-    p.end ();
+    //
+    //       <pretty> is only for throwaway previews.
+    //
+    // Transparent pixels are copied into the destination image as is,
+    // rather than blended with the background color.
+    const QImage src = (pm.format () == QImage::Format_ARGB32_Premultiplied) ?
+        pm : pm.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+    ::ResampleImage (&newQImage, src, transformMatrix,
+        backgroundColor.isValid () ? qPremultiply (backgroundColor.toQRgb ()) : 0,
+        pretty);
 
 #if DEBUG_KP_PIXMAP_FX && 1
     qCDebug(kpLogPixmapfx) << "Done";
@@ -523,7 +749,8 @@ QTransform kpPixmapFX::skewMatrix (const QImage &pixmap, double hangle, double v
 // public static
 void kpPixmapFX::skew (QImage *destPtr, double hangle, double vangle,
                        const kpColor &backgroundColor,
-                       int targetWidth, int targetHeight)
+                       int targetWidth, int targetHeight,
+                       bool pretty)
 {
     if (!destPtr) {
         return;
@@ -531,7 +758,8 @@ void kpPixmapFX::skew (QImage *destPtr, double hangle, double vangle,
 
     *destPtr = kpPixmapFX::skew (*destPtr, hangle, vangle,
                                        backgroundColor,
-                                       targetWidth, targetHeight);
+                                       targetWidth, targetHeight,
+                                       pretty);
 }
 
 //---------------------------------------------------------------------
@@ -539,7 +767,8 @@ void kpPixmapFX::skew (QImage *destPtr, double hangle, double vangle,
 // public static
 QImage kpPixmapFX::skew (const QImage &pm, double hangle, double vangle,
                           const kpColor &backgroundColor,
-                          int targetWidth, int targetHeight)
+                          int targetWidth, int targetHeight,
+                          bool pretty)
 {
 #if DEBUG_KP_PIXMAP_FX
     qCDebug(kpLogPixmapfx) << "kpPixmapFX::skew() pm.width=" << pm.width ()
@@ -567,7 +796,8 @@ QImage kpPixmapFX::skew (const QImage &pm, double hangle, double vangle,
 
     QTransform matrix = skewMatrix (pm, hangle, vangle);
 
-    return ::TransformPixmap (pm, matrix, backgroundColor, targetWidth, targetHeight);
+    return ::TransformPixmap (pm, matrix, backgroundColor, targetWidth, targetHeight,
+        pretty);
 }
 
 //---------------------------------------------------------------------
@@ -636,15 +866,24 @@ bool kpPixmapFX::isLosslessRotation (double angle)
 // public static
 void kpPixmapFX::rotate (QImage *destPtr, double angle,
                          const kpColor &backgroundColor,
-                         int targetWidth, int targetHeight)
+                         int targetWidth, int targetHeight,
+                         bool pretty)
 {
     if (!destPtr) {
         return;
     }
 
+    if (kpPixmapFX::isLosslessRotation (angle) &&
+        (targetWidth <= 0 && targetHeight <= 0)/*don't want to scale?*/)
+    {
+        kpPixmapFX::rotateQuarterTurns (destPtr, qRound (angle / 90));
+        return;
+    }
+
     *destPtr = kpPixmapFX::rotate (*destPtr, angle,
                                          backgroundColor,
-                                         targetWidth, targetHeight);
+                                         targetWidth, targetHeight,
+                                         pretty);
 }
 
 //---------------------------------------------------------------------
@@ -652,7 +891,8 @@ void kpPixmapFX::rotate (QImage *destPtr, double angle,
 // public static
 QImage kpPixmapFX::rotate (const QImage &pm, double angle,
                             const kpColor &backgroundColor,
-                            int targetWidth, int targetHeight)
+                            int targetWidth, int targetHeight,
+                            bool pretty)
 {
     if (std::fabs (angle - 0) < kpPixmapFX::AngleInDegreesEpsilon &&
         (targetWidth <= 0 && targetHeight <= 0)/*don't want to scale?*/)
@@ -660,10 +900,19 @@ QImage kpPixmapFX::rotate (const QImage &pm, double angle,
         return pm;
     }
 
+    if (kpPixmapFX::isLosslessRotation (angle) &&
+        (targetWidth <= 0 && targetHeight <= 0)/*don't want to scale?*/)
+    {
+        QImage ret = pm;
+        kpPixmapFX::rotateQuarterTurns (&ret, qRound (angle / 90));
+        return ret;
+    }
+
 
     QTransform matrix = rotateMatrix (pm, angle);
 
-    return ::TransformPixmap (pm, matrix, backgroundColor, targetWidth, targetHeight);
+    return ::TransformPixmap (pm, matrix, backgroundColor, targetWidth, targetHeight,
+        pretty);
 }
 
 //---------------------------------------------------------------------
@@ -0,0 +1,184 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#define DEBUG_KP_PIXMAP_FX 0
+
+
+#include "kpPixmapFX.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QVarLengthArray>
+
+#include "kpLogCategories.h"
+
+//---------------------------------------------------------------------
+
+// Sets <count> pixels starting at <dest> to <pixel>.
+static inline void FillPixels (QRgb *dest, int count, QRgb pixel)
+{
+#if defined(__SSE2__)
+    const __m128i pixels = _mm_set1_epi32 (int (pixel));
+    for (; count >= 4; count -= 4, dest += 4) {
+        _mm_storeu_si128 (reinterpret_cast <__m128i *> (dest), pixels);
+    }
+#endif
+
+    for (; count > 0; count--) {
+        *dest++ = pixel;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Returns premultiplied <src> composited on top of premultiplied <dest>.
+static inline QRgb BlendPixel (QRgb src, QRgb dest)
+{
+    const quint32 srcAlpha = qAlpha (src);
+    if (srcAlpha == 0xFF) {
+        return src;
+    }
+    if (srcAlpha == 0) {
+        return dest;
+    }
+
+    // dest * (255 - srcAlpha) / 255, 2 channels at a time.
+    const quint32 invAlpha = 0xFF - srcAlpha;
+
+    quint32 rb = (dest & 0x00FF00FF) * invAlpha;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF) + 0x00800080) >> 8) & 0x00FF00FF;
+
+    quint32 ag = ((dest >> 8) & 0x00FF00FF) * invAlpha;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF) + 0x00800080) & 0xFF00FF00;
+
+    return src + (rb | ag);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpPixmapFX::drawZoomedImage (QImage *destPtr, const QRect &destRect,
+        const QImage &src, const QPoint &srcTopLeft,
+        int hzoom, int vzoom,
+        bool blend,
+        const kpColor &gridColor)
+{
+#if DEBUG_KP_PIXMAP_FX && 1
+    qCDebug(kpLogPixmapfx) << "kpPixmapFX::drawZoomedImage(destRect=" << destRect
+              << ",srcTopLeft=" << srcTopLeft
+              << ",zoom=" << hzoom << "x" << vzoom
+              << ",blend=" << blend
+              << ",grid=" << gridColor.isValid () << ")";
+#endif
+
+    Q_ASSERT (destPtr);
+    Q_ASSERT (destPtr->format () == QImage::Format_ARGB32_Premultiplied);
+    Q_ASSERT (src.format () == QImage::Format_ARGB32_Premultiplied);
+    Q_ASSERT (hzoom >= 1 && vzoom >= 1);
+
+    const QRect zoomedSrcRect (srcTopLeft,
+        QSize (src.width () * hzoom, src.height () * vzoom));
+    const QRect rect = destRect & zoomedSrcRect & destPtr->rect ();
+    if (rect.isEmpty ()) {
+        return;
+    }
+
+    const bool drawGrid = gridColor.isValid ();
+    const QRgb gridPixel = drawGrid ? qPremultiply (gridColor.toQRgb ()) : 0;
+
+    // The zoomed column of <src> at <rect.left()> and the first grid line
+    // column, relative to <rect.left()>.
+    const int firstZoomedX = rect.left () - srcTopLeft.x ();
+    const int firstGridX = (hzoom - firstZoomedX % hzoom) % hzoom;
+
+    // One enlarged row of <src>, reused for the <vzoom> rows it covers.
+    QVarLengthArray <QRgb, 1024> zoomedRow (rect.width ());
+    int zoomedRowSrcY = -1;
+
+    for (int y = rect.top (); y <= rect.bottom (); y++)
+    {
+        const int zoomedY = y - srcTopLeft.y ();
+        auto *destLine = reinterpret_cast <QRgb *> (destPtr->scanLine (y)) + rect.left ();
+
+        if (drawGrid && zoomedY % vzoom == 0)
+        {
+            FillPixels (destLine, rect.width (), gridPixel);
+            continue;
+        }
+
+        const int srcY = zoomedY / vzoom;
+        if (srcY != zoomedRowSrcY)
+        {
+            const auto *srcLine = reinterpret_cast <const QRgb *> (src.constScanLine (srcY));
+
+            QRgb *out = zoomedRow.data ();
+            int zoomedX = firstZoomedX;
+            int remaining = rect.width ();
+            while (remaining > 0)
+            {
+                const int run = qMin (hzoom - zoomedX % hzoom, remaining);
+                FillPixels (out, run, srcLine [zoomedX / hzoom]);
+
+                out += run;
+                zoomedX += run;
+                remaining -= run;
+            }
+
+            if (drawGrid)
+            {
+                for (int x = firstGridX; x < rect.width (); x += hzoom) {
+                    zoomedRow [x] = gridPixel;
+                }
+            }
+
+            zoomedRowSrcY = srcY;
+        }
+
+        if (!blend)
+        {
+            std::memcpy (destLine, zoomedRow.constData (),
+                         size_t (rect.width ()) * sizeof (QRgb));
+        }
+        else
+        {
+            for (int x = 0; x < rect.width (); x++) {
+                destLine [x] = BlendPixel (zoomedRow [x], destLine [x]);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------
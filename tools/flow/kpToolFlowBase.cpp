@@ -68,14 +68,11 @@ struct kpToolFlowBasePrivate
 
         kpTempImage::UserFunctionType brushDrawFunc{}, cursorDrawFunc{};
 
-        // Can't use union since package types contain fields requiring
-        // constructors.
-        kpToolWidgetBrush::DrawPackage brushDrawPackageForMouseButton [2];
-        kpToolWidgetEraserSize::DrawPackage eraserDrawPackageForMouseButton [2];
-
-        // Each element points to one of the above (both elements from the same
-        // array).
-        void *drawPackageForMouseButton [2]{};
+        // Each element is a kpToolWidgetBrush::DrawPackage or a
+        // kpToolWidgetEraserSize::DrawPackage (both elements of the same
+        // type).  They are shared with the cursor's temporary image, which
+        // may outlive us.
+        QSharedPointer <void> drawPackageForMouseButton [2];
 
         int brushWidth{}, brushHeight{};
         int cursorWidth{}, cursorHeight{};
@@ -117,16 +114,9 @@ void kpToolFlowBase::clearBrushCursorData ()
 {
     d->brushDrawFunc = d->cursorDrawFunc = nullptr;
 
-    memset (&d->brushDrawPackageForMouseButton,
-        0,
-        sizeof (d->brushDrawPackageForMouseButton));
-    memset (&d->eraserDrawPackageForMouseButton,
-        0,
-        sizeof (d->eraserDrawPackageForMouseButton));
-
-    memset (&d->drawPackageForMouseButton,
-        0,
-        sizeof (d->drawPackageForMouseButton));
+    for (auto &drawPackage : d->drawPackageForMouseButton) {
+        drawPackage.reset ();
+    }
 
     d->brushWidth = d->brushHeight = 0;
     d->cursorWidth = d->cursorHeight = 0;
@@ -358,7 +348,7 @@ kpTempImage::UserFunctionType kpToolFlowBase::brushDrawFunction () const
 // protected
 void *kpToolFlowBase::brushDrawFunctionData () const
 {
-    return d->drawPackageForMouseButton [mouseButton ()];
+    return d->drawPackageForMouseButton [mouseButton ()].data ();
 }
 
 
@@ -404,7 +394,7 @@ void kpToolFlowBase::updateBrushAndCursor ()
         for (int i = 0; i < 2; i++)
         {
             d->drawPackageForMouseButton [i] =
-                &(d->eraserDrawPackageForMouseButton [i] =
+                QSharedPointer <kpToolWidgetEraserSize::DrawPackage>::create (
                     d->toolWidgetEraserSize->drawFunctionData (color (i)));
         }
 
@@ -421,7 +411,7 @@ void kpToolFlowBase::updateBrushAndCursor ()
         for (int i = 0; i < 2; i++)
         {
             d->drawPackageForMouseButton [i] =
-                &(d->brushDrawPackageForMouseButton [i] =
+                QSharedPointer <kpToolWidgetBrush::DrawPackage>::create (
                     d->toolWidgetBrush->drawFunctionData (color (i)));
         }
 
@@ -80,6 +80,9 @@ class kpToolFlowBase : public kpTool
     void endDraw(const QPoint &, const QRect &) override;
 
   protected:
+    // Freehand strokes must go through every point the mouse visited.
+    bool careAboutIntermediateMouseMoves() const override { return true; }
+
     virtual QString haventBegunDrawUserMessage() const = 0;
 
     virtual bool haveSquareBrushes() const { return false; }
@@ -33,6 +33,7 @@
 #include "kpDefs.h"
 #include "document/kpDocument.h"
 #include "imagelib/kpPainter.h"
+#include "imagelib/kpSpraycanEngine.h"
 #include "pixmapfx/kpPixmapFX.h"
 #include "environments/tools/kpToolEnvironment.h"
 #include "commands/tools/flow/kpToolFlowCommand.h"
@@ -44,7 +45,9 @@
 #include <cstdlib>
 
 #include "kpLogCategories.h"
+#include <KConfigGroup>
 #include <KLocalizedString>
+#include <KSharedConfig>
 
 #include <QPoint>
 #include <QRect>
@@ -56,7 +59,8 @@ kpToolSpraycan::kpToolSpraycan (kpToolEnvironment *environ, QObject *parent)
     : kpToolFlowBase (i18n ("Spraycan"), i18n ("Sprays graffiti"),
         Qt::Key_Y,
         environ, parent, QStringLiteral("tool_spraycan")),
-    m_toolWidgetSpraycanSize(nullptr)
+    m_toolWidgetSpraycanSize(nullptr),
+    m_engine (new kpSpraycanEngine ())
 {
     m_timer = new QTimer (this);
     m_timer->setInterval (25/*ms*/);
@@ -65,6 +69,13 @@ kpToolSpraycan::kpToolSpraycan (kpToolEnvironment *environ, QObject *parent)
 
 //---------------------------------------------------------------------
 
+kpToolSpraycan::~kpToolSpraycan ()
+{
+    delete m_engine;
+}
+
+//---------------------------------------------------------------------
+
 // protected virtual [base kpToolFlowBase]
 QString kpToolSpraycan::haventBegunDrawUserMessage () const
 {
@@ -84,6 +95,19 @@ void kpToolSpraycan::begin ()
              this, &kpToolSpraycan::slotSpraycanSizeChanged);
     m_toolWidgetSpraycanSize->show ();
 
+    m_engine->setSpraycanSize (m_toolWidgetSpraycanSize->spraycanSize ());
+
+
+    // (only configurable by editing kolourpaintrc)
+    KConfigGroup cfg (KSharedConfig::openConfig (), kpSettingsGroupTools);
+    const int density = cfg.readEntry (kpSettingSpraycanDensity,
+                                       kpSpraycanEngine::DefaultDensity);
+    m_engine->setDensity (qBound (1, density, 1000));
+#if DEBUG_KP_TOOL_SPRAYCAN
+    qCDebug(kpLogTools) << "\tdensity=" << m_engine->density ();
+#endif
+
+
     kpToolFlowBase::begin ();
 }
 
@@ -139,34 +163,30 @@ QRect kpToolSpraycan::drawLineWithProbability (const QPoint &thisPoint,
     }
 
 
-    // For efficiency, only get image after NOP check above.
-    QRect docRect = kpPainter::normalizedRect(thisPoint, lastPoint);
-    docRect = neededRect (docRect, spraycanSize ());
-    kpImage image = document ()->getImageAt (docRect);
-
-
-    // Spray at each point, onto the image.
+    // Spray at each point, straight onto the document's image.  There is
+    // no need to copy the image out and back in since kpToolFlowCommand
+    // already holds an implicitly shared copy of the original document.
     //
     // Note in passing: Unlike other tools such as the Brush, drawing
     //                  over the same point does result in a different
     //                  appearance.
+    const QRect dirtyRect = m_engine->sprayPoints (document ()->imagePointer (),
+        docPoints,
+        color (mouseButton ()));
+#if DEBUG_KP_TOOL_SPRAYCAN
+    qCDebug(kpLogTools) << "\tdirtyRect=" << dirtyRect;
+#endif
 
-    QList <QPoint> imagePoints;
-    for (const auto &dp : docPoints)
-        imagePoints.append (dp - docRect.topLeft ());
-
-    kpPainter::sprayPoints (&image,
-        imagePoints,
-        color (mouseButton ()),
-        spraycanSize ());
-
+    if (dirtyRect.isEmpty ()) {
+        return {};
+    }
 
     viewManager ()->setFastUpdates ();
-    document ()->setImageAt (image, docRect.topLeft ());
+    document ()->slotContentsChanged (dirtyRect);
     viewManager ()->restoreFastUpdates ();
 
 
-    return docRect;
+    return dirtyRect;
 }
 
 // public virtual [base kpToolFlowBase]
@@ -252,7 +272,7 @@ int kpToolSpraycan::spraycanSize () const
 // protected slot
 void kpToolSpraycan::slotSpraycanSizeChanged (int size)
 {
-    (void) size;
+    m_engine->setSpraycanSize (size);
 }
 
 
@@ -38,6 +38,7 @@ class QRect;
 class QString;
 class QTimer;
 
+class kpSpraycanEngine;
 class kpToolWidgetSpraycanSize;
 
 
@@ -47,6 +48,7 @@ Q_OBJECT
 
 public:
     kpToolSpraycan (kpToolEnvironment *environ, QObject *parent);
+    ~kpToolSpraycan () override;
 
 protected:
     QString haventBegunDrawUserMessage () const override;
@@ -84,6 +86,7 @@ protected slots:
 protected:
     QTimer *m_timer;
     kpToolWidgetSpraycanSize *m_toolWidgetSpraycanSize;
+    kpSpraycanEngine *m_engine;
 };
 
 
@@ -35,6 +35,8 @@
 
 #include <climits>
 
+#include <QTimer>
+
 #include <KActionCollection>
 #include "kpLogCategories.h"
 #include <KLocalizedString>
@@ -72,6 +74,15 @@ kpTool::kpTool(const QString &text, const QString &description,
     d->userShapeEndPoint = KP_INVALID_POINT;
     d->userShapeSize = KP_INVALID_SIZE;
 
+    d->mouseMoveTimer = new QTimer (this);
+    d->mouseMoveTimer->setSingleShot (true);
+    d->mouseMoveTimer->setTimerType (Qt::PreciseTimer);
+    connect (d->mouseMoveTimer, &QTimer::timeout,
+             this, &kpTool::flushQueuedMouseMoves);
+
+    d->latencyNumFrames = 0;
+    d->latencyTotalNSecs = d->latencyMaxNSecs = 0;
+
     d->environ = environ;
 
     setObjectName(name);
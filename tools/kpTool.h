@@ -218,6 +218,12 @@ protected:
     virtual bool careAboutModifierState () const { return false; }
     virtual bool careAboutColorsSwapped () const { return false; }
 
+    // Whether draw() should be called for every mouse move made during a
+    // single display frame, instead of just the last one (see
+    // flushQueuedMouseMoves()).  Freehand tools need every point;
+    // tools that redraw a whole shape on each draw() do not.
+    virtual bool careAboutIntermediateMouseMoves () const { return false; }
+
     virtual void beginDraw ();
 
     // mouse move without button pressed
@@ -320,6 +326,21 @@ public:
 
     virtual void wheelEvent (QWheelEvent *e);
 
+private:
+    // Mouse moves received while drawing are not drawn immediately.
+    // Instead, they are queued and drawn in a batch once per display frame,
+    // with a single repaint of the united dirty region.  This stops
+    // high-rate mice and tablets from triggering a repaint per event.
+    void queueMouseMove (const QPoint &viewPoint);
+
+    // Draws all queued mouse moves now.  Call this before acting on any
+    // other input, to preserve the order of events.
+    void flushQueuedMouseMoves ();
+    void discardQueuedMouseMoves ();
+
+    // Draws a single mouse move at <viewPoint> of viewUnderStartPoint().
+    void drawMouseMove (const QPoint &viewPoint);
+
 
 //
 // Keyboard Events
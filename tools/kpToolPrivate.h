@@ -30,6 +30,8 @@
 #define kpToolPrivate_H
 
 
+#include <QElapsedTimer>
+#include <QList>
 #include <QPoint>
 #include <QPointer>
 
@@ -39,6 +41,8 @@
   #undef environ  // macro on win32
 #endif
 
+class QTimer;
+
 class kpToolAction;
 class kpToolEnvironment;
 
@@ -63,6 +67,19 @@ struct kpToolPrivate
 
     kpView *viewUnderStartPoint;
 
+    // Mouse move coalescing (see kpTool::queueMouseMove()).
+    QTimer *mouseMoveTimer;
+    QList <QPoint> queuedMouseMoveViewPoints;
+    // Started when the first mouse move of the current batch is queued.
+    QElapsedTimer queuedMouseMoveAge;
+    // Started after each batch has been drawn.
+    QElapsedTimer lastMouseMoveFlush;
+
+    // Input-to-pixel latency statistics for the current draw operation
+    // (reported in endDrawInternal()).
+    int latencyNumFrames;
+    qint64 latencyTotalNSecs, latencyMaxNSecs;
+
 
     // Set to 2 when the user swaps the foreground and background color.
     //
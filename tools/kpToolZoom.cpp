@@ -67,7 +67,6 @@ static void DrawZoomRect (kpImage *destImage,
 struct kpToolZoomPrivate
 {
     bool dragHasBegun{}, dragCompleted{};
-    DrawZoomRectPackage drawPackage;
 };
 
 kpToolZoom::kpToolZoom (kpToolEnvironment *environ, QWidget *parent)
@@ -184,11 +183,12 @@ void kpToolZoom::draw (const QPoint &thisPoint, const QPoint &, const QRect &nor
     }
 
 
-    d->drawPackage.normalizedRect = normalizedRect;
+    const auto pack = QSharedPointer <DrawZoomRectPackage>::create ();
+    pack->normalizedRect = normalizedRect;
 
     kpTempImage newTempImage (false/*always display*/,
         normalizedRect.topLeft (),
-        &::DrawZoomRect, &d->drawPackage,
+        &::DrawZoomRect, pack,
         normalizedRect.width (), normalizedRect.height ());
 
     viewManager ()->setFastUpdates ();
@@ -248,6 +248,9 @@ void kpTool::beginDrawInternal ()
 {
     if (!d->beganDraw)
     {
+        d->latencyNumFrames = 0;
+        d->latencyTotalNSecs = d->latencyMaxNSecs = 0;
+
         beginDraw ();
 
         d->beganDraw = true;
@@ -314,6 +317,9 @@ void kpTool::drawInternal ()
 // also called by kpView
 void kpTool::cancelShapeInternal ()
 {
+    // The moves made since the last frame would only be undone anyway.
+    discardQueuedMouseMoves ();
+
     if (hasBegunShape ())
     {
         d->beganDraw = false;
@@ -370,6 +376,16 @@ void kpTool::endDrawInternal (const QPoint &thisPoint, const QRect &normalizedRe
         return;
     }
 
+    flushQueuedMouseMoves ();
+
+    if (d->latencyNumFrames > 0)
+    {
+        qCDebug(kpLogTools) << "kpTool(" << objectName () << ") input-to-pixel latency:"
+                   << "frames=" << d->latencyNumFrames
+                   << "avg=" << double (d->latencyTotalNSecs) / d->latencyNumFrames / 1e6 << "ms"
+                   << "max=" << double (d->latencyMaxNSecs) / 1e6 << "ms";
+    }
+
     d->beganDraw = false;
 
     if (wantEndShape)
@@ -274,6 +274,8 @@ void kpTool::keyPressEvent (QKeyEvent *e)
               << " isAutoRep=" << e->isAutoRepeat ();
 #endif
 
+    flushQueuedMouseMoves ();
+
     e->ignore ();
 
 
@@ -320,6 +322,8 @@ void kpTool::keyReleaseEvent (QKeyEvent *e)
               << " isAutoRep=" << e->isAutoRepeat ();
 #endif
 
+    flushQueuedMouseMoves ();
+
     e->ignore ();
 
     seeIfAndHandleModifierKey (e);
@@ -43,6 +43,9 @@
 #include <QMouseEvent>
 #include <QApplication>
 #include <QClipboard>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
 
 //---------------------------------------------------------------------
 
@@ -67,6 +70,8 @@ void kpTool::mousePressEvent (QMouseEvent *e)
                << " beganDraw=" << d->beganDraw << endl;
 #endif
 
+    flushQueuedMouseMoves ();
+
     if (e->button () == Qt::MiddleButton)
     {
         const QString text = QApplication::clipboard ()->text (QClipboard::Selection);
@@ -189,40 +194,7 @@ void kpTool::mouseMoveEvent (QMouseEvent *e)
 
     if (d->beganDraw)
     {
-        kpView *view = viewUnderStartPoint ();
-        Q_ASSERT (view);
-
-        d->currentPoint = view->transformViewToDoc (e->pos ());
-        d->currentViewPoint = e->pos ();
-
-    #if DEBUG_KP_TOOL && 0
-        qCDebug(kpLogTools) << "\tDraw!";
-    #endif
-
-        bool dragScrolled = false;
-        movedAndAboutToDraw (d->currentPoint, d->lastPoint, view->zoomLevelX (), &dragScrolled);
-
-        if (dragScrolled)
-        {
-            d->currentPoint = calculateCurrentPoint ();
-            d->currentViewPoint = calculateCurrentPoint (false/*view point*/);
-
-            // Scrollview has scrolled contents and has scheduled an update
-            // for the newly exposed region.  If draw() schedules an update
-            // as well (instead of immediately updating), the scrollview's
-            // update will be executed first and it'll only update part of
-            // the screen resulting in ugly tearing of the viewManager's
-            // tempImage.
-            viewManager ()->setFastUpdates ();
-        }
-
-        drawInternal ();
-
-        if (dragScrolled) {
-            viewManager ()->restoreFastUpdates ();
-        }
-
-        d->lastPoint = d->currentPoint;
+        queueMouseMove (e->pos ());
     }
     else
     {
@@ -252,6 +224,8 @@ void kpTool::mouseReleaseEvent (QMouseEvent *e)
                << " beganDraw=" << d->beganDraw;
 #endif
 
+    flushQueuedMouseMoves ();
+
     // Have _not_ already cancelShape()'ed by pressing other mouse button?
     // (e.g. you can cancel a line dragged out with the LMB, by pressing
     //       the RMB)
@@ -335,3 +309,148 @@ void kpTool::wheelEvent (QWheelEvent *e)
 }
 
 //---------------------------------------------------------------------
+
+// Returns the duration of a display frame in milliseconds.
+static int DisplayFrameMSec ()
+{
+    const QScreen *screen = QGuiApplication::primaryScreen ();
+    const qreal refreshRate = screen ? screen->refreshRate () : 0;
+
+    return qMax (1, qRound (1000.0 / (refreshRate > 0 ? refreshRate : 60.0)));
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTool::queueMouseMove (const QPoint &viewPoint)
+{
+    if (d->queuedMouseMoveViewPoints.isEmpty ()) {
+        d->queuedMouseMoveAge.start ();
+    }
+
+    // Tools that redraw the whole shape on each draw() only care about
+    // where the mouse ended up.
+    if (!careAboutIntermediateMouseMoves ()) {
+        d->queuedMouseMoveViewPoints.clear ();
+    }
+
+    d->queuedMouseMoveViewPoints.append (viewPoint);
+
+    if (!d->mouseMoveTimer->isActive ())
+    {
+        // Draw at most once per frame but if the mouse has been still for a
+        // while, draw as soon as we get back to the event loop, which will
+        // have picked up any other pending mouse moves by then.
+        const qint64 sinceLastFlush = d->lastMouseMoveFlush.isValid () ?
+            d->lastMouseMoveFlush.elapsed () : LLONG_MAX;
+        const int frameMSec = ::DisplayFrameMSec ();
+
+        d->mouseMoveTimer->start (sinceLastFlush >= frameMSec ?
+            0 : int (frameMSec - sinceLastFlush));
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTool::flushQueuedMouseMoves ()
+{
+    d->mouseMoveTimer->stop ();
+
+    if (d->queuedMouseMoveViewPoints.isEmpty ()) {
+        return;
+    }
+
+    const QList <QPoint> viewPoints = d->queuedMouseMoveViewPoints;
+    d->queuedMouseMoveViewPoints.clear ();
+
+#if DEBUG_KP_TOOL && 0
+    qCDebug(kpLogTools) << "kpTool::flushQueuedMouseMoves() #points="
+               << viewPoints.size ();
+#endif
+
+    // Rasterise the whole batch before repainting anything.  The views
+    // accumulate the dirty regions and, on restoreQueueUpdates(), repaint
+    // their union immediately, once.
+    kpViewManager *vm = viewManager ();
+    vm->setFastUpdates ();
+    vm->setQueueUpdates ();
+    {
+        for (const auto &viewPoint : viewPoints)
+        {
+            // (e.g. draw() might have ended the shape)
+            if (!d->beganDraw || !viewUnderStartPoint ()) {
+                break;
+            }
+
+            drawMouseMove (viewPoint);
+        }
+    }
+    vm->restoreQueueUpdates ();
+    vm->restoreFastUpdates ();
+
+    // (includes the repaint)
+    const qint64 latencyNSecs = d->queuedMouseMoveAge.nsecsElapsed ();
+    d->latencyNumFrames++;
+    d->latencyTotalNSecs += latencyNSecs;
+    d->latencyMaxNSecs = qMax (d->latencyMaxNSecs, latencyNSecs);
+
+    d->lastMouseMoveFlush.start ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTool::discardQueuedMouseMoves ()
+{
+    d->mouseMoveTimer->stop ();
+    d->queuedMouseMoveViewPoints.clear ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTool::drawMouseMove (const QPoint &viewPoint)
+{
+    kpView *view = viewUnderStartPoint ();
+    Q_ASSERT (view);
+
+    d->currentPoint = view->transformViewToDoc (viewPoint);
+    d->currentViewPoint = viewPoint;
+
+#if DEBUG_KP_TOOL && 0
+    qCDebug(kpLogTools) << "\tDraw!";
+#endif
+
+    bool dragScrolled = false;
+    movedAndAboutToDraw (d->currentPoint, d->lastPoint, view->zoomLevelX (), &dragScrolled);
+
+    if (dragScrolled)
+    {
+        d->currentPoint = calculateCurrentPoint ();
+        d->currentViewPoint = calculateCurrentPoint (false/*view point*/);
+
+        // Scrollview has scrolled contents and has scheduled an update
+        // for the newly exposed region.  If draw() schedules an update
+        // as well (instead of immediately updating), the scrollview's
+        // update will be executed first and it'll only update part of
+        // the screen resulting in ugly tearing of the viewManager's
+        // tempImage.
+        //
+        // Fast updates alone only repaint immediately if a frame is due,
+        // so flush explicitly.
+        viewManager ()->setFastUpdates ();
+    }
+
+    drawInternal ();
+
+    if (dragScrolled)
+    {
+        viewManager ()->flushUpdates ();
+        viewManager ()->restoreFastUpdates ();
+    }
+
+    d->lastPoint = d->currentPoint;
+}
+
+//---------------------------------------------------------------------
@@ -157,6 +157,10 @@ void kpTool::somethingBelowTheCursorChanged (const QPoint &currentPoint_,
     qCDebug(kpLogTools) << "\tbegan draw=" << d->beganDraw;
 #endif
 
+    // (draw any pending mouse moves first, so that <currentPoint_> is
+    //  drawn last)
+    flushQueuedMouseMoves ();
+
     d->currentPoint = currentPoint_;
     d->currentViewPoint = currentViewPoint_;
 
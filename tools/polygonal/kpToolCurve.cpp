@@ -128,6 +128,14 @@ bool kpToolCurve::drawingALine () const
 }
 
 
+// protected virtual [base kpToolPolygonalBase]
+bool kpToolCurve::shapeIsPolyline () const
+{
+    // The curve does not go through its control points.
+    return false;
+}
+
+
 // public virtual [base kpTool]
 void kpToolCurve::endDraw (const QPoint &, const QRect &)
 {
@@ -46,6 +46,8 @@ protected:
 
     bool drawingALine () const override;
 
+    bool shapeIsPolyline () const override;
+
 public:
     void endDraw (const QPoint &, const QRect &) override;
 };
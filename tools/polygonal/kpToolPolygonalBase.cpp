@@ -53,6 +53,20 @@
 #include "views/manager/kpViewManager.h"
 
 
+// What the temporary image needs to draw the shape being created.
+// It is drawn straight onto the view's composited overlay, instead of onto
+// a copy of the document under the shape.
+struct kpToolPolygonalBaseDrawPackage
+{
+    kpToolPolygonalBase::DrawShapeFunc drawShapeFunc{};
+
+    QPoint topLeft;
+    QPolygon points;
+    kpColor foregroundColor;
+    int lineWidth{};
+    kpColor backgroundColor;
+};
+
 struct kpToolPolygonalBasePrivate
 {
     kpToolPolygonalBasePrivate ()
@@ -383,6 +397,23 @@ kpColor kpToolPolygonalBase::drawingBackgroundColor () const
     return kpColor::Invalid;
 }
 
+static void DrawShapePreview (kpImage *destImage, const QPoint &topLeft,
+        void *userData)
+{
+    const auto *pack = static_cast <kpToolPolygonalBaseDrawPackage *> (userData);
+
+    QPolygon pointsTranslated = pack->points;
+    pointsTranslated.translate (topLeft - pack->topLeft);
+
+    (*pack->drawShapeFunc) (destImage,
+        pointsTranslated,
+        pack->foregroundColor, pack->lineWidth,
+        pack->backgroundColor,
+        false/*not final*/);
+}
+
+//---------------------------------------------------------------------
+
 // TODO: code dup with kpToolRectangle
 // protected slot
 void kpToolPolygonalBase::updateShape ()
@@ -403,21 +434,44 @@ void kpToolPolygonalBase::updateShape ()
                << endl;
 #endif
 
-    kpImage image = document ()->getImageAt (boundingRect);
-
-    QPolygon pointsTranslated = d->points;
-    pointsTranslated.translate (-boundingRect.x (), -boundingRect.y ());
-
-    (*d->drawShapeFunc) (&image,
-        pointsTranslated,
-        drawingForegroundColor (), d->toolWidgetLineWidth->lineWidth (),
-        /*virtual*/drawingBackgroundColor (),
-        false/*not final*/);
+    // The shape is only rasterized into the document by the command in
+    // endShape().  Until then, it is drawn straight onto the view's
+    // composited overlay, which saves copying the document under the
+    // whole shape on every mouse move.
+    //
+    // The temporary image keeps its own copy of the package, as the view
+    // manager may hold onto it for longer than we exist.
+    const auto pack = QSharedPointer <kpToolPolygonalBaseDrawPackage>::create ();
+    pack->drawShapeFunc = d->drawShapeFunc;
+    pack->topLeft = boundingRect.topLeft ();
+    pack->points = d->points;
+    pack->foregroundColor = drawingForegroundColor ();
+    pack->lineWidth = d->toolWidgetLineWidth->lineWidth ();
+    pack->backgroundColor = /*virtual*/drawingBackgroundColor ();
 
     kpTempImage newTempImage (false/*always display*/,
-                                kpTempImage::SetImage/*render mode*/,
                                 boundingRect.topLeft (),
-                                image);
+                                &::DrawShapePreview, pack,
+                                boundingRect.width (), boundingRect.height ());
+
+    // For unfilled connected lines, only the areas around the lines have to
+    // be repainted, rather than the whole bounding rectangle.  This includes
+    // the line from the last point back to the first, which closes a polygon.
+    if (!pack->backgroundColor.isValid () && /*virtual*/shapeIsPolyline ())
+    {
+        QRegion region;
+        for (int i = 0; i < d->points.count (); i++)
+        {
+            const QPoint p1 = d->points [i];
+            const QPoint p2 = d->points [(i + 1) % d->points.count ()];
+
+            // The extra pixel is for antialiasing.
+            region += kpTool::neededRect (QRect (p1, p2).normalized (),
+                                          pack->lineWidth).adjusted (-1, -1, 1, 1);
+        }
+
+        newTempImage.setRegion (region);
+    }
 
     viewManager ()->setFastUpdates ();
     {
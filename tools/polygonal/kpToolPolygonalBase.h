@@ -168,6 +168,14 @@ protected:
     // "false".  The Curve tool realizes it is an initial drag if points() only
     // returns 2 points.
     virtual bool drawingALine () const { return true; }
+
+    // Returns true if the shape consists only of lines between consecutive
+    // points() (and, possibly, from the last point back to the first).
+    // updateShape() uses this to only repaint the areas around those lines.
+    //
+    // Reimplement this if the shape is not drawn through its points e.g. the
+    // Curve tool, whose later points are Bezier control points.
+    virtual bool shapeIsPolyline () const { return true; }
 public:
     void draw (const QPoint &, const QPoint &, const QRect &) override;
 private:
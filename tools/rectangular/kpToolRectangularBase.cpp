@@ -33,6 +33,8 @@
 
 #include <QCursor>
 
+#include <cmath>
+
 #include "kpLogCategories.h"
 #include <KLocalizedString>
 
@@ -54,6 +56,19 @@
 
 //---------------------------------------------------------------------
 
+// What the temporary image needs to draw the shape being dragged out.
+// It is drawn straight onto the view's composited overlay, instead of onto
+// a copy of the document under the shape.
+struct kpToolRectangularBaseDrawPackage
+{
+    kpToolRectangularBase::DrawShapeFunc drawShapeFunc{};
+
+    int width{}, height{};
+    kpColor foregroundColor;
+    int lineWidth{};
+    kpColor backgroundColor;
+};
+
 struct kpToolRectangularBasePrivate
 {
     kpToolRectangularBase::DrawShapeFunc drawShapeFunc{};
@@ -276,21 +291,73 @@ kpColor kpToolRectangularBase::drawingBackgroundColor () const
 
 //---------------------------------------------------------------------
 
-// private
-void kpToolRectangularBase::updateShape ()
+static void DrawShapePreview (kpImage *destImage, const QPoint &topLeft,
+        void *userData)
 {
-    kpImage image = document ()->getImageAt (d->toolRectangleRect);
+    const auto *pack = static_cast <kpToolRectangularBaseDrawPackage *> (userData);
 
     // Invoke shape drawing function passed in ctor.
-    (*d->drawShapeFunc) (&image,
-        0, 0, d->toolRectangleRect.width (), d->toolRectangleRect.height (),
-        drawingForegroundColor (), d->toolWidgetLineWidth->lineWidth (),
-        drawingBackgroundColor ());
+    (*pack->drawShapeFunc) (destImage,
+        topLeft.x (), topLeft.y (), pack->width, pack->height,
+        pack->foregroundColor, pack->lineWidth,
+        pack->backgroundColor);
+}
+
+//---------------------------------------------------------------------
+
+// Returns the part of <rect> that the outline of a rectangular tool's
+// shape, with the given <lineWidth>, may cover.
+static QRegion OutlineRegion (const QRect &rect, int lineWidth)
+{
+    // The outlines of all of the shapes (rectangle, rounded rectangle and
+    // ellipse) lie outside of the largest ellipse inside the line, so leave
+    // out the largest rectangle inside that ellipse.  The extra pixel is
+    // for antialiasing.
+    const double a = rect.width () / 2.0 - lineWidth - 1;
+    const double b = rect.height () / 2.0 - lineWidth - 1;
+    if (a <= 0 || b <= 0) {
+        return rect;
+    }
+
+    QRect inside (0, 0,
+                  2 * static_cast<int> (a / M_SQRT2),
+                  2 * static_cast<int> (b / M_SQRT2));
+    inside.moveCenter (rect.center ());
+
+    return QRegion (rect) - inside.adjusted (1, 1, -1, -1);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpToolRectangularBase::updateShape ()
+{
+    // The shape is only rasterized into the document by the command in
+    // endDraw().  Until then, it is drawn straight onto the view's
+    // composited overlay, which saves copying the document under the
+    // whole shape on every mouse move.
+    //
+    // The temporary image keeps its own copy of the package, as the view
+    // manager may hold onto it for longer than we exist.
+    const auto pack = QSharedPointer <kpToolRectangularBaseDrawPackage>::create ();
+    pack->drawShapeFunc = d->drawShapeFunc;
+    pack->width = d->toolRectangleRect.width ();
+    pack->height = d->toolRectangleRect.height ();
+    pack->foregroundColor = drawingForegroundColor ();
+    pack->lineWidth = d->toolWidgetLineWidth->lineWidth ();
+    pack->backgroundColor = drawingBackgroundColor ();
 
     kpTempImage newTempImage (false/*always display*/,
-                                kpTempImage::SetImage/*render mode*/,
                                 d->toolRectangleRect.topLeft (),
-                                image);
+                                &::DrawShapePreview, pack,
+                                pack->width, pack->height);
+
+    // For an unfilled shape, only its outline has to be repainted.
+    if (!pack->backgroundColor.isValid ())
+    {
+        newTempImage.setRegion (
+            ::OutlineRegion (d->toolRectangleRect, pack->lineWidth));
+    }
 
     viewManager ()->setFastUpdates ();
     viewManager ()->setTempImage (newTempImage);
@@ -58,6 +58,10 @@
 const int kpView::MinZoomLevel = 1;
 const int kpView::MaxZoomLevel = 3200;
 
+// public static
+const int kpView::TileSize = 256;
+const int kpView::TileCacheMaxCostKB = 64 * 1024;
+
 //---------------------------------------------------------------------
 
 kpView::kpView (kpDocument *document,
@@ -81,6 +85,8 @@ kpView::kpView (kpDocument *document,
     d->showGrid = false;
     d->isBuddyViewScrollableContainerRectangleShown = false;
 
+    d->tileCache.setMaxCost (TileCacheMaxCostKB);
+
     // Don't waste CPU drawing default background since its overridden by
     // our fully opaque drawing.  In reality, this seems to make no
     // difference in performance.
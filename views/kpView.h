@@ -51,6 +51,7 @@ class kpTool;
 class kpToolToolBar;
 class kpViewManager;
 class kpViewScrollableContainer;
+struct kpViewTile;
 
 
 /**
@@ -104,6 +105,10 @@ public:
     //
     static const int MinZoomLevel, MaxZoomLevel;
 
+    // Width and height of a tile in the zoomed tile cache and the
+    // per-view memory budget of that cache, in kilobytes.
+    static const int TileSize, TileCacheMaxCostKB;
+
 
     /**
      * @returns the document.
@@ -395,6 +400,20 @@ public:
      */
     void updateQueuedArea ();
 
+    /**
+     * Marks the cached, zoomed tiles covering <docRect> as out of date.
+     * Called by @ref kpViewManager whenever the document, selection,
+     * temporary image or text cursor changes inside <docRect>.
+     *
+     * @param docRect Rectangle (in document coordinates) that changed.
+     */
+    void invalidateTileCache (const QRect &docRect);
+
+    /**
+     * Discards all cached, zoomed tiles.
+     */
+    void clearTileCache ();
+
     QVariant inputMethodQuery (Qt::InputMethodQuery query) const override;
 
 public slots:
@@ -573,19 +592,24 @@ protected:
     void paintEventDrawCheckerBoard (QPainter *painter,
         const QRect &viewRect);
 
-    // Draws the selection and its border onto <destPixmap>.
-    // <destPixmap> is the part of the document given by <docRect>.
-    void paintEventDrawSelection (QImage *destPixmap, const QRect &docRect);
-
     // Draws the parts of the selection's resize handles that are inside
     // <clipRect> onto the view
     void paintEventDrawSelectionResizeHandles (const QRect &clipRect);
-    void paintEventDrawTempImage (QImage *destPixmap, const QRect &docRect);
 
     // Draws the parts of the grid lines that are inside <viewRect> on
     // <painter>.
     void paintEventDrawGridLines (QPainter *painter, const QRect &viewRect);
 
+    // Renders the document (with the selection or temporary image and
+    // checkerboard) that is under <viewRect> onto <painter>, which need
+    // not be the view.  May draw outside <viewRect> -- see the .cpp.
+    void paintEventRenderDoc_Unclipped (QPainter *painter, const QRect &viewRect);
+
+    // Returns the zoomed document tile <tileX>,<tileY> at the current zoom
+    // level, re-rendering any parts of it that are out of date.
+    // The returned pointer is only valid until the cache is next modified.
+    const kpViewTile *paintEventTile (int tileX, int tileY, const QRect &zoomedDocRect);
+
     void paintEventDrawDoc_Unclipped (const QRect &viewRect);
     void paintEvent (QPaintEvent *e) override;
 
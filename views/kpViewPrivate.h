@@ -30,10 +30,14 @@
 #define kpViewPrivate_H
 
 
+#include <QCache>
+#include <QHash>
+#include <QImage>
 #include <QPoint>
 #include <QPointer>
 #include <QRect>
 #include <QRegion>
+#include <QSize>
 
 
 class kpDocument;
@@ -42,6 +46,44 @@ class kpView;
 class kpViewScrollableContainer;
 
 
+// A piece of the view, already zoomed and composited (document, selection,
+// temporary image, checkerboard and grid lines), in "zoomed document" coordinates
+// i.e. view coordinates with the origin subtracted.  This keeps tiles
+// valid when only the origin changes (e.g. scrolling the unzoomed
+// thumbnail).
+struct kpViewTileKey
+{
+    int hzoom, vzoom;
+    bool showGrid;
+    int tileX, tileY;
+};
+
+inline bool operator== (const kpViewTileKey &lhs, const kpViewTileKey &rhs)
+{
+    return (lhs.hzoom == rhs.hzoom && lhs.vzoom == rhs.vzoom &&
+            lhs.showGrid == rhs.showGrid &&
+            lhs.tileX == rhs.tileX && lhs.tileY == rhs.tileY);
+}
+
+inline uint qHash (const kpViewTileKey &key, uint seed = 0)
+{
+    return qHash (key.hzoom, seed) ^ qHash (key.vzoom << 8, seed) ^
+           qHash (key.tileX << 16, seed) ^ qHash (key.tileY, seed + 1) ^
+           (key.showGrid ? 0x80000000u : 0);
+}
+
+struct kpViewTile
+{
+    QImage image;
+
+    // Part of <image> (relative to its top-left) that is out of date.
+    QRegion dirtyRegion;
+
+    // Document pixels that contribute to <image>.
+    QRect docRect;
+};
+
+
 struct kpViewPrivate
 {
     // sync: kpView::paintEvent()
@@ -71,6 +113,10 @@ struct kpViewPrivate
     QRect buddyViewScrollableContainerRectangle;
 
     QRegion queuedUpdateArea;
+
+    // sync: kpView::invalidateTileCache()
+    QCache <kpViewTileKey, kpViewTile> tileCache;
+    QSize tileCacheDocSize;
 };
 
 
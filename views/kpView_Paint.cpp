@@ -42,9 +42,10 @@
 
 #include "layers/selections/kpAbstractSelection.h"
 #include "imagelib/kpColor.h"
+#include "imagelib/kpImagePyramid.h"
 #include "document/kpDocument.h"
 #include "layers/tempImage/kpTempImage.h"
-#include "layers/selections/text/kpTextSelection.h"
+#include "pixmapfx/kpPixmapFX.h"
 #include "views/manager/kpViewManager.h"
 #include "kpViewScrollableContainer.h"
 
@@ -97,6 +98,34 @@ QRect kpView::paintEventGetDocRect (const QRect &viewRect) const
 
 //---------------------------------------------------------------------
 
+// Returns 2x2 cells of the checkerboard, for use as a texture brush.
+// Drawing with it is much faster than a fillRect() per cell.
+static const QImage &CheckerBoardTile (bool isPreview)
+{
+    // (indexed by <isPreview>)
+    static QImage tiles [2];
+
+    QImage &tile = tiles [isPreview ? 1 : 0];
+    if (tile.isNull ())
+    {
+        const int cellSize = !isPreview ? 16 : 10;
+        const QColor gray = !isPreview ?
+            QColor (213, 213, 213) :
+            QColor (224, 224, 224);
+
+        tile = QImage (cellSize * 2, cellSize * 2, QImage::Format_RGB32);
+        tile.fill (Qt::white);
+
+        QPainter painter (&tile);
+        painter.fillRect (cellSize, 0, cellSize, cellSize, gray);
+        painter.fillRect (0, cellSize, cellSize, cellSize, gray);
+    }
+
+    return tile;
+}
+
+//---------------------------------------------------------------------
+
 // public static
 void kpView::drawTransparentBackground (QPainter *painter,
                                         const QPoint &patternOrigin,
@@ -111,53 +140,12 @@ void kpView::drawTransparentBackground (QPainter *painter,
                << endl;
 #endif
 
-    const int cellSize = !isPreview ? 16 : 10;
-
-    // TODO: % is unpredictable with negatives.
-
-    int starty = viewRect.y ();
-    if ((starty - patternOrigin.y ()) % cellSize) {
-        starty -= ((starty - patternOrigin.y ()) % cellSize);
-    }
-
-    int startx = viewRect.x ();
-    if ((startx - patternOrigin.x ()) % cellSize) {
-        startx -= ((startx - patternOrigin.x ()) % cellSize);
-    }
-
-#if DEBUG_KP_VIEW_RENDERER && 1
-    qCDebug(kpLogViews) << "\tstartXY=" << QPoint (startx, starty);
-#endif
-
     painter->save ();
 
-    // Clip to <viewRect> as we may draw outside it on all sides.
-    painter->setClipRect (viewRect, Qt::IntersectClip/*honor existing clip*/);
-
-    for (int y = starty; y <= viewRect.bottom (); y += cellSize)
-    {
-        for (int x = startx; x <= viewRect.right (); x += cellSize)
-        {
-            bool parity = ((x - patternOrigin.x ()) / cellSize +
-                (y - patternOrigin.y ()) / cellSize) % 2;
-            QColor col;
-
-            if (parity)
-            {
-                if (!isPreview) {
-                    col = QColor (213, 213, 213);
-                }
-                else {
-                    col = QColor (224, 224, 224);
-                }
-            }
-            else {
-                col = Qt::white;
-            }
-
-            painter->fillRect (x, y, cellSize, cellSize, col);
-        }
-    }
+    // (unlike the modulo arithmetic this replaced, the brush origin also
+    //  works for negative coordinates)
+    painter->setBrushOrigin (patternOrigin);
+    painter->fillRect (viewRect, QBrush (CheckerBoardTile (isPreview)));
 
     painter->restore ();
 }
@@ -200,92 +188,12 @@ void kpView::paintEventDrawCheckerBoard (QPainter *painter, const QRect &viewRec
     }
 
     // TODO: this static business doesn't work yet
-    patternOrigin = QPoint (0, 0);
-
-    drawTransparentBackground (painter, patternOrigin, viewRect);
-}
-
-//---------------------------------------------------------------------
-
-// protected
-void kpView::paintEventDrawSelection (QImage *destPixmap, const QRect &docRect)
-{
-#if DEBUG_KP_VIEW_RENDERER && 1 || 0
-    qCDebug(kpLogViews) << "kpView::paintEventDrawSelection() docRect=" << docRect;
-#endif
-
-    kpDocument *doc = document ();
-    if (!doc)
-    {
-    #if DEBUG_KP_VIEW_RENDERER && 1 || 0
-        qCDebug(kpLogViews) << "\tno doc - abort";
-    #endif
-        return;
-    }
-
-    kpAbstractSelection *sel = doc->selection ();
-    if (!sel)
-    {
-    #if DEBUG_KP_VIEW_RENDERER && 1 || 0
-        qCDebug(kpLogViews) << "\tno sel - abort";
-    #endif
-        return;
-    }
-
-
-    //
-    // Draw selection pixmap (if there is one)
-    //
-#if DEBUG_KP_VIEW_RENDERER && 1 || 0
-    qCDebug(kpLogViews) << "\tdraw sel pixmap @ " << sel->topLeft ();
-#endif
-    sel->paint (destPixmap, docRect);
-
-
     //
-    // Draw selection border
-    //
-
-    kpViewManager *vm = viewManager ();
-#if DEBUG_KP_VIEW_RENDERER && 1 || 0
-    qCDebug(kpLogViews) << "\tsel border visible="
-               << vm->selectionBorderVisible ();
-#endif
-    if (vm->selectionBorderVisible ())
-    {
-        sel->paintBorder (destPixmap, docRect, vm->selectionBorderFinished ());
-    }
+    // Anchor the checkerboard to the document instead, so that the zoomed
+    // tile cache stays valid when the origin changes.
+    patternOrigin = origin ();
 
-
-    //
-    // Draw text cursor
-    //
-
-    // TODO: It would be nice to display the text cursor even if it's not
-    //       within the text box (this can happen if the text box is too
-    //       small for the text it contains).
-    //
-    //       However, too much selection repaint code assumes that it
-    //       only paints inside its kpAbstractSelection::boundingRect().
-    auto *textSel = dynamic_cast <kpTextSelection *> (sel);
-    if (textSel &&
-        vm->textCursorEnabled () &&
-        (vm->textCursorBlinkState () ||
-        // For the current main window:
-        //     As long as _any_ view has focus, blink _all_ views not just the
-        //     one with focus.
-        !vm->hasAViewWithFocus ()))  // sync: call will break when vm is not held by 1 mainWindow
-    {
-        QRect rect = vm->textCursorRect ();
-        rect = rect.intersected (textSel->textAreaRect ());
-        if (!rect.isEmpty ())
-        {
-          kpPixmapFX::fillRect(destPixmap,
-              rect.x () - docRect.x (), rect.y () - docRect.y (),
-              rect.width (), rect.height (),
-              kpColor::LightGray, kpColor::DarkGray);
-        }
-    }
+    drawTransparentBackground (painter, patternOrigin, viewRect);
 }
 
 //---------------------------------------------------------------------
@@ -344,29 +252,9 @@ void kpView::paintEventDrawSelectionResizeHandles (const QRect &clipRect)
 
 //---------------------------------------------------------------------
 
-// protected
-void kpView::paintEventDrawTempImage (QImage *destPixmap, const QRect &docRect)
-{
-    kpViewManager *vm = viewManager ();
-    if (!vm) {
-        return;
-    }
-
-    const kpTempImage *tpi = vm->tempImage ();
-#if DEBUG_KP_VIEW_RENDERER && 1
-    qCDebug(kpLogViews) << "kpView::paintEventDrawTempImage() tempImage="
-               << tpi
-               << " isVisible="
-               << (tpi ? tpi->isVisible (vm) : false)
-               << endl;
-#endif
-
-    if (!tpi || !tpi->isVisible (vm)) {
-        return;
-    }
-
-    tpi->paint (destPixmap, docRect);
-}
+// Grid lines are drawn in this color along the top and left edges of
+// every zoomed document pixel.
+static const QColor GridLineColor (Qt::gray);
 
 //---------------------------------------------------------------------
 
@@ -376,12 +264,19 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
   int hzoomMultiple = zoomLevelX () / 100;
   int vzoomMultiple = zoomLevelY () / 100;
 
-  painter->setPen(Qt::gray);
+  painter->setPen(GridLineColor);
+
+  // (lines are relative to the origin, not the view, so that they match
+  //  the ones drawn by kpPixmapFX::drawZoomedImage())
 
   // horizontal lines
   int starty = viewRect.top();
-  if (starty % vzoomMultiple) {
-    starty = (starty + vzoomMultiple) / vzoomMultiple * vzoomMultiple;
+  int offset = (starty - origin ().y ()) % vzoomMultiple;
+  if (offset < 0) {
+    offset += vzoomMultiple;
+  }
+  if (offset) {
+    starty += vzoomMultiple - offset;
   }
 
   for (int y = starty; y <= viewRect.bottom(); y += vzoomMultiple) {
@@ -390,8 +285,12 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
 
   // vertical lines
   int startx = viewRect.left();
-  if (startx % hzoomMultiple) {
-    startx = (startx + hzoomMultiple) / hzoomMultiple * hzoomMultiple;
+  offset = (startx - origin ().x ()) % hzoomMultiple;
+  if (offset < 0) {
+    offset += hzoomMultiple;
+  }
+  if (offset) {
+    startx += hzoomMultiple - offset;
   }
 
   for (int x = startx; x <= viewRect.right(); x += hzoomMultiple) {
@@ -427,10 +326,11 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
 //    are not perfectly divisible by 100.
 //
 // This over-drawing is dangerous -- see the comments in paintEvent().
-// This over-drawing is only safe from Qt's perspective since Qt
-// automatically clips all drawing in paintEvent() (which calls us) to
-// QPaintEvent::region().
-void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
+// It is safe because the only caller, paintEventTile(), clips <painter>
+// to the part of the tile being re-rendered.
+//
+// protected
+void kpView::paintEventRenderDoc_Unclipped (QPainter *painter, const QRect &viewRect)
 {
 #if DEBUG_KP_VIEW_RENDERER
     QTime timer;
@@ -454,28 +354,107 @@ void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
     qCDebug(kpLogViews) << "\tdocRect=" << docRect;
 #endif
 
-    QPainter painter (this);
-    //painter.setCompositionMode(QPainter::CompositionMode_Source);
-
-    QImage docPixmap;
     bool tempImageWillBeRendered = false;
+    bool selectionWillBeRendered = false;
+    bool drewGridLines = false;
+
+    // When zoomed out, draw a box-filtered, downscaled copy of the document
+    // instead of making QPainter sample the full-size image.
+    int mipmapLevel = 0;
+    QRect mipmapRect;
+
+    // What to draw:
+    //
+    // <srcRect> of <srcImage> is drawn over <docRect>.  <srcImage>'s
+    // top-left pixel corresponds to the document pixel <srcDocTopLeft>.
+    //
+    // Unless the selection or temporary image must be composited on top,
+    // <srcImage> is the document's own storage (or mipmap), which is
+    // drawn from in place, without copying the visible area.
+    QImage compositedImage, mipmapImage;
+    const QImage *srcImage = nullptr;
+    QRect srcRect;
+    QPoint srcDocTopLeft;
 
     // LOTODO: I think <docRect> being empty would be a bug.
     if (!docRect.isEmpty ())
     {
-        docPixmap = doc->getImageAt (docRect);
-
-    #if DEBUG_KP_VIEW_RENDERER && 1
-        qCDebug(kpLogViews) << "\tdocPixmap.hasAlphaChannel()="
-                  << docPixmap.hasAlphaChannel ();
-    #endif
-
         tempImageWillBeRendered =
             (!doc->selection () &&
              vm->tempImage () &&
              vm->tempImage ()->isVisible (vm) &&
              docRect.intersects (vm->tempImage ()->rect ()));
 
+        // (the selection, its border and the text cursor are all inside
+        //  the selection's bounding rectangle)
+        selectionWillBeRendered =
+            (doc->selection () &&
+             docRect.intersects (doc->selection ()->boundingRect ()));
+
+        if (tempImageWillBeRendered || selectionWillBeRendered)
+        {
+            // The selection or temporary image composited on top of the
+            // document is shared by all views (so is only composited once)
+            // and only exists at full size.
+            const QRect overlayRect = vm->overlayRect ();
+            compositedImage = vm->compositedOverlay ();
+
+            if (overlayRect.contains (docRect))
+            {
+                srcRect = docRect.translated (-overlayRect.topLeft ());
+                srcDocTopLeft = overlayRect.topLeft ();
+            }
+            else
+            {
+                // Straddles the edge of the overlay: patch the overlay
+                // onto a private copy of the document.
+                const QRect overlapRect = docRect & overlayRect;
+
+                QImage image = doc->getImageAt (docRect);
+                QPainter imagePainter (&image);
+                imagePainter.setCompositionMode (QPainter::CompositionMode_Source);
+                imagePainter.drawImage (overlapRect.topLeft () - docRect.topLeft (),
+                    compositedImage,
+                    overlapRect.translated (-overlayRect.topLeft ()));
+                imagePainter.end ();
+
+                compositedImage = image;
+                srcRect = compositedImage.rect ();
+                srcDocTopLeft = docRect.topLeft ();
+            }
+
+            srcImage = &compositedImage;
+        }
+        else
+        {
+            mipmapLevel = kpImagePyramid::levelForScale (
+                double (qMax (zoomLevelX (), zoomLevelY ())) / 100.0);
+
+            if (mipmapLevel > 0)
+            {
+                mipmapRect = kpImagePyramid::levelRect (docRect, mipmapLevel);
+                mipmapImage = doc->mipmap (mipmapLevel);
+
+                srcImage = &mipmapImage;
+                srcRect = mipmapRect;
+            }
+            else
+            {
+                srcImage = doc->imagePointer ();
+                srcRect = docRect;
+            }
+
+            srcDocTopLeft = QPoint (0, 0);
+        }
+
+    #if DEBUG_KP_VIEW_RENDERER && 1
+        qCDebug(kpLogViews) << "\tsrcImage.hasAlphaChannel()="
+                  << srcImage->hasAlphaChannel ()
+                  << " srcRect=" << srcRect
+                  << " composited=" << (srcImage == &compositedImage)
+                  << " mipmapLevel=" << mipmapLevel;
+    #endif
+
     #if DEBUG_KP_VIEW_RENDERER && 1
         qCDebug(kpLogViews) << "\ttempImageWillBeRendered=" << tempImageWillBeRendered
                    << " (sel=" << doc->selection ()
@@ -488,49 +467,126 @@ void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
     }
 
 
+    // The document is stored with an alpha channel even if it's opaque, so
+    // ask the document, which tracks whether it really is.
+    bool isOpaque = false;
+    if (!docRect.isEmpty () &&
+        !(tempImageWillBeRendered && vm->tempImage ()->paintMayAddMask ()))
+    {
+        QRect opaqueRect = docRect;
+        if (mipmapLevel > 0)
+        {
+            // The document pixels that were averaged into <mipmapRect>.
+            opaqueRect = QRect (
+                QPoint (mipmapRect.left () << mipmapLevel,
+                        mipmapRect.top () << mipmapLevel),
+                QPoint (((mipmapRect.right () + 1) << mipmapLevel) - 1,
+                        ((mipmapRect.bottom () + 1) << mipmapLevel) - 1));
+        }
+
+        isOpaque = doc->isOpaqueAt (opaqueRect);
+    }
+
+#if DEBUG_KP_VIEW_RENDERER && 1
+    qCDebug(kpLogViews) << "\tisOpaque=" << isOpaque;
+#endif
+
+
     //
     // Draw checkboard for transparent images and/or views with borders
     //
 
-    if (docPixmap.hasAlphaChannel() ||
-        (tempImageWillBeRendered && vm->tempImage ()->paintMayAddMask ()))
+    if (!isOpaque &&
+        (!srcImage || srcImage->hasAlphaChannel() ||
+         (tempImageWillBeRendered && vm->tempImage ()->paintMayAddMask ())))
     {
-        paintEventDrawCheckerBoard (&painter, viewRect);
+        paintEventDrawCheckerBoard (painter, viewRect);
     }
-
-    if (!docRect.isEmpty ())
+    else if (isOpaque && (zoomLevelX () % 100 || zoomLevelY () % 100))
     {
-        //
-        // Draw docPixmap + tempImage
-        //
-
-        if (doc->selection ())
-        {
-            paintEventDrawSelection (&docPixmap, docRect);
-        }
-        else if (tempImageWillBeRendered)
-        {
-            paintEventDrawTempImage (&docPixmap, docRect);
-        }
+        // At these zoom levels, the scaled document may not quite reach the
+        // last row or column of <viewRect>.  Don't leave it uninitialized.
+        painter->fillRect (viewRect, Qt::white);
+    }
 
+    if (srcImage)
+    {
     #if DEBUG_KP_VIEW_RENDERER && 1
         qCDebug(kpLogViews) << "\torigin=" << origin ();
     #endif
-        // Blit scaled version of docPixmap + tempImage.
+        // Blit scaled version of the document + selection or tempImage.
     #if DEBUG_KP_VIEW_RENDERER && 1
         QTime scaleTimer; scaleTimer.start ();
     #endif
-        // This is the only troublesome part of the method that draws unclipped.
-        painter.translate (origin ().x (), origin ().y ());
-        painter.scale (double (zoomLevelX ()) / 100.0,
-                       double (zoomLevelY ()) / 100.0);
-        painter.drawImage (docRect, docPixmap);
-        //painter.resetMatrix ();  // back to 1-1 scaling
+        const QTransform deviceTransform = painter->deviceTransform ();
+        QImage *destImage =
+            (painter->device () && painter->device ()->devType () == QInternal::Image) ?
+                static_cast <QImage *> (painter->device ()) :
+                nullptr;
+
+        if (mipmapLevel == 0 &&
+            zoomLevelX () % 100 == 0 && zoomLevelY () % 100 == 0 &&
+            destImage &&
+            destImage->format () == QImage::Format_ARGB32_Premultiplied &&
+            srcImage->format () == QImage::Format_ARGB32_Premultiplied &&
+            deviceTransform.type () <= QTransform::TxTranslate &&
+            deviceTransform.dx () == qRound (deviceTransform.dx ()) &&
+            deviceTransform.dy () == qRound (deviceTransform.dy ()))
+        {
+            // Integer zoom (where most pixel editing happens): enlarge
+            // straight into the destination by pixel replication, with any
+            // grid lines, instead of going through QPainter's general
+            // transformation path.
+            //
+            // Only <viewRect> is written to, which is all the caller
+            // (paintEventTile()) clipped to anyway.  That also means we
+            // don't need to extract <srcRect> from <srcImage>.
+            const QPoint deviceOffset (qRound (deviceTransform.dx ()),
+                                       qRound (deviceTransform.dy ()));
+            kpPixmapFX::drawZoomedImage (destImage,
+                viewRect.translated (deviceOffset),
+                *srcImage,
+                transformDocToView (srcDocTopLeft) + deviceOffset,
+                zoomLevelX () / 100, zoomLevelY () / 100,
+                !isOpaque/*blend*/,
+                isGridShown () ? kpColor (GridLineColor.rgb ()) : kpColor::Invalid);
+
+            drewGridLines = isGridShown ();
+        }
+        else
+        {
+            // This is the only troublesome part of the method that draws unclipped.
+            painter->save ();
+            if (isOpaque)
+            {
+                // Nothing underneath shows through so don't blend.
+                painter->setCompositionMode (QPainter::CompositionMode_Source);
+            }
+            painter->translate (origin ().x (), origin ().y ());
+            if (mipmapLevel > 0)
+            {
+                // Each mipmap pixel covers 2^mipmapLevel document pixels.
+                painter->scale (double (zoomLevelX () << mipmapLevel) / 100.0,
+                                double (zoomLevelY () << mipmapLevel) / 100.0);
+                painter->drawImage (mipmapRect, *srcImage, srcRect);
+            }
+            else
+            {
+                painter->scale (double (zoomLevelX ()) / 100.0,
+                                double (zoomLevelY ()) / 100.0);
+                painter->drawImage (docRect, *srcImage, srcRect);
+            }
+            painter->restore ();  // back to 1-1 scaling
+        }
     #if DEBUG_KP_VIEW_RENDERER && 1
         qCDebug(kpLogViews) << "\tscale time=" << scaleTimer.elapsed ();
     #endif
 
-    }  // if (!docRect.isEmpty ()) {
+    }  // if (srcImage) {
+
+    if (isGridShown () && !drewGridLines) {
+        paintEventDrawGridLines (painter, viewRect);
+    }
 
 #if DEBUG_KP_VIEW_RENDERER && 1
     qCDebug(kpLogViews) << "\tdrawDocRect done in: " << timer.restart () << "ms";
@@ -539,6 +595,85 @@ void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
 
 //---------------------------------------------------------------------
 
+// protected
+void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
+{
+#if DEBUG_KP_VIEW_RENDERER
+    QTime timer;
+    timer.start ();
+    qCDebug(kpLogViews) << "\tviewRect=" << viewRect;
+#endif
+
+    const kpDocument *doc = document ();
+    Q_ASSERT (doc);
+
+    if (viewRect.isEmpty ()) {
+        return;
+    }
+
+    if (doc->size () != d->tileCacheDocSize)
+    {
+        clearTileCache ();
+        d->tileCacheDocSize = doc->size ();
+    }
+
+    QPainter painter (this);
+
+    // Tiles, and the checkerboard outside of the document, are always
+    // opaque so can be copied rather than blended.
+    painter.setCompositionMode (QPainter::CompositionMode_Source);
+
+    // Tiles are in "zoomed document" coordinates, which are independent
+    // of the origin.
+    const QRect zoomedDocRect =
+        transformDocToView (doc->rect ()).translated (-origin ());
+    const QRect zoomedViewRect = viewRect.translated (-origin ());
+    const QRect zoomedRect = zoomedViewRect & zoomedDocRect;
+
+    // Anything outside of the document is only ever checkerboard.
+    const QRegion outsideDocRegion = QRegion (viewRect) -
+        QRegion (zoomedRect.translated (origin ()));
+    for (const QRect &r : outsideDocRegion) {
+        paintEventDrawCheckerBoard (&painter, r);
+    }
+
+    if (zoomedRect.isEmpty ()) {
+        return;
+    }
+
+    // (zoomedRect is never negative so integer division rounds down)
+    const int firstTileX = zoomedRect.left () / TileSize;
+    const int lastTileX = zoomedRect.right () / TileSize;
+    const int firstTileY = zoomedRect.top () / TileSize;
+    const int lastTileY = zoomedRect.bottom () / TileSize;
+
+    for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+    {
+        for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+        {
+            const kpViewTile *tile = paintEventTile (tileX, tileY, zoomedDocRect);
+            if (!tile) {
+                continue;
+            }
+
+            const QPoint tileTopLeft (tileX * TileSize, tileY * TileSize);
+            const QRect tileRect (tileTopLeft, tile->image.size ());
+            const QRect srcRect = tileRect & zoomedRect;
+
+            // Blit 1-1: no scaling and no drawing outside of <viewRect>.
+            painter.drawImage (srcRect.topLeft () + origin (),
+                               tile->image,
+                               srcRect.translated (-tileTopLeft));
+        }
+    }
+
+#if DEBUG_KP_VIEW_RENDERER && 1
+    qCDebug(kpLogViews) << "\tdrawDocRect (tiled) done in: " << timer.restart () << "ms";
+#endif
+}
+
+//---------------------------------------------------------------------
+
 // protected virtual [base QWidget]
 void kpView::paintEvent (QPaintEvent *e)
 {
@@ -604,10 +739,14 @@ void kpView::paintEvent (QPaintEvent *e)
     // Draw Grid Lines
     //
 
+    // (the document's tiles already include them)
     if ( isGridShown() )
     {
+      const QRegion outsideDocRegion =
+          viewRegion - QRegion (transformDocToView (doc->rect ()));
+
       QPainter painter(this);
-      for (const QRect &r : viewRegion)
+      for (const QRect &r : outsideDocRegion)
         paintEventDrawGridLines(&painter, r);
     }
 
@@ -0,0 +1,182 @@
+
+/*
+   Copyright (c) 2026 The KolourPaint Authors
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_VIEW 0
+#define DEBUG_KP_VIEW_RENDERER ((DEBUG_KP_VIEW && 1) || 0)
+
+
+#include "views/kpView.h"
+#include "kpViewPrivate.h"
+
+#include <QPainter>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+
+//---------------------------------------------------------------------
+
+// public
+void kpView::invalidateTileCache (const QRect &docRect)
+{
+#if DEBUG_KP_VIEW_RENDERER && 1
+    qCDebug(kpLogViews) << "kpView(" << objectName ()
+               << ")::invalidateTileCache(" << docRect << ")";
+#endif
+
+    if (docRect.isEmpty () || d->tileCache.isEmpty ()) {
+        return;
+    }
+
+    // sync: kpViewManager::viewRegionForDocRegion()
+    QRect zoomedRect = transformDocToView (docRect).translated (-origin ());
+    if (zoomLevelX () % 100 || zoomLevelY () % 100)
+    {
+        // Compensate for rounding at non-integer zoom levels.
+        const int diff = qRound (double (qMax (zoomLevelX (), zoomLevelY ())) / 100.0) + 1;
+        zoomedRect.adjust (-diff, -diff, +diff, +diff);
+    }
+
+    const QList <kpViewTileKey> keys = d->tileCache.keys ();
+    for (const kpViewTileKey &key : keys)
+    {
+        kpViewTile *tile = d->tileCache.object (key);
+        Q_ASSERT (tile);
+
+        if (!tile->docRect.intersects (docRect)) {
+            continue;
+        }
+
+        if (key.hzoom != zoomLevelX () || key.vzoom != zoomLevelY () ||
+            key.showGrid != isGridShown ())
+        {
+            // Not worth mapping to a zoom level that isn't being shown.
+            d->tileCache.remove (key);
+            continue;
+        }
+
+        const QPoint tileTopLeft (key.tileX * TileSize, key.tileY * TileSize);
+        const QRect dirtyRect =
+            zoomedRect.translated (-tileTopLeft) & tile->image.rect ();
+        if (!dirtyRect.isEmpty ()) {
+            tile->dirtyRegion += dirtyRect;
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpView::clearTileCache ()
+{
+#if DEBUG_KP_VIEW_RENDERER && 1
+    qCDebug(kpLogViews) << "kpView(" << objectName () << ")::clearTileCache()"
+               << " numTiles=" << d->tileCache.count ();
+#endif
+
+    d->tileCache.clear ();
+}
+
+//---------------------------------------------------------------------
+
+// protected
+const kpViewTile *kpView::paintEventTile (int tileX, int tileY,
+        const QRect &zoomedDocRect)
+{
+    const kpViewTileKey key = {zoomLevelX (), zoomLevelY (), isGridShown (),
+                               tileX, tileY};
+
+    const QPoint tileTopLeft (tileX * TileSize, tileY * TileSize);
+
+    kpViewTile *tile = d->tileCache.object (key);
+    if (!tile)
+    {
+        const QRect tileRect =
+            QRect (tileTopLeft, QSize (TileSize, TileSize)) & zoomedDocRect;
+        if (tileRect.isEmpty ()) {
+            return nullptr;
+        }
+
+        tile = new kpViewTile ();
+        tile->image = QImage (tileRect.size (), QImage::Format_ARGB32_Premultiplied);
+        tile->dirtyRegion = tile->image.rect ();
+
+        // Grow by a pixel to cover rounding at non-integer zoom levels.
+        tile->docRect = paintEventGetDocRect (tileRect.translated (origin ()))
+            .adjusted (-1, -1, +1, +1);
+
+        const int costKB = qMax (1, int (tile->image.sizeInBytes () / 1024));
+        if (!d->tileCache.insert (key, tile, costKB)) {
+            // (QCache deleted <tile>)
+            return nullptr;
+        }
+    }
+
+    if (tile->dirtyRegion.isEmpty ()) {
+        return tile;
+    }
+
+#if DEBUG_KP_VIEW_RENDERER && 1
+    qCDebug(kpLogViews) << "kpView::paintEventTile(" << tileX << "," << tileY
+               << ") re-render " << tile->dirtyRegion;
+#endif
+
+    // Many small dirty rectangles (e.g. from the text cursor and
+    // selection border) are cheaper to render as one.
+    QRegion dirtyRegion = tile->dirtyRegion;
+    if (dirtyRegion.rectCount () > 8) {
+        dirtyRegion = dirtyRegion.boundingRect ();
+    }
+    tile->dirtyRegion = QRegion ();
+
+    // Render in view coordinates, as if the tile were the view.
+    const QPoint viewOffset = tileTopLeft + origin ();
+
+    QPainter painter (&tile->image);
+    painter.translate (-viewOffset);
+
+    for (const QRect &r : dirtyRegion)
+    {
+        const QRect viewRect = r.translated (viewOffset);
+
+        painter.save ();
+        painter.setClipRect (viewRect);
+
+        painter.setCompositionMode (QPainter::CompositionMode_Source);
+        painter.fillRect (viewRect, Qt::transparent);
+        painter.setCompositionMode (QPainter::CompositionMode_SourceOver);
+
+        paintEventRenderDoc_Unclipped (&painter, viewRect);
+
+        painter.restore ();
+    }
+
+    return tile;
+}
+
+//---------------------------------------------------------------------
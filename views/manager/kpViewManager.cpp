@@ -37,6 +37,8 @@
 #include <QTimer>
 
 #include "kpLogCategories.h"
+#include <KConfigGroup>
+#include <KSharedConfig>
 
 #include "kpDefs.h"
 #include "document/kpDocument.h"
@@ -76,6 +78,17 @@ kpViewManager::kpViewManager (kpMainWindow *mainWindow)
 
     d->queueUpdatesCounter = d->fastUpdatesCounter = 0;
 
+    d->updateTimer = new QTimer (this);
+    d->updateTimer->setSingleShot (true);
+    d->updateTimer->setTimerType (Qt::PreciseTimer);
+    connect (d->updateTimer, &QTimer::timeout, this, &kpViewManager::flushUpdates);
+
+    KConfigGroup cfg (KSharedConfig::openConfig (), kpSettingsGroupGeneral);
+    d->updateFrameRate = 0;
+    setUpdateFrameRate (cfg.readEntry (kpSettingViewUpdateFrameRate, 60));
+
+    d->lastUpdateFlushCostMSec = 0;
+
     d->inputMethodEnabled = false;
 }
 
@@ -129,6 +142,7 @@ void kpViewManager::unregisterView (kpView *view)
 
     view->unsetCursor ();
     d->views.removeAll (view);
+    d->pendingViewRegions.remove (view);
 }
 
 //---------------------------------------------------------------------
@@ -137,6 +151,7 @@ void kpViewManager::unregisterView (kpView *view)
 void kpViewManager::unregisterAllViews ()
 {
     d->views.clear ();
+    d->pendingViewRegions.clear ();
 }
 
 //---------------------------------------------------------------------
@@ -256,23 +271,27 @@ void kpViewManager::setTempImage (const kpTempImage &tempImage)
                << ")";
 #endif
 
-    QRect oldRect;
+    QRegion oldRegion;
 
     if (d->tempImage)
     {
-        oldRect = d->tempImage->rect ();
+        oldRegion = d->tempImage->region ();
         delete d->tempImage;
         d->tempImage = nullptr;
     }
 
     d->tempImage = new kpTempImage (tempImage);
 
+    // Only update what the old and new images can have changed, which can
+    // be much less than their rects e.g. for the outline of a big shape.
     setQueueUpdates ();
     {
-        if (oldRect.isValid ()) {
-            updateViews (oldRect);
+        for (const QRect &r : oldRegion) {
+            updateViews (r);
+        }
+        for (const QRect &r : d->tempImage->region ()) {
+            updateViews (r);
         }
-        updateViews (d->tempImage->rect ());
     }
     restoreQueueUpdates ();
 }
@@ -286,12 +305,18 @@ void kpViewManager::invalidateTempImage ()
         return;
     }
 
-    QRect oldRect = d->tempImage->rect ();
+    const QRegion oldRegion = d->tempImage->region ();
 
     delete d->tempImage;
     d->tempImage = nullptr;
 
-    updateViews (oldRect);
+    setQueueUpdates ();
+    {
+        for (const QRect &r : oldRegion) {
+            updateViews (r);
+        }
+    }
+    restoreQueueUpdates ();
 }
 
 //---------------------------------------------------------------------
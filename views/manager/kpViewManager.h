@@ -34,6 +34,7 @@
 
 
 class QCursor;
+class QImage;
 class QRegion;
 class QRect;
 
@@ -188,6 +189,35 @@ protected slots:
     void slotTextCursorBlink ();
 
 
+//
+// Composited Overlay
+//
+
+public:
+    // Returns the part of the document that has something drawn on top of
+    // it (the selection, or else the temporary image), clipped to the
+    // document.  Returns an empty rectangle if there is nothing on top.
+    QRect overlayRect () const;
+
+    // Returns the overlayRect() part of the document with the selection
+    // (including its border and the text cursor) or the temporary image
+    // composited on top.
+    //
+    // This is shared by all views, which sample it at their own zoom
+    // levels.  It is only recomposited where updateViews() reported
+    // changes, however many views ask for it.
+    //
+    // The returned image refers to the overlay's own memory, which the next
+    // call may change or free, so don't hold onto it.
+    QImage compositedOverlay ();
+
+private:
+    // Draw onto <destImage>, which is the part of the document given by
+    // <docRect>.
+    void compositeSelection (QImage *destImage, const QRect &docRect) const;
+    void compositeTempImage (QImage *destImage, const QRect &docRect) const;
+
+
 //
 // View Updates
 //
@@ -211,24 +241,53 @@ public:
 public:
     // Controls behaviour of updateViews():
     //
-    // Slow: Let Qt buffer paint events via QWidget::update().
-    //       Results in less flicker.  Paint events are probably merged
-    //       so long-term efficiency is increased at the expense of
-    //       reduced responsiveness (default).  Generally, the paint
-    //       event happens a while later -- when you return to the event
-    //       loop.
-    // Fast: Force Qt to redraw immediately.  No paint events
-    //       are merged so there is great potential for flicker,
-    //       if used inappropriately.  Use this when the redraw
-    //       area is small and responsiveness is critical.
-    //       Continual use of this mode can result in
-    //       unnecessary redraws and incredibly slugish performance.
+    // Slow: Updates are accumulated and flushed to all views at once, on
+    //       the next display frame (see updateFrameRate()).  Results in
+    //       less flicker.  The paint event happens a while later --
+    //       when you return to the event loop (default).
+    // Fast: If a frame is due, repaint all pending updates immediately
+    //       (otherwise, same as Slow).  Use this when the redraw area is
+    //       small and responsiveness is critical.
+    //
+    // Neither is synchronous: within a frame of the last repaint, even Fast
+    // updates wait for the next frame, so that fast mouse moves cannot make
+    // us repaint more often than the screen does.  Call flushUpdates() if
+    // the views really must be repainted before you return to the event
+    // loop.  Exception: ending a block of setQueueUpdates() while Fast
+    // repaints everything that was queued, immediately.
     //
     // You can nest blocks of setFastUpdates()/restoreFastUpdates().
     bool fastUpdates () const;
     void setFastUpdates ();
     void restoreFastUpdates ();
 
+public:
+    // Maximum number of times per second that pending updates are flushed
+    // to the views (default: 60, or the "View Update Frame Rate" setting).
+    //
+    // If repainting turns out to be expensive, updates are flushed less
+    // often, so that no more than half of the time is spent repainting.
+    int updateFrameRate () const;
+    void setUpdateFrameRate (int framesPerSecond);
+
+private:
+    // Returns the number of milliseconds to leave between flushUpdates().
+    int updateIntervalMSec () const;
+
+    // Ensures that flushUpdates() will be called, immediately if
+    // fastUpdates() and a frame is due.
+    void scheduleUpdates ();
+
+    // Returns the view region of <view> that needs repainting due to
+    // <docRegion> changing.
+    QRegion viewRegionForDocRegion (const kpView *view, const QRegion &docRegion) const;
+
+public slots:
+    // Repaints all pending updates of all views, now.  All views are
+    // repainted together so that e.g. the thumbnail never shows a
+    // different state from the main view.
+    void flushUpdates ();
+
 public slots:
     void updateView (kpView *v);
     void updateView (kpView *v, const QRect &viewRect);
@@ -31,7 +31,12 @@
 
 
 #include <QCursor>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
 #include <QList>
+#include <QRect>
+#include <QRegion>
 
 
 class kpMainWindow;
@@ -68,12 +73,44 @@ struct kpViewManagerPrivate
     bool textCursorBlinkState;
 
 
+    //
+    // Composited Overlay
+    //
+
+    // The document with the selection or temporary image composited on
+    // top, covering <overlayImageRect> (in document coordinates).
+    //
+    // This lives inside <overlayBuffer>, which covers <overlayBufferRect>
+    // (in document coordinates) and only grows while there is something
+    // on top.  That way, a shape being dragged out neither reallocates nor
+    // moves pixels around on every mouse move.
+    QImage overlayBuffer;
+    QRect overlayBufferRect;
+    QRect overlayImageRect;
+    // Parts of <overlayImageRect> (in document coordinates) that are stale.
+    QRegion overlayDirtyRegion;
+
+
     //
     // View Updates
     //
 
     int queueUpdatesCounter, fastUpdatesCounter;
 
+    // Frame-paced update scheduler (see kpViewManager::flushUpdates()).
+    QTimer *updateTimer;
+    int updateFrameRate;
+
+    // Pending updates in document coordinates, for all views.
+    QRegion pendingDocRegion;
+    // Pending updates in view coordinates, per view.
+    QHash <kpView *, QRegion> pendingViewRegions;
+
+    // Started after each flushUpdates().
+    QElapsedTimer lastUpdateFlush;
+    // How long the last flushUpdates() took to repaint.
+    qint64 lastUpdateFlushCostMSec;
+
     //
     // Input Method
     //
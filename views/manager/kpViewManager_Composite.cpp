@@ -0,0 +1,275 @@
+
+/*
+   Copyright (c) 2003-2007 Clarence Dang <dang@kde.org>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_VIEW_MANAGER 0
+
+
+#include "views/manager/kpViewManager.h"
+#include "kpViewManagerPrivate.h"
+
+#include <QPainter>
+
+#include "kpLogCategories.h"
+
+#include "document/kpDocument.h"
+#include "imagelib/kpColor.h"
+#include "layers/selections/kpAbstractSelection.h"
+#include "layers/selections/text/kpTextSelection.h"
+#include "layers/tempImage/kpTempImage.h"
+#include "pixmapfx/kpPixmapFX.h"
+
+//---------------------------------------------------------------------
+
+// public
+QRect kpViewManager::overlayRect () const
+{
+    kpDocument *doc = document ();
+    if (!doc) {
+        return {};
+    }
+
+    // sync: kpView::paintEventRenderDoc_Unclipped()
+    if (doc->selection ()) {
+        return doc->selection ()->boundingRect () & doc->rect ();
+    }
+
+    if (d->tempImage && d->tempImage->isVisible (this)) {
+        return d->tempImage->rect () & doc->rect ();
+    }
+
+    return {};
+}
+
+//---------------------------------------------------------------------
+
+// public
+QImage kpViewManager::compositedOverlay ()
+{
+    kpDocument *doc = document ();
+    Q_ASSERT (doc);
+
+    const QRect rect = overlayRect ();
+
+    if (rect.isEmpty ())
+    {
+        // Nothing is on top any more, so free the buffer.
+        d->overlayBuffer = QImage ();
+        d->overlayBufferRect = QRect ();
+        d->overlayImageRect = QRect ();
+        d->overlayDirtyRegion = QRegion ();
+        return {};
+    }
+
+    if (rect != d->overlayImageRect)
+    {
+        // The selection or temporary image moved or changed size.
+    #if DEBUG_KP_VIEW_MANAGER && 1
+        qCDebug(kpLogViews) << "kpViewManager::compositedOverlay() new rect="
+                   << rect << " was=" << d->overlayImageRect
+                   << " buffer=" << d->overlayBufferRect;
+    #endif
+
+        // Keep what is still composited correctly.  Every change inside
+        // the old rect has gone through updateViews() so is in the dirty
+        // region already.  The rest of the buffer is not tracked, so is
+        // dirty as soon as it is uncovered.
+        const QRect keepRect = rect & d->overlayImageRect;
+
+        if (!d->overlayBufferRect.contains (rect))
+        {
+            // Grow with some slack, so that a shape being dragged out
+            // does not reallocate on every mouse move.
+            QRect bufferRect = d->overlayBufferRect | rect;
+            bufferRect.adjust (-bufferRect.width () / 4, -bufferRect.height () / 4,
+                               bufferRect.width () / 4, bufferRect.height () / 4);
+            bufferRect &= doc->rect ();
+
+        #if DEBUG_KP_VIEW_MANAGER && 1
+            qCDebug(kpLogViews) << "\tgrow buffer to " << bufferRect;
+        #endif
+
+            QImage buffer (bufferRect.size (), QImage::Format_ARGB32_Premultiplied);
+            if (!keepRect.isEmpty ())
+            {
+                QPainter painter (&buffer);
+                painter.setCompositionMode (QPainter::CompositionMode_Source);
+                painter.drawImage (keepRect.topLeft () - bufferRect.topLeft (),
+                                   d->overlayBuffer,
+                                   keepRect.translated (-d->overlayBufferRect.topLeft ()));
+                painter.end ();
+            }
+
+            d->overlayBuffer = buffer;
+            d->overlayBufferRect = bufferRect;
+        }
+
+        d->overlayDirtyRegion = (d->overlayDirtyRegion & keepRect) +
+                                (QRegion (rect) - keepRect);
+        d->overlayImageRect = rect;
+    }
+
+    if (!d->overlayDirtyRegion.isEmpty ())
+    {
+    #if DEBUG_KP_VIEW_MANAGER && 1
+        qCDebug(kpLogViews) << "kpViewManager::compositedOverlay() recomposite "
+                   << d->overlayDirtyRegion;
+    #endif
+
+        // Only copy the stale parts from the document.  While a shape is
+        // dragged out, these are thin bands along the edges that moved.
+        QPainter painter (&d->overlayBuffer);
+        painter.setCompositionMode (QPainter::CompositionMode_Source);
+
+        for (const QRect &dirtyRect : d->overlayDirtyRegion)
+        {
+            QImage part = doc->getImageAt (dirtyRect);
+
+            if (doc->selection ()) {
+                compositeSelection (&part, dirtyRect);
+            }
+            else {
+                compositeTempImage (&part, dirtyRect);
+            }
+
+            painter.drawImage (dirtyRect.topLeft () - d->overlayBufferRect.topLeft (),
+                               part);
+        }
+
+        painter.end ();
+
+        d->overlayDirtyRegion = QRegion ();
+    }
+
+    if (rect == d->overlayBufferRect) {
+        return d->overlayBuffer;
+    }
+
+    // Refer to the <rect> part of the buffer without copying it.
+    const QPoint offset = rect.topLeft () - d->overlayBufferRect.topLeft ();
+    return QImage (d->overlayBuffer.constScanLine (offset.y ()) +
+                       offset.x () * int (sizeof (QRgb)),
+                   rect.width (), rect.height (),
+                   d->overlayBuffer.bytesPerLine (),
+                   d->overlayBuffer.format ());
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpViewManager::compositeSelection (QImage *destImage, const QRect &docRect) const
+{
+#if DEBUG_KP_VIEW_MANAGER && 1
+    qCDebug(kpLogViews) << "kpViewManager::compositeSelection() docRect=" << docRect;
+#endif
+
+    kpDocument *doc = document ();
+    kpAbstractSelection *sel = doc ? doc->selection () : nullptr;
+    if (!sel)
+    {
+    #if DEBUG_KP_VIEW_MANAGER && 1
+        qCDebug(kpLogViews) << "\tno sel - abort";
+    #endif
+        return;
+    }
+
+
+    //
+    // Draw selection pixmap (if there is one)
+    //
+#if DEBUG_KP_VIEW_MANAGER && 1
+    qCDebug(kpLogViews) << "\tdraw sel pixmap @ " << sel->topLeft ();
+#endif
+    sel->paint (destImage, docRect);
+
+
+    //
+    // Draw selection border
+    //
+
+#if DEBUG_KP_VIEW_MANAGER && 1
+    qCDebug(kpLogViews) << "\tsel border visible="
+               << selectionBorderVisible ();
+#endif
+    if (selectionBorderVisible ())
+    {
+        sel->paintBorder (destImage, docRect, selectionBorderFinished ());
+    }
+
+
+    //
+    // Draw text cursor
+    //
+
+    // TODO: It would be nice to display the text cursor even if it's not
+    //       within the text box (this can happen if the text box is too
+    //       small for the text it contains).
+    //
+    //       However, too much selection repaint code assumes that it
+    //       only paints inside its kpAbstractSelection::boundingRect().
+    auto *textSel = dynamic_cast <kpTextSelection *> (sel);
+    if (textSel &&
+        textCursorEnabled () &&
+        (textCursorBlinkState () ||
+        // For the current main window:
+        //     As long as _any_ view has focus, blink _all_ views not just the
+        //     one with focus.
+        !hasAViewWithFocus ()))  // sync: call will break when vm is not held by 1 mainWindow
+    {
+        QRect rect = textCursorRect ();
+        rect = rect.intersected (textSel->textAreaRect ());
+        if (!rect.isEmpty ())
+        {
+          kpPixmapFX::fillRect(destImage,
+              rect.x () - docRect.x (), rect.y () - docRect.y (),
+              rect.width (), rect.height (),
+              kpColor::LightGray, kpColor::DarkGray);
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpViewManager::compositeTempImage (QImage *destImage, const QRect &docRect) const
+{
+    const kpTempImage *tpi = tempImage ();
+#if DEBUG_KP_VIEW_MANAGER && 1
+    qCDebug(kpLogViews) << "kpViewManager::compositeTempImage() tempImage="
+               << tpi
+               << " isVisible="
+               << (tpi ? tpi->isVisible (this) : false);
+#endif
+
+    if (!tpi || !tpi->isVisible (this)) {
+        return;
+    }
+
+    tpi->paint (destImage, docRect);
+}
+
+//---------------------------------------------------------------------
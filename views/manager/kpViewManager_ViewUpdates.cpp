@@ -33,7 +33,9 @@
 #include "kpViewManagerPrivate.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QList>
+#include <QRegion>
 #include <QTimer>
 
 #include "kpLogCategories.h"
@@ -79,6 +81,13 @@ void kpViewManager::restoreQueueUpdates ()
     {
       foreach (kpView *view, d->views)
         view->updateQueuedArea();
+
+      // A batch of fast updates (e.g. a tool's coalesced mouse moves,
+      // which are already throttled to the frame rate) wants its result
+      // on screen now, not at the next frame.
+      if (fastUpdates ()) {
+          flushUpdates ();
+      }
     }
 }
 
@@ -112,27 +121,187 @@ void kpViewManager::restoreFastUpdates ()
 }
 
 
-// public slot
-void kpViewManager::updateView (kpView *v)
+// public
+int kpViewManager::updateFrameRate () const
 {
-    updateView (v, QRect (0, 0, v->width (), v->height ()));
+    return d->updateFrameRate;
+}
+
+// public
+void kpViewManager::setUpdateFrameRate (int framesPerSecond)
+{
+    d->updateFrameRate = qBound (1, framesPerSecond, 1000);
+}
+
+
+// private
+int kpViewManager::updateIntervalMSec () const
+{
+    const int frameMSec = qMax (1, 1000 / d->updateFrameRate);
+
+    // Repaint budget: spend at most half of the time repainting, leaving
+    // the rest for handling input.  Otherwise, a slow repaint (e.g. huge
+    // view at a high zoom level) would make us fall further and further
+    // behind the mouse.
+    return int (qMin (qMax (qint64 (frameMSec), d->lastUpdateFlushCostMSec * 2),
+                      qint64 (1000)));
+}
+
+// private
+void kpViewManager::scheduleUpdates ()
+{
+    const int intervalMSec = updateIntervalMSec ();
+    const qint64 sinceLastFlush = d->lastUpdateFlush.isValid () ?
+        d->lastUpdateFlush.elapsed () : LLONG_MAX;
+
+    if (sinceLastFlush >= intervalMSec)
+    {
+        if (fastUpdates ())
+        {
+            flushUpdates ();
+            return;
+        }
+
+        if (!d->updateTimer->isActive ()) {
+            d->updateTimer->start (0);
+        }
+    }
+    else
+    {
+        if (!d->updateTimer->isActive ()) {
+            d->updateTimer->start (int (intervalMSec - sinceLastFlush));
+        }
+    }
+}
+
+
+// Returns <region> or, if repainting its bounding rectangle instead
+// does not waste much area, its bounding rectangle.
+//
+// kpView::paintEvent() does a document fetch, composite and scaled blit
+// per rectangle, so repainting many small rectangles separately costs
+// more than repainting a slightly larger area in one go.
+static QRegion CoalescedRegion (const QRegion &region)
+{
+    if (region.rectCount () <= 1) {
+        return region;
+    }
+
+    const QRect boundingRect = region.boundingRect ();
+
+    qint64 area = 0;
+    for (const QRect &r : region) {
+        area += qint64 (r.width ()) * r.height ();
+    }
+
+    const qint64 boundingArea = qint64 (boundingRect.width ()) * boundingRect.height ();
+
+    // Waste at most 50% more area.  With lots of tiny rectangles
+    // (e.g. from the spraycan), the per-rectangle overhead dominates anyway.
+    if (boundingArea * 2 <= area * 3 || region.rectCount () > 32) {
+        return boundingRect;
+    }
+
+    return region;
+}
+
+// private
+QRegion kpViewManager::viewRegionForDocRegion (const kpView *view,
+        const QRegion &docRegion) const
+{
+    QRegion viewRegion;
+
+    const bool integerZoom =
+        (view->zoomLevelX () % 100 == 0 && view->zoomLevelY () % 100 == 0);
+    const int diff = qRound (double (qMax (view->zoomLevelX (), view->zoomLevelY ())) / 100.0) + 1;
+
+    for (const QRect &docRect : docRegion)
+    {
+        const QRect viewRect = view->transformDocToView (docRect);
+
+        if (integerZoom)
+        {
+            viewRegion += viewRect;
+        }
+        else
+        {
+            // Compensate for rounding at non-integer zoom levels.
+            viewRegion += QRect (viewRect.x () - diff,
+                                 viewRect.y () - diff,
+                                 viewRect.width () + 2 * diff,
+                                 viewRect.height () + 2 * diff);
+        }
+    }
+
+    return viewRegion;
 }
 
 // public slot
-void kpViewManager::updateView (kpView *v, const QRect &viewRect)
+void kpViewManager::flushUpdates ()
 {
-    if (!queueUpdates ())
+    d->updateTimer->stop ();
+
+    if (d->pendingDocRegion.isEmpty () && d->pendingViewRegions.isEmpty ()) {
+        return;
+    }
+
+    // Take the pending updates first, as repainting might generate more.
+    const QRegion docRegion = d->pendingDocRegion;
+    const QHash <kpView *, QRegion> viewRegions = d->pendingViewRegions;
+    d->pendingDocRegion = QRegion ();
+    d->pendingViewRegions.clear ();
+
+    // (e.g. a nested event loop got us here)
+    const bool queue = queueUpdates ();
+
+    QElapsedTimer timer;
+    timer.start ();
+
+    foreach (kpView *view, d->views)
     {
-        if (fastUpdates ()) {
-            v->repaint (viewRect);
+        QRegion viewRegion = viewRegions.value (view);
+        if (!docRegion.isEmpty ()) {
+            viewRegion += viewRegionForDocRegion (view, docRegion);
+        }
+
+        viewRegion &= QRect (0, 0, view->width (), view->height ());
+        if (viewRegion.isEmpty ()) {
+            continue;
+        }
+
+    #if DEBUG_KP_VIEW_MANAGER && 0
+        qCDebug(kpLogViews) << "kpViewManager::flushUpdates() view=" << view->objectName ()
+                   << " region=" << viewRegion;
+    #endif
+
+        if (queue) {
+            view->addToQueuedArea (viewRegion);
         }
         else {
-            v->update (viewRect);
+            view->repaint (::CoalescedRegion (viewRegion));
         }
     }
-    else {
-        v->addToQueuedArea (viewRect);
-    }
+
+    d->lastUpdateFlushCostMSec = timer.elapsed ();
+    d->lastUpdateFlush.start ();
+
+#if DEBUG_KP_VIEW_MANAGER && 0
+    qCDebug(kpLogViews) << "kpViewManager::flushUpdates() took "
+               << d->lastUpdateFlushCostMSec << "ms";
+#endif
+}
+
+
+// public slot
+void kpViewManager::updateView (kpView *v)
+{
+    updateView (v, QRect (0, 0, v->width (), v->height ()));
+}
+
+// public slot
+void kpViewManager::updateView (kpView *v, const QRect &viewRect)
+{
+    updateView (v, QRegion (viewRect));
 }
 
 // public slot
@@ -144,14 +313,14 @@ void kpViewManager::updateView (kpView *v, int x, int y, int w, int h)
 // public slot
 void kpViewManager::updateView (kpView *v, const QRegion &viewRegion)
 {
+    if (viewRegion.isEmpty ()) {
+        return;
+    }
+
     if (!queueUpdates ())
     {
-        if (fastUpdates ()) {
-            v->repaint (viewRegion);
-        }
-        else {
-            v->update (viewRegion.boundingRect ());
-        }
+        d->pendingViewRegions [v] += viewRegion;
+        scheduleUpdates ();
     }
     else {
         v->addToQueuedArea (viewRegion);
@@ -199,34 +368,33 @@ void kpViewManager::updateViews (const QRect &docRect)
     qCDebug(kpLogViews) << "kpViewManager::updateViews (" << docRect << ")";
 #endif
 
-    foreach (kpView *view, d->views)
-    {
-    #if DEBUG_KP_VIEW_MANAGER && 0
-        qCDebug(kpLogViews) << "\tupdating view " << view->name ();
-    #endif
-        if (view->zoomLevelX () % 100 == 0 && view->zoomLevelY () % 100 == 0)
-        {
-        #if DEBUG_KP_VIEW_MANAGER && 0
-            qCDebug(kpLogViews) << "\t\tviewRect=" << view->transformDocToView (docRect);
-        #endif
-            updateView (view, view->transformDocToView (docRect));
-        }
-        else
-        {
-            QRect viewRect = view->transformDocToView (docRect);
+    if (docRect.isEmpty ()) {
+        return;
+    }
 
-            int diff = qRound (double (qMax (view->zoomLevelX (), view->zoomLevelY ())) / 100.0) + 1;
+    // The composited overlay and zoomed tiles must be marked stale now,
+    // even though the repaint itself may be deferred.
+    if (docRect.intersects (d->overlayImageRect)) {
+        d->overlayDirtyRegion += docRect & d->overlayImageRect;
+    }
 
-            QRect newRect = QRect (viewRect.x () - diff,
-                                   viewRect.y () - diff,
-                                   viewRect.width () + 2 * diff,
-                                   viewRect.height () + 2 * diff)
-                                .intersected (QRect (0, 0, view->width (), view->height ()));
+    foreach (kpView *view, d->views) {
+        view->invalidateTileCache (docRect);
+    }
 
-        #if DEBUG_KP_VIEW_MANAGER && 0
-            qCDebug(kpLogViews) << "\t\tviewRect (+compensate)=" << newRect;
-        #endif
-            updateView (view, newRect);
+    if (!queueUpdates ())
+    {
+        // Stay in document coordinates until flushUpdates(), which maps
+        // the region to each view using the view's zoom level at the time.
+        d->pendingDocRegion += docRect;
+        scheduleUpdates ();
+    }
+    else
+    {
+        foreach (kpView *view, d->views)
+        {
+            view->addToQueuedArea (viewRegionForDocRegion (view, QRegion (docRect)) &
+                                   QRect (0, 0, view->width (), view->height ()));
         }
     }
 }
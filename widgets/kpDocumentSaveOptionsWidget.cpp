@@ -32,6 +32,7 @@
 
 #include "kpDefs.h"
 #include "document/kpDocument.h"
+#include "document/kpDocumentSaveEstimator.h"
 #include "dialogs/kpDocumentSaveOptionsPreviewDialog.h"
 #include "pixmapfx/kpPixmapFX.h"
 #include "generic/widgets/kpResizeSignallingLabel.h"
@@ -42,9 +43,7 @@
 #include <KSharedConfig>
 #include <KConfigGroup>
 
-#include <QApplication>
 #include <QBoxLayout>
-#include <QBuffer>
 #include <QComboBox>
 #include <QEvent>
 #include <QGridLayout>
@@ -145,6 +144,10 @@ void kpDocumentSaveOptionsWidget::init ()
     connect (m_updatePreviewTimer, &QTimer::timeout,
              this, &kpDocumentSaveOptionsWidget::updatePreview);
 
+    m_saveEstimator = new kpDocumentSaveEstimator (this);
+    connect (m_saveEstimator, &kpDocumentSaveEstimator::estimated,
+             this, &kpDocumentSaveOptionsWidget::setPreview);
+
     m_updatePreviewDialogLastRelativeGeometryTimer = new QTimer (this);
     connect (m_updatePreviewDialogLastRelativeGeometryTimer,
              &QTimer::timeout,
@@ -629,6 +632,10 @@ void kpDocumentSaveOptionsWidget::showPreview (bool yes)
         connect (m_previewDialog, &kpDocumentSaveOptionsPreviewDialog::resized,
                  this, &kpDocumentSaveOptionsWidget::updatePreviewDialogLastRelativeGeometry);
 
+        // The preview is only rendered at the size it is shown at.
+        connect (m_previewDialog, &kpDocumentSaveOptionsPreviewDialog::resized,
+                 this, &kpDocumentSaveOptionsWidget::updatePreviewDelayed);
+
         m_updatePreviewDialogLastRelativeGeometryTimer->start (200/*ms*/);
     }
     else
@@ -651,6 +658,9 @@ void kpDocumentSaveOptionsWidget::showPreview (bool yes)
                    << endl;
     #endif
 
+        m_updatePreviewTimer->stop ();
+        m_saveEstimator->cancel ();
+
         m_previewDialog->deleteLater ();
         m_previewDialog = nullptr;
     }
@@ -683,44 +693,37 @@ void kpDocumentSaveOptionsWidget::updatePreview ()
     m_updatePreviewTimer->stop ();
 
 
-    QApplication::setOverrideCursor (Qt::WaitCursor);
-
-    QByteArray data;
-
-    QBuffer buffer (&data);
-    buffer.open (QIODevice::WriteOnly);
-    bool savedOK = kpDocument::savePixmapToDevice (*m_documentPixmap,
-                                    &buffer,
-                                    documentSaveOptions (),
-                                    m_documentMetaInfo,
-                                    false/*no lossy prompt*/,
-                                    this);
-    buffer.close ();
+    // The image is saved and loaded back in the background, so that big
+    // images don't stall the dialog.  This supersedes any earlier update
+    // still in progress.
+    m_saveEstimator->estimate (*m_documentPixmap,
+                               documentSaveOptions (),
+                               m_documentMetaInfo,
+                               m_previewDialog->previewSize ());
+}
 
+// protected slot
+void kpDocumentSaveOptionsWidget::setPreview (const QImage &preview, qint64 fileSize,
+                                              bool isExact)
+{
+#if DEBUG_KP_DOCUMENT_SAVE_OPTIONS_WIDGET
+    qCDebug(kpLogWidgets) << "kpDocumentSaveOptionsWidget::setPreview()"
+               << " preview.size=" << preview.size ()
+               << " fileSize=" << fileSize
+               << " isExact=" << isExact;
+#endif
 
-    QImage image;
+    if (!m_previewDialog || !m_documentPixmap) {
+        return;
+    }
 
-    // Ignore any failed saves.
+    // <preview> is null if the save failed.
     //
     // Failed saves might literally have written half a file.  The final
     // save (when the user clicks OK), _will_ fail so we shouldn't have a
-    // preview even if this "half a file" is actually loadable by
-    // QImage::loadFormData().
-    if (savedOK)
-    {
-        image.loadFromData(data);
-    }
-    else
-    {
-        // Leave <image> as invalid.
-        // TODO: This code path has not been well tested.
-        //       Will we trigger divide by zero errors in "m_previewDialog"?
-    }
-
-    // REFACTOR: merge with kpDocument::getPixmapFromFile()
-    m_previewDialog->setFilePixmapAndSize (image, data.size ());
-
-    QApplication::restoreOverrideCursor ();
+    // preview even if this "half a file" is actually loadable.
+    m_previewDialog->setFilePixmapAndSize (preview, fileSize,
+                                           m_documentPixmap->size (), isExact);
 }
 
 // protected slot
@@ -45,6 +45,7 @@ class QTimer;
 class QSpinBox;
 class QPushButton;
 
+class kpDocumentSaveEstimator;
 class kpDocumentSaveOptionsPreviewDialog;
 
 
@@ -123,6 +124,7 @@ protected slots:
     void hidePreview ();
     void updatePreviewDelayed ();
     void updatePreview ();
+    void setPreview (const QImage &preview, qint64 fileSize, bool isExact);
     void updatePreviewDialogLastRelativeGeometry ();
 
 
@@ -149,6 +151,7 @@ protected:
     QRect m_previewDialogLastRelativeGeometry;
     QTimer *m_updatePreviewTimer;
     int m_updatePreviewDelay;
+    kpDocumentSaveEstimator *m_saveEstimator;
     QTimer *m_updatePreviewDialogLastRelativeGeometryTimer;
 };
 
@@ -82,29 +82,16 @@ kpToolToolBar::kpToolToolBar(const QString &name, int colsOrRows, QMainWindow *p
       m_baseWidget (nullptr),
       m_baseLayout (nullptr),
       m_toolLayout (nullptr),
+      m_toolWidgetBrush (nullptr),
+      m_toolWidgetEraserSize (nullptr),
+      m_toolWidgetFillStyle (nullptr),
+      m_toolWidgetLineWidth (nullptr),
+      m_toolWidgetOpaqueOrTransparent (nullptr),
+      m_toolWidgetSpraycanSize (nullptr),
       m_previousTool (nullptr), m_currentTool (nullptr)
 {
     m_baseWidget = new QWidget(this);
 
-    m_toolWidgets.append (m_toolWidgetBrush =
-        new kpToolWidgetBrush (m_baseWidget, QStringLiteral("Tool Widget Brush")));
-    m_toolWidgets.append (m_toolWidgetEraserSize =
-        new kpToolWidgetEraserSize (m_baseWidget, QStringLiteral("Tool Widget Eraser Size")));
-    m_toolWidgets.append (m_toolWidgetFillStyle =
-        new kpToolWidgetFillStyle (m_baseWidget, QStringLiteral("Tool Widget Fill Style")));
-    m_toolWidgets.append (m_toolWidgetLineWidth =
-        new kpToolWidgetLineWidth (m_baseWidget, QStringLiteral("Tool Widget Line Width")));
-    m_toolWidgets.append (m_toolWidgetOpaqueOrTransparent =
-        new kpToolWidgetOpaqueOrTransparent (m_baseWidget, QStringLiteral("Tool Widget Opaque/Transparent")));
-    m_toolWidgets.append (m_toolWidgetSpraycanSize =
-        new kpToolWidgetSpraycanSize (m_baseWidget, QStringLiteral("Tool Widget Spraycan Size")));
-
-    for (auto *w : m_toolWidgets)
-    {
-      connect (w, &kpToolWidgetBase::optionSelected,
-               this, &kpToolToolBar::toolWidgetOptionSelected);
-    }
-
     adjustToOrientation(orientation());
     connect (this, &kpToolToolBar::orientationChanged,
              this, &kpToolToolBar::adjustToOrientation);
@@ -113,8 +100,6 @@ kpToolToolBar::kpToolToolBar(const QString &name, int colsOrRows, QMainWindow *p
     connect (m_buttonGroup, &QButtonGroup::idClicked,
              this, &kpToolToolBar::slotToolButtonClicked);
 
-    hideAllToolWidgets ();
-
     addWidget(m_baseWidget);
 
     connect (this, &kpToolToolBar::iconSizeChanged,
@@ -262,6 +247,90 @@ void kpToolToolBar::hideAllToolWidgets ()
 
 //---------------------------------------------------------------------
 
+// public
+kpToolWidgetBrush *kpToolToolBar::toolWidgetBrush ()
+{
+    if (!m_toolWidgetBrush)
+    {
+        addToolWidget (m_toolWidgetBrush =
+            new kpToolWidgetBrush (m_baseWidget, QStringLiteral("Tool Widget Brush")));
+    }
+
+    return m_toolWidgetBrush;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetEraserSize *kpToolToolBar::toolWidgetEraserSize ()
+{
+    if (!m_toolWidgetEraserSize)
+    {
+        addToolWidget (m_toolWidgetEraserSize =
+            new kpToolWidgetEraserSize (m_baseWidget, QStringLiteral("Tool Widget Eraser Size")));
+    }
+
+    return m_toolWidgetEraserSize;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetFillStyle *kpToolToolBar::toolWidgetFillStyle ()
+{
+    if (!m_toolWidgetFillStyle)
+    {
+        addToolWidget (m_toolWidgetFillStyle =
+            new kpToolWidgetFillStyle (m_baseWidget, QStringLiteral("Tool Widget Fill Style")));
+    }
+
+    return m_toolWidgetFillStyle;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetLineWidth *kpToolToolBar::toolWidgetLineWidth ()
+{
+    if (!m_toolWidgetLineWidth)
+    {
+        addToolWidget (m_toolWidgetLineWidth =
+            new kpToolWidgetLineWidth (m_baseWidget, QStringLiteral("Tool Widget Line Width")));
+    }
+
+    return m_toolWidgetLineWidth;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetOpaqueOrTransparent *kpToolToolBar::toolWidgetOpaqueOrTransparent ()
+{
+    if (!m_toolWidgetOpaqueOrTransparent)
+    {
+        addToolWidget (m_toolWidgetOpaqueOrTransparent =
+            new kpToolWidgetOpaqueOrTransparent (m_baseWidget, QStringLiteral("Tool Widget Opaque/Transparent")));
+    }
+
+    return m_toolWidgetOpaqueOrTransparent;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetSpraycanSize *kpToolToolBar::toolWidgetSpraycanSize ()
+{
+    if (!m_toolWidgetSpraycanSize)
+    {
+        addToolWidget (m_toolWidgetSpraycanSize =
+            new kpToolWidgetSpraycanSize (m_baseWidget, QStringLiteral("Tool Widget Spraycan Size")));
+    }
+
+    return m_toolWidgetSpraycanSize;
+}
+
+//---------------------------------------------------------------------
+
 // public
 kpToolWidgetBase *kpToolToolBar::shownToolWidget (int which) const
 {
@@ -444,6 +513,49 @@ void kpToolToolBar::addButton(QAbstractButton *button, Qt::Orientation o, int nu
 
 //---------------------------------------------------------------------
 
+// private
+void kpToolToolBar::addToolWidget (kpToolWidgetBase *w)
+{
+    // Keep the tool widgets in the same order as if they had all been
+    // created up front, so that tools showing 2 of them get the same
+    // layout whichever was created first.
+    const QList<kpToolWidgetBase *> allToolWidgets =
+    {
+        m_toolWidgetBrush,
+        m_toolWidgetEraserSize,
+        m_toolWidgetFillStyle,
+        m_toolWidgetLineWidth,
+        m_toolWidgetOpaqueOrTransparent,
+        m_toolWidgetSpraycanSize
+    };
+
+    int index = 0;
+    for (auto *other : allToolWidgets)
+    {
+        if (other == w) {
+            break;
+        }
+
+        if (other) {
+            index++;
+        }
+    }
+
+    m_toolWidgets.insert (index, w);
+
+    connect (w, &kpToolWidgetBase::optionSelected,
+             this, &kpToolToolBar::toolWidgetOptionSelected);
+
+    w->hide ();
+
+    // (the tool layout is the first item in m_baseLayout)
+    m_baseLayout->insertWidget (1 + index, w,
+        0/*stretch*/,
+        orientation () == Qt::Vertical ? Qt::AlignHCenter : Qt::AlignVCenter);
+}
+
+//---------------------------------------------------------------------
+
 void kpToolToolBar::slotIconSizeChanged(const QSize &size)
 {
     for (auto *b : m_toolButtons) {
@@ -72,12 +72,16 @@ public:
 
     void hideAllToolWidgets ();
     // could this be cleaner (the tools have to access them individually somehow)?
-    kpToolWidgetBrush *toolWidgetBrush () const { return m_toolWidgetBrush; }
-    kpToolWidgetEraserSize *toolWidgetEraserSize () const { return m_toolWidgetEraserSize; }
-    kpToolWidgetFillStyle *toolWidgetFillStyle () const { return m_toolWidgetFillStyle; }
-    kpToolWidgetLineWidth *toolWidgetLineWidth () const { return m_toolWidgetLineWidth; }
-    kpToolWidgetOpaqueOrTransparent *toolWidgetOpaqueOrTransparent () const { return m_toolWidgetOpaqueOrTransparent; }
-    kpToolWidgetSpraycanSize *toolWidgetSpraycanSize () const { return m_toolWidgetSpraycanSize; }
+    //
+    // Each tool widget is only created, hidden, when it is first asked for
+    // (usually when a tool that uses it is first selected), to save
+    // startup time.
+    kpToolWidgetBrush *toolWidgetBrush ();
+    kpToolWidgetEraserSize *toolWidgetEraserSize ();
+    kpToolWidgetFillStyle *toolWidgetFillStyle ();
+    kpToolWidgetLineWidth *toolWidgetLineWidth ();
+    kpToolWidgetOpaqueOrTransparent *toolWidgetOpaqueOrTransparent ();
+    kpToolWidgetSpraycanSize *toolWidgetSpraycanSize ();
 
     kpToolWidgetBase *shownToolWidget (int which) const;
 
@@ -96,6 +100,7 @@ private slots:
 
 private:
     void addButton (QAbstractButton *button, Qt::Orientation o, int num);
+    void addToolWidget (kpToolWidgetBase *w);
     void adjustSizeConstraint();
 
     int m_vertCols;